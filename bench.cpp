@@ -0,0 +1,614 @@
+#include "stdafx.h"
+
+#include "view.h"
+#include "model.h"
+#include "tribe.h"
+#include "message_buffer.h"
+#include "statistics.h"
+#include "options.h"
+#include "benchmark.h"
+#include "field_of_view.h"
+#include "level_maker.h"
+#include "location.h"
+#include "square_factory.h"
+#include "path_service.h"
+#include "creature_view.h"
+#include "map_memory.h"
+#include "level.h"
+
+using namespace std;
+
+/** A View that displays nothing and never asks for input. The player always waits, so the rest of the world
+    is simulated undisturbed.*/
+class NullView : public View {
+  public:
+  virtual void initialize() override {}
+  virtual void displaySplash(bool& ready) override {}
+  virtual void close() override {}
+  virtual void refreshView(const CreatureView* view) override {
+    lastView = view;
+  }
+
+  virtual void updateView(const CreatureView*) override {}
+  virtual void drawLevelMap(const Level*, const CreatureView*) override {}
+  virtual void resetCenter() override {}
+  virtual void addMessage(const string& message) override {}
+  virtual void addImportantMessage(const string& message) override {}
+  virtual void clearMessages() override {}
+
+  virtual Action getAction() override {
+    return Action(ActionId::WAIT);
+  }
+
+  virtual CollectiveAction getClick() override {
+    return CollectiveAction(CollectiveAction::IDLE);
+  }
+
+  virtual bool travelInterrupt() override {
+    return true;
+  }
+
+  virtual Optional<int> chooseFromList(const string& title, const vector<ListElem>& options, int index,
+      Optional<ActionId> exitAction) override {
+    return Nothing();
+  }
+
+  virtual Optional<Vec2> chooseDirection(const string& message) override {
+    return Nothing();
+  }
+
+  virtual bool yesOrNoPrompt(const string& message) override {
+    return false;
+  }
+
+  virtual void presentText(const string& title, const string& text) override {}
+  virtual void presentList(const string& title, const vector<ListElem>& options, bool scrollDown,
+      Optional<ActionId> exitAction) override {}
+
+  virtual Optional<int> getNumber(const string& title, int max) override {
+    return Nothing();
+  }
+
+  virtual void animateObject(vector<Vec2> trajectory, ViewObject object) override {}
+  virtual void animation(Vec2 pos, AnimationId) override {}
+
+  virtual int getTimeMilli() override {
+    return 0;
+  }
+
+  virtual void stopClock() override {}
+  virtual void setTimeMilli(int) override {}
+  virtual void continueClock() override {}
+
+  virtual bool isClockStopped() override {
+    return false;
+  }
+
+  /** The view the game last asked to refresh, if any.*/
+  const CreatureView* getLastView() const {
+    return lastView;
+  }
+
+  private:
+  const CreatureView* lastView = nullptr;
+};
+
+static void usage() {
+  std::cout << "Usage: keeper-bench [keeper|adventurer] [turns] [seed] [log] [fovcache=<MB>] [paththreads=<N>]"
+      << " [pathbudget=<N>] [genthreads=<N>]" << endl;
+  std::cout << "       keeper-bench fov [passes] [seed]" << endl;
+  std::cout << "       keeper-bench path [queries] [seed]" << endl;
+  std::cout << "       keeper-bench gen [worlds] [seed] [genthreads=<N>]" << endl;
+  std::cout << "       keeper-bench view [passes] [seed]" << endl;
+}
+
+struct FovBenchLevel {
+  string name;
+  int width;
+  int height;
+  LevelMaker* maker;
+  bool surface;
+};
+
+/** Measures cold construction of field of view from every square of a few generated levels, and then the
+    invalidation of cached visibilities when walls are dug out.*/
+static void fovBenchmark(View* view, RandomGen& random, int numPasses) {
+  vector<SettlementInfo> settlements {
+    {SettlementType::CASTLE, CreatureFactory::humanVillagePeaceful(), Nothing(), new Location(), Tribe::human,
+      {30, 20}, {}},
+    {SettlementType::VILLAGE, CreatureFactory::elvenVillagePeaceful(), Nothing(), new Location(), Tribe::elven,
+      {30, 20}, {}}};
+  vector<FovBenchLevel> levelInfo {
+    {"Wilderness", 180, 120, LevelMaker::topLevel2(random, CreatureFactory::forrest(), settlements), true},
+    {"Gnomish Mines", 60, 35, LevelMaker::roomLevel(random, CreatureFactory::level(random, 1), {StairKey::DWARF},
+        {StairKey::DWARF}), false},
+    {"Dwarven Halls", 60, 35, LevelMaker::mineTownLevel(random, CreatureFactory::dwarfTown(1), {StairKey::DWARF},
+        {StairKey::DWARF}), false},
+    {"Goblin Den", 60, 35, LevelMaker::goblinTownLevel(random, CreatureFactory::goblinTown(1), {StairKey::DWARF}, {}),
+        false},
+    {"Crypt", 30, 20, LevelMaker::cryptLevel(CreatureFactory::crypt(), {StairKey::CRYPT}, {}), false},
+    {"Cave", 40, 30, LevelMaker::cavernLevel(CreatureFactory::singleType(Tribe::dragon, CreatureId::DRAGON),
+        SquareType::MUD_WALL, SquareType::MUD, StairLook::NORMAL, {StairKey::DRAGON}, {}), false}};
+  Model model(view);
+  vector<PLevel> levels;
+  for (FovBenchLevel& info : levelInfo) {
+    Level::Builder builder(info.width, info.height, info.name, random.split());
+    info.maker->make(&builder, Rectangle(info.width, info.height));
+    levels.push_back(builder.build(&model, info.surface));
+  }
+  // Nothing is cached, so every query computes a new visibility. The outermost squares are walls that no
+  // creature can stand on, so they are skipped.
+  FieldOfView::setCacheLimit(0);
+  long long totalMicros = 0;
+  long long totalFovMicros = 0;
+  int totalNum = 0;
+  for (int i : All(levels)) {
+    long long start = Benchmark::getMicros();
+    long long fovStart = Benchmark::getTime(BenchPhase::FIELD_OF_VIEW);
+    int num = 0;
+    for (int j : Range(numPasses))
+      for (Vec2 v : Rectangle(1, 1, levels[i]->getWidth() - 1, levels[i]->getHeight() - 1)) {
+        levels[i]->canSee(v, v);
+        ++num;
+      }
+    long long micros = Benchmark::getMicros() - start;
+    long long fovMicros = Benchmark::getTime(BenchPhase::FIELD_OF_VIEW) - fovStart;
+    std::cout << levelInfo[i].name << ": " << num << " visibilities, " << double(fovMicros) / num
+        << " us each, " << double(micros) / num << " us per query" << endl;
+    totalMicros += micros;
+    totalFovMicros += fovMicros;
+    totalNum += num;
+  }
+  std::cout << "total: " << totalNum << " visibilities, " << double(totalFovMicros) / totalNum
+      << " us each, " << double(totalMicros) / totalNum << " us per query" << endl;
+  // Now everything is cached, as in a level crowded with creatures.
+  FieldOfView::setCacheLimit(1LL << 40);
+  const int numDigs = 200;
+  for (int i : All(levels)) {
+    Rectangle interior(1, 1, levels[i]->getWidth() - 1, levels[i]->getHeight() - 1);
+    vector<Vec2> walls;
+    for (Vec2 v : interior) {
+      levels[i]->canSee(v, v);
+      if (!levels[i]->getSquare(v)->canSeeThru())
+        walls.push_back(v);
+    }
+    walls = random.permutation(walls);
+    walls.resize(min<int>(walls.size(), numDigs));
+    long long invalidations = Benchmark::get(BenchCounter::FOV_CACHE_INVALIDATIONS);
+    long long start = Benchmark::getMicros();
+    for (Vec2 v : walls)
+      levels[i]->replaceSquare(v, PSquare(SquareFactory::get(random, SquareType::FLOOR)));
+    long long micros = Benchmark::getMicros() - start;
+    std::cout << levelInfo[i].name << ": " << walls.size() << " walls dug, " << double(micros) / walls.size()
+        << " us each, " << Benchmark::get(BenchCounter::FOV_CACHE_INVALIDATIONS) - invalidations
+        << " visibilities dropped" << endl;
+  }
+}
+
+/** Measures long path queries between random squares of the wilderness, planned on the cluster graph, against
+    a search over the whole level, with square lookups or bitmaps. The first pass also builds the clusters that
+    it reaches. Then measures groups of creatures heading to one target, each with its own path or all sharing a
+    flow field, the same groups with a budget of path searching per turn, creatures chasing a moving target, the nearest of several goals, and queries to targets that
+    have been walled up.*/
+static void pathBenchmark(View* view, RandomGen& random, int numQueries) {
+  vector<SettlementInfo> settlements {
+    {SettlementType::CASTLE, CreatureFactory::humanVillagePeaceful(), Nothing(), new Location(), Tribe::human,
+      {30, 20}, {}},
+    {SettlementType::VILLAGE, CreatureFactory::elvenVillagePeaceful(), Nothing(), new Location(), Tribe::elven,
+      {30, 20}, {}}};
+  Model model(view);
+  Level::Builder builder(180, 120, "Wilderness", random.split());
+  LevelMaker::topLevel2(random, CreatureFactory::forrest(), settlements)->make(&builder, Rectangle(180, 120));
+  PLevel level = builder.build(&model, true);
+  PCreature goblin = CreatureFactory::fromId(random, CreatureId::GOBLIN, Tribe::monster);
+  MovementType movement = goblin->getMovementType();
+  vector<Vec2> squares;
+  for (Vec2 v : level->getBounds())
+    if (level->getSquare(v)->canEnterEmpty(movement))
+      squares.push_back(v);
+  Vec2 start = squares[0];
+  Creature* creature = goblin.get();
+  level->addCreature(start, std::move(goblin));
+  vector<pair<Vec2, Vec2>> queries;
+  while (queries.size() < numQueries) {
+    Vec2 from = random.choose(squares);
+    Vec2 to = random.choose(squares);
+    if (from.dist8(to) > 40)
+      queries.push_back({from, to});
+  }
+  auto entryFun = [&](Vec2 pos) {
+      const Square* square = level->getSquare(pos);
+      if (square->canEnterEmpty(movement) && (!square->getCreature() || pos == start))
+        return 1.0;
+      if (square->canEnterEmpty(movement) || square->canDestroy())
+        return 5.0;
+      return ShortestPath::infinity;};
+  const BitTable& passable = level->getPassableSquares(movement);
+  const BitTable& destructible = level->getDestructibleSquares();
+  const BitTable& occupied = level->getOccupiedSquares();
+  auto bitmapEntryFun = [&](Vec2 pos) {
+      if (passable[pos] && (!occupied[pos] || pos == start))
+        return 1.0;
+      if (passable[pos] || destructible[pos])
+        return 5.0;
+      return ShortestPath::infinity;};
+  for (string pass : {"cold", "warm", "flat", "flat bitmaps"}) {
+    int numReachable = 0;
+    long long longest = 0;
+    long long start = Benchmark::getMicros();
+    for (auto& query : queries) {
+      long long queryStart = Benchmark::getMicros();
+      if (pass == "flat" || pass == "flat bitmaps") {
+        // The same heuristic as the level search without the cluster graph.
+        ShortestPath path(level->getBounds(), pass == "flat" ? function<double(Vec2)>(entryFun)
+            : function<double(Vec2)>(bitmapEntryFun),
+            [](Vec2 v) { return int(2 * v.lengthD()); }, Vec2::directions8(), query.second, query.first);
+        numReachable += path.isReachable(query.first);
+      } else {
+        ShortestPath path(level.get(), creature, query.second, query.first);
+        numReachable += path.isReachable(query.first);
+      }
+      longest = max(longest, Benchmark::getMicros() - queryStart);
+    }
+    long long micros = Benchmark::getMicros() - start;
+    std::cout << pass << ": " << queries.size() << " queries, " << numReachable << " reachable, "
+        << double(micros) / queries.size() << " us each, longest " << longest << " us" << endl;
+  }
+  // A group starts around the first square of a query, like a village setting out on a raid.
+  const int groupSize = 20;
+  const int numGroups = 20;
+  vector<vector<Vec2>> groups;
+  for (int i : Range(numGroups)) {
+    Vec2 center = queries[i].first;
+    vector<Vec2> group;
+    for (Vec2 v : squares)
+      if (v.dist8(center) <= 3 && group.size() < groupSize)
+        group.push_back(v);
+    groups.push_back(group);
+  }
+  for (string pass : {"paths", "flow field"}) {
+    int numReachable = 0;
+    long long start = Benchmark::getMicros();
+    for (int i : All(groups)) {
+      Vec2 target = queries[i].second;
+      for (Vec2 v : groups[i])
+        if (pass == "paths") {
+          ShortestPath path(level.get(), creature, target, v);
+          numReachable += path.isReachable(v);
+        } else
+          numReachable += !level->getFlowField(movement, target, i)->getMoves(v).empty();
+    }
+    long long micros = Benchmark::getMicros() - start;
+    std::cout << "groups, " << pass << ": " << numReachable << " reachable, " << double(micros) / numGroups
+        << " us per group" << endl;
+  }
+  // All the groups set out in the same turn, each creature with its own search. With a budget the searches are
+  // spread over several turns.
+  for (int budget : {-1, 20000, 5000}) {
+    int oldBudget = ShortestPath::getTurnBudget();
+    ShortestPath::setTurnBudget(budget);
+    vector<pair<Vec2, Vec2>> raid;
+    for (int i : All(groups))
+      for (Vec2 v : groups[i])
+        raid.push_back({v, queries[i].second});
+    vector<Optional<ShortestPath>> paths(raid.size());
+    long long expansions = Benchmark::get(BenchCounter::PATH_EXPANSIONS);
+    long long longestTurn = 0;
+    int numTurns = 0;
+    int numReachable = 0;
+    bool waiting = true;
+    long long start = Benchmark::getMicros();
+    while (waiting) {
+      waiting = false;
+      ShortestPath::startTurn();
+      long long turnStart = Benchmark::getMicros();
+      for (int i : All(raid)) {
+        if (!paths[i])
+          paths[i] = ShortestPath(level.get(), creature, raid[i].second, raid[i].first, 0, false, true);
+        else if (paths[i]->isSuspended())
+          paths[i]->resume(level.get(), creature, raid[i].first);
+        else
+          continue;
+        if (paths[i]->isSuspended())
+          waiting = true;
+        else
+          numReachable += paths[i]->isReachable(raid[i].first);
+      }
+      longestTurn = max(longestTurn, Benchmark::getMicros() - turnStart);
+      ++numTurns;
+    }
+    long long micros = Benchmark::getMicros() - start;
+    ShortestPath::setTurnBudget(oldBudget);
+    std::cout << "raid, budget " << budget << ": " << numReachable << " reachable in " << numTurns << " turns, "
+        << Benchmark::get(BenchCounter::PATH_EXPANSIONS) - expansions << " expansions, " << micros / 1000
+        << " ms total, longest turn " << longestTurn / 1000 << " ms" << endl;
+  }
+  // A creature follows a wandering target, and searches again or repairs its path when the target drifts.
+  const int chaseSteps = 100;
+  vector<vector<Vec2>> walks;
+  for (int i : Range(numGroups)) {
+    vector<Vec2> walk {queries[i].second};
+    for (int j : Range(chaseSteps)) {
+      Vec2 next = walk.back() + random.choose(Vec2::directions8());
+      walk.push_back(next.inRectangle(level->getBounds()) && passable[next] ? next : walk.back());
+    }
+    walks.push_back(walk);
+  }
+  for (string pass : {"searches", "repairs"}) {
+    int numSearches = 0;
+    int numRepairs = 0;
+    long long start = Benchmark::getMicros();
+    for (int i : Range(numGroups)) {
+      Vec2 pos = queries[i].first;
+      Optional<ShortestPath> path;
+      for (Vec2 target : walks[i]) {
+        if (pos == target)
+          break;
+        bool current = path && path->isReachable(pos);
+        if (!current || path->getTarget().dist8(target) > pos.dist8(target) / 10) {
+          if (current && pass == "repairs" && path->repairTarget(level.get(), creature, pos, target))
+            ++numRepairs;
+          else {
+            path = ShortestPath(level.get(), creature, target, pos);
+            ++numSearches;
+          }
+        }
+        if (!path->isReachable(pos))
+          break;
+        pos = path->getNextMove(pos);
+      }
+    }
+    long long micros = Benchmark::getMicros() - start;
+    std::cout << "chase, " << pass << ": " << numSearches << " searches, " << numRepairs << " repairs, "
+        << double(micros) / numGroups << " us per chase" << endl;
+  }
+  // Looks for the nearest of several goals, like an imp choosing a task, with a search to each goal or a single
+  // search to all of them.
+  const int numGoals = 30;
+  vector<Vec2> goals;
+  for (int i : Range(numGoals))
+    goals.push_back(random.choose(squares));
+  for (string pass : {"each goal", "all goals"}) {
+    int numFound = 0;
+    long long start = Benchmark::getMicros();
+    for (int i : Range(numGroups)) {
+      Vec2 from = queries[i].first;
+      if (pass == "each goal") {
+        int best = 1000000;
+        for (Vec2 goal : goals) {
+          ShortestPath path(level.get(), creature, goal, from);
+          if (path.isReachable(from)) {
+            int length = 0;
+            for (Vec2 v = from; v != goal; v = path.getNextMove(v))
+              ++length;
+            best = min(best, length);
+          }
+        }
+        numFound += best < 1000000;
+      } else
+        numFound += !ShortestPath::getNearest(level.get(), movement, from, goals).empty();
+    }
+    long long micros = Benchmark::getMicros() - start;
+    std::cout << "nearest, " << pass << ": " << numFound << " found, " << double(micros) / numGroups
+        << " us each" << endl;
+  }
+  // Walls up the starting squares, so searches from the targets go through everything else.
+  long long sealStart = Benchmark::getMicros();
+  for (int i : Range(numGroups))
+    for (Vec2 dir : Vec2::directions8())
+      if ((queries[i].first + dir).inRectangle(level->getBounds()))
+        level->replaceSquare(queries[i].first + dir, PSquare(SquareFactory::get(random, SquareType::ROCK_WALL)));
+  std::cout << "sealing: " << double(Benchmark::getMicros() - sealStart) / (8 * numGroups) << " us per square"
+      << endl;
+  for (string pass : {"flat", "regions"}) {
+    int numReachable = 0;
+    long long start = Benchmark::getMicros();
+    for (int i : Range(numGroups))
+      if (pass == "flat") {
+        ShortestPath path(level->getBounds(), bitmapEntryFun, [](Vec2 v) { return int(2 * v.lengthD()); },
+            Vec2::directions8(), queries[i].second, queries[i].first);
+        numReachable += path.isReachable(queries[i].first);
+      } else {
+        ShortestPath path(level.get(), creature, queries[i].second, queries[i].first);
+        numReachable += path.isReachable(queries[i].first);
+      }
+    long long micros = Benchmark::getMicros() - start;
+    std::cout << "sealed, " << pass << ": " << numReachable << " reachable, " << double(micros) / numGroups
+        << " us each" << endl;
+  }
+}
+
+/** Generates a number of adventurer worlds from consecutive seeds, and reports how many of them and of their
+    level attempts succeeded, and a histogram of the generation times.*/
+static void genBenchmark(View* view, int numWorlds, int seed) {
+  int numFailed = 0;
+  vector<double> times;
+  double total = 0;
+  for (int i : Range(numWorlds)) {
+    RandomGen::setGameSeed(seed + i);
+    RandomGen random = RandomGen::getStream(RandomStream::GAME);
+    Tribe::init();
+    Item::identifyEverything();
+    EventListener::initialize();
+    Statistics::init();
+    NameGenerator::init(random, "first_names.txt", "aztec_names.txt", "creatures.txt",
+        "artifacts.txt", "world.txt", "town_names.txt", "dwarfs.txt", "gods.txt", "demons.txt", "dogs.txt");
+    ItemFactory::init(random);
+    long long start = Benchmark::getMicros();
+    try {
+      delete Model::heroModel(view, random.split());
+    } catch (string ex) {
+      std::cout << "seed " << seed + i << " failed: " << ex << endl;
+      ++numFailed;
+    }
+    times.push_back(double(Benchmark::getMicros() - start) / 1000000);
+    total += times.back();
+  }
+  std::cout << "worlds: " << numWorlds << ", failed " << numFailed << ", success rate "
+      << 100.0 * (numWorlds - numFailed) / numWorlds << "%" << endl;
+  long long attempts = Benchmark::get(BenchCounter::GENERATION_ATTEMPTS);
+  long long cancelled = Benchmark::get(BenchCounter::GENERATION_CANCELLATIONS);
+  long long failed = Benchmark::get(BenchCounter::GENERATION_FAILURES);
+  if (attempts > cancelled)
+    std::cout << "level attempts: " << attempts << ", cancelled " << cancelled << ", failed " << failed
+        << ", success rate " << 100.0 * (attempts - cancelled - failed) / (attempts - cancelled) << "%" << endl;
+  // One bucket per second, from the fastest world to the slowest.
+  int first = int(*min_element(times.begin(), times.end()));
+  int last = int(*max_element(times.begin(), times.end()));
+  vector<int> buckets(last - first + 1);
+  for (double t : times)
+    ++buckets[int(t) - first];
+  std::cout << "generation time histogram:" << endl;
+  for (int i : All(buckets))
+    std::cout << first + i << "-" << first + i + 1 << " s: " << buckets[i] << " " << string(buckets[i], '#')
+        << endl;
+  std::cout << "mean: " << total / numWorlds << " s" << endl;
+}
+
+/** Plays a keeper game for a while and then measures what the map view does with the whole level: making the
+    view index of every square, copying them all, and remembering every square.*/
+static void viewBenchmark(NullView* view, RandomGen& random, int numPasses) {
+  unique_ptr<Model> model(Model::collectiveModel(view, random.split()));
+  for (int turn : Range(100))
+    model->update(turn);
+  const CreatureView* creatureView = view->getLastView();
+  CHECK(creatureView) << "Nothing was shown";
+  const Level* level = creatureView->getLevel();
+  Rectangle bounds = level->getBounds();
+  Table<ViewIndex> indexes(bounds);
+  int numObjects = 0;
+  long long start = Benchmark::getMicros();
+  for (int i : Range(numPasses))
+    for (Vec2 v : bounds) {
+      indexes[v] = creatureView->getViewIndex(v);
+      for (ViewLayer layer : allLayers)
+        numObjects += indexes[v].hasObject(layer);
+    }
+  long long makeMicros = Benchmark::getMicros() - start;
+  Table<ViewIndex> copy(bounds);
+  start = Benchmark::getMicros();
+  for (int i : Range(numPasses))
+    for (Vec2 v : bounds)
+      copy[v] = indexes[v];
+  long long copyMicros = Benchmark::getMicros() - start;
+  // The memories are kept, so that the peak memory use of the process tells their size.
+  vector<MapMemory> memories(numPasses);
+  start = Benchmark::getMicros();
+  for (MapMemory& memory : memories)
+    for (Vec2 v : bounds)
+      memory.addObject(v, level->getSquare(v)->getViewObject());
+  long long memoryMicros = Benchmark::getMicros() - start;
+  double numSquares = double(numPasses) * bounds.getW() * bounds.getH();
+  std::cout << level->getName() << " " << bounds.getW() << "x" << bounds.getH() << ", "
+      << numObjects / numSquares << " objects per square" << endl;
+  std::cout << "sizeof(ViewObject) " << sizeof(ViewObject) << ", sizeof(ViewIndex) " << sizeof(ViewIndex) << endl;
+  std::cout << "make: " << makeMicros * 1000 / numSquares << " ns per square" << endl;
+  std::cout << "copy: " << copyMicros * 1000 / numSquares << " ns per square" << endl;
+  std::cout << "remember: " << memoryMicros * 1000 / numSquares << " ns per square" << endl;
+}
+
+int main(int argc, char* argv[]) {
+  bool keeper = false;
+  bool fov = false;
+  bool path = false;
+  bool gen = false;
+  bool viewMode = false;
+  int numTurns = 1000;
+  int seed = 123;
+  if (argc > 1) {
+    string mode = argv[1];
+    if (mode == "keeper")
+      keeper = true;
+    else if (mode == "fov") {
+      fov = true;
+      numTurns = 10;
+    } else if (mode == "path") {
+      path = true;
+    } else if (mode == "gen") {
+      gen = true;
+      numTurns = 5;
+    } else if (mode == "view") {
+      viewMode = true;
+      numTurns = 20;
+    } else if (mode != "adventurer") {
+      usage();
+      return 1;
+    }
+  }
+  if (argc > 2)
+    numTurns = convertFromString<int>(argv[2]);
+  if (argc > 3)
+    seed = convertFromString<int>(argv[3]);
+  for (int i = 4; i < argc; ++i) {
+    string option = argv[i];
+    // Debug output goes to log.out and is flushed on every line, so it's off unless requested.
+    if (option == "log")
+      Debug::init();
+    else if (option.substr(0, 9) == "fovcache=")
+      FieldOfView::setCacheLimit((long long) convertFromString<int>(option.substr(9)) * 1024 * 1024);
+    else if (option.substr(0, 12) == "paththreads=")
+      PathService::init(convertFromString<int>(option.substr(12)));
+    // Squares that creatures' path searches may expand per turn, negative for no limit.
+    else if (option.substr(0, 11) == "pathbudget=")
+      ShortestPath::setTurnBudget(convertFromString<int>(option.substr(11)));
+    else if (option.substr(0, 11) == "genthreads=")
+      Model::setGenerationThreads(convertFromString<int>(option.substr(11)));
+    else {
+      usage();
+      return 1;
+    }
+  }
+  NullView* view = new NullView();
+  RandomGen::setGameSeed(seed);
+  RandomGen random = RandomGen::getStream(RandomStream::GAME);
+  Tribe::init();
+  Item::identifyEverything();
+  EventListener::initialize();
+  Statistics::init();
+  Benchmark::init();
+  Options::init("options.txt");
+  NameGenerator::init(random, "first_names.txt", "aztec_names.txt", "creatures.txt",
+      "artifacts.txt", "world.txt", "town_names.txt", "dwarfs.txt", "gods.txt", "demons.txt", "dogs.txt");
+  ItemFactory::init(random);
+  messageBuffer.initialize(view);
+  view->initialize();
+  if (fov) {
+    fovBenchmark(view, random, numTurns);
+    return 0;
+  }
+  if (path) {
+    pathBenchmark(view, random, numTurns);
+    return 0;
+  }
+  if (gen) {
+    genBenchmark(view, numTurns, seed);
+    return 0;
+  }
+  if (viewMode) {
+    viewBenchmark(view, random, numTurns);
+    return 0;
+  }
+  unique_ptr<Model> model;
+  BENCHMARK(
+      model.reset(keeper ? Model::collectiveModel(view, random.split()) : Model::heroModel(view, random.split())),
+      BenchPhase::GENERATION);
+  std::cout << "world hash: " << model->getWorldHash() << endl;
+  long long start = Benchmark::getMicros();
+  int turn = 0;
+  try {
+    for (; turn < numTurns; ++turn)
+      model->update(turn);
+  } catch (GameOverException ex) {
+    std::cout << "Game over after " << turn << " turns" << endl;
+  }
+  double seconds = double(Benchmark::getMicros() - start) / 1000000;
+  std::cout << (keeper ? "keeper" : "adventurer") << " mode, seed " << seed << endl;
+  for (string line : Benchmark::getText())
+    std::cout << line << endl;
+  std::cout << "simulation time: " << seconds << " s" << endl;
+  if (seconds > 0) {
+    std::cout << "turns/sec: " << Benchmark::get(BenchCounter::TURNS) / seconds << endl;
+    std::cout << "creature moves/sec: " << Benchmark::get(BenchCounter::CREATURE_MOVES) / seconds << endl;
+  }
+  return 0;
+}
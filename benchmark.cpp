@@ -0,0 +1,66 @@
+#include "stdafx.h"
+#include "benchmark.h"
+
+unordered_map<BenchCounter, long long> Benchmark::count;
+unordered_map<BenchPhase, long long> Benchmark::time;
+
+void Benchmark::init() {
+  count.clear();
+  time.clear();
+}
+
+void Benchmark::add(BenchCounter id, int num) {
+  count[id] += num;
+}
+
+long long Benchmark::get(BenchCounter id) {
+  return count[id];
+}
+
+void Benchmark::addTime(BenchPhase id, long long micros) {
+  time[id] += micros;
+}
+
+long long Benchmark::getTime(BenchPhase id) {
+  return time[id];
+}
+
+long long Benchmark::getMicros() {
+  timeval t;
+  gettimeofday(&t, nullptr);
+  return t.tv_usec + (long long) t.tv_sec * 1000000;
+}
+
+static vector<pair<BenchPhase, string>> phaseText {
+  {BenchPhase::GENERATION, "world generation"},
+  {BenchPhase::TICKING, "ticking"},
+  {BenchPhase::CREATURE_MOVE, "creature moves"},
+  {BenchPhase::COLLECTIVE, "collective"},
+  {BenchPhase::FIELD_OF_VIEW, "field of view"},
+  {BenchPhase::PATH_QUERIES, "path queries"},
+};
+
+static vector<pair<BenchCounter, string>> counterText {
+  {BenchCounter::TURNS, "turns"},
+  {BenchCounter::CREATURE_MOVES, "creature moves"},
+  {BenchCounter::FOV_CACHE_HITS, "visibility cache hits"},
+  {BenchCounter::FOV_CACHE_MISSES, "visibility cache misses"},
+  {BenchCounter::FOV_CACHE_EVICTIONS, "visibility cache evictions"},
+  {BenchCounter::FOV_CACHE_INVALIDATIONS, "visibility cache invalidations"},
+  {BenchCounter::PATH_SEARCHES, "path searches"},
+  {BenchCounter::PATH_REPAIRS, "path repairs"},
+  {BenchCounter::PATH_EXPANSIONS, "budgeted path expansions"},
+  {BenchCounter::PATH_DEFERRALS, "moves waiting for a path"},
+  {BenchCounter::GENERATION_ATTEMPTS, "level generation attempts"},
+  {BenchCounter::GENERATION_FAILURES, "failed level generation attempts"},
+  {BenchCounter::GENERATION_CANCELLATIONS, "cancelled level generation attempts"},
+};
+
+vector<string> Benchmark::getText() {
+  vector<string> ret;
+  for (auto elem : counterText)
+    ret.push_back(elem.second + ": " + convertToString(count[elem.first]));
+  for (auto elem : phaseText)
+    ret.push_back(elem.second + " time: " + convertToString(double(time[elem.first]) / 1000) + " ms");
+  return ret;
+}
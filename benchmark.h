@@ -0,0 +1,57 @@
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include "util.h"
+#include "enums.h"
+
+enum class BenchPhase {
+  GENERATION,
+  TICKING,
+  CREATURE_MOVE,
+  COLLECTIVE,
+  FIELD_OF_VIEW,
+  PATH_QUERIES,
+};
+
+ENUM_HASH(BenchPhase);
+
+enum class BenchCounter {
+  TURNS,
+  CREATURE_MOVES,
+  FOV_CACHE_HITS,
+  FOV_CACHE_MISSES,
+  FOV_CACHE_EVICTIONS,
+  FOV_CACHE_INVALIDATIONS,
+  PATH_SEARCHES,
+  PATH_REPAIRS,
+  PATH_EXPANSIONS,
+  PATH_DEFERRALS,
+  GENERATION_ATTEMPTS,
+  GENERATION_FAILURES,
+  GENERATION_CANCELLATIONS,
+};
+
+ENUM_HASH(BenchCounter);
+
+/** Collects wall time per simulation phase and event counters. Used by the keeper-bench driver.*/
+class Benchmark {
+  public:
+  static void init();
+  static void add(BenchCounter, int num = 1);
+  static long long get(BenchCounter);
+  static void addTime(BenchPhase, long long micros);
+  static long long getTime(BenchPhase);
+  static long long getMicros();
+  static vector<string> getText();
+
+  private:
+  static unordered_map<BenchCounter, long long> count;
+  static unordered_map<BenchPhase, long long> time;
+};
+
+#define BENCHMARK(exp, phase) do { \
+  long long benchStart = Benchmark::getMicros(); \
+  exp; \
+  Benchmark::addTime(phase, Benchmark::getMicros() - benchStart);} while(0)
+
+#endif
@@ -0,0 +1,217 @@
+#include "stdafx.h"
+
+#include "cluster_graph.h"
+#include "shortest_path.h"
+
+using namespace std;
+
+static const vector<Vec2> directions = Vec2::directions8();
+
+// A straight run of entrances longer than this gets one at each end instead of one in the middle.
+const int maxEntranceRun = 5;
+
+ClusterGraph::ClusterGraph(Rectangle b, function<double(Vec2)> fun) : bounds(b), entryFun(fun),
+    clusters((b.getW() + clusterSize - 1) / clusterSize, (b.getH() + clusterSize - 1) / clusterSize) {
+}
+
+Vec2 ClusterGraph::getClusterPos(Vec2 pos) const {
+  return Vec2((pos.x - bounds.getPX()) / clusterSize, (pos.y - bounds.getPY()) / clusterSize);
+}
+
+Rectangle ClusterGraph::getClusterArea(Rectangle bounds, Vec2 clusterPos) {
+  Vec2 topLeft = bounds.getTopLeft() + clusterPos * clusterSize;
+  return Rectangle(topLeft.x, topLeft.y, min(bounds.getKX(), topLeft.x + clusterSize),
+      min(bounds.getKY(), topLeft.y + clusterSize));
+}
+
+Rectangle ClusterGraph::getCluster(Rectangle bounds, Vec2 pos) {
+  return getClusterArea(bounds, Vec2((pos.x - bounds.getPX()) / clusterSize, (pos.y - bounds.getPY()) / clusterSize));
+}
+
+double ClusterGraph::getCost(Vec2 pos) {
+  return entryFun(pos);
+}
+
+bool ClusterGraph::isPassable(Vec2 pos) {
+  return entryFun(pos) < ShortestPath::infinity;
+}
+
+void ClusterGraph::squareChanged(Vec2 pos) {
+  clusters[getClusterPos(pos)].valid = false;
+  // Entrances depend on the squares on both sides of a border, and on the squares next to a corner.
+  for (Vec2 dir : directions)
+    if ((pos + dir).inRectangle(bounds))
+      clusters[getClusterPos(pos + dir)].valid = false;
+}
+
+void ClusterGraph::addNode(Cluster& cluster, Vec2 pos, Vec2 exit) {
+  for (int i = 0; i < cluster.nodes.size(); ++i)
+    if (cluster.nodes[i] == pos) {
+      cluster.exits[i].push_back(exit);
+      return;
+    }
+  cluster.nodes.push_back(pos);
+  cluster.exits.push_back({exit});
+}
+
+/** Adds the entrances to the neighbouring cluster in the given direction. Both clusters choose the same
+    entrances, because the choice is symmetric. There's an entrance wherever a creature can cross the border,
+    so the graph finds a path if there is one.*/
+void ClusterGraph::addEntrances(Cluster& cluster, Rectangle area, Vec2 dir) {
+  if (dir.x != 0 && dir.y != 0) {
+    Vec2 corner(dir.x > 0 ? area.getKX() - 1 : area.getPX(), dir.y > 0 ? area.getKY() - 1 : area.getPY());
+    Vec2 exit = corner + dir;
+    // The corner only needs its own entrance if the squares next to it can't be crossed.
+    if (exit.inRectangle(bounds) && isPassable(corner) && isPassable(exit)
+        && !isPassable(corner + Vec2(dir.x, 0)) && !isPassable(corner + Vec2(0, dir.y)))
+      addNode(cluster, corner, exit);
+    return;
+  }
+  Vec2 start(dir.x > 0 ? area.getKX() - 1 : area.getPX(), dir.y > 0 ? area.getKY() - 1 : area.getPY());
+  if (!(start + dir).inRectangle(bounds))
+    return;
+  Vec2 along(dir.y != 0 ? 1 : 0, dir.x != 0 ? 1 : 0);
+  int length = dir.x != 0 ? area.getH() : area.getW();
+  vector<bool> mine(length), theirs(length), straight(length);
+  for (int i = 0; i < length; ++i) {
+    mine[i] = isPassable(start + along * i);
+    theirs[i] = isPassable(start + along * i + dir);
+    straight[i] = mine[i] && theirs[i];
+  }
+  for (int i = 0; i < length; ++i)
+    if (straight[i] && (i == 0 || !straight[i - 1])) {
+      int end = i;
+      while (end + 1 < length && straight[end + 1])
+        ++end;
+      if (end - i + 1 > maxEntranceRun) {
+        addNode(cluster, start + along * i, start + along * i + dir);
+        addNode(cluster, start + along * end, start + along * end + dir);
+      } else {
+        int middle = (i + end) / 2;
+        addNode(cluster, start + along * middle, start + along * middle + dir);
+      }
+    }
+  // Diagonal crossings are only needed where neither square has a straight crossing.
+  for (int i = 0; i + 1 < length; ++i)
+    if (!straight[i] && !straight[i + 1]) {
+      if (mine[i] && theirs[i + 1])
+        addNode(cluster, start + along * i, start + along * (i + 1) + dir);
+      if (mine[i + 1] && theirs[i])
+        addNode(cluster, start + along * (i + 1), start + along * i + dir);
+    }
+}
+
+ClusterGraph::Cluster& ClusterGraph::updateCluster(Vec2 clusterPos) {
+  Cluster& cluster = clusters[clusterPos];
+  if (cluster.valid)
+    return cluster;
+  Rectangle area = getClusterArea(bounds, clusterPos);
+  cluster.nodes.clear();
+  cluster.exits.clear();
+  for (Vec2 dir : directions)
+    addEntrances(cluster, area, dir);
+  int numNodes = cluster.nodes.size();
+  cluster.distance.resize(numNodes * numNodes);
+  for (int i = 0; i < numNodes; ++i) {
+    Table<double> distance = getDistances(area, cluster.nodes[i], Nothing(), false);
+    for (int j = 0; j < numNodes; ++j)
+      cluster.distance[i * numNodes + j] = distance[cluster.nodes[j]];
+  }
+  cluster.valid = true;
+  return cluster;
+}
+
+/** Returns the distances from the source to the squares of the area, or the distances to the source if
+    reversed. The goal can be entered even if it's blocked.*/
+Table<double> ClusterGraph::getDistances(Rectangle area, Vec2 source, Optional<Vec2> goal, bool reversed) {
+  Table<double> distance(area, ShortestPath::infinity);
+  priority_queue<pair<double, Vec2>, vector<pair<double, Vec2>>, greater<pair<double, Vec2>>> q;
+  distance[source] = 0;
+  q.push({0, source});
+  while (!q.empty()) {
+    pair<double, Vec2> elem = q.top();
+    q.pop();
+    Vec2 pos = elem.second;
+    if (elem.first > distance[pos])
+      continue;
+    ++numExpanded;
+    double reversedCost = !reversed ? 0 : pos == source ? 1 : getCost(pos);
+    for (Vec2 dir : directions) {
+      Vec2 next = pos + dir;
+      if (!next.inRectangle(area))
+        continue;
+      double cost;
+      if (reversed)
+        cost = isPassable(next) ? reversedCost : ShortestPath::infinity;
+      else
+        cost = goal == next ? 1 : getCost(next);
+      if (cost < ShortestPath::infinity && distance[pos] + cost < distance[next]) {
+        distance[next] = distance[pos] + cost;
+        q.push({distance[next], next});
+      }
+    }
+  }
+  return distance;
+}
+
+long long ClusterGraph::getNumExpanded() const {
+  return numExpanded;
+}
+
+Optional<vector<Vec2>> ClusterGraph::getWaypoints(Vec2 from, Vec2 to) {
+  CHECK(from.inRectangle(bounds) && to.inRectangle(bounds));
+  if (from == to)
+    return vector<Vec2>({from});
+  Vec2 startCluster = getClusterPos(from);
+  Vec2 goalCluster = getClusterPos(to);
+  Table<double> startDistance = getDistances(getClusterArea(bounds, startCluster), from, to, false);
+  Table<double> goalDistance = getDistances(getClusterArea(bounds, goalCluster), to, Nothing(), true);
+  unordered_map<Vec2, double> distance {{from, 0}};
+  unordered_map<Vec2, Vec2> previous;
+  priority_queue<pair<double, Vec2>, vector<pair<double, Vec2>>, greater<pair<double, Vec2>>> q;
+  q.push({from.dist8(to), from});
+  while (!q.empty()) {
+    pair<double, Vec2> elem = q.top();
+    q.pop();
+    Vec2 pos = elem.second;
+    double dist = distance.at(pos);
+    if (elem.first > dist + pos.dist8(to))
+      continue;
+    ++numExpanded;
+    if (pos == to) {
+      vector<Vec2> ret {to};
+      while (ret.back() != from)
+        ret.push_back(previous.at(ret.back()));
+      return vector<Vec2>(ret.rbegin(), ret.rend());
+    }
+    auto relax = [&](Vec2 next, double cost) {
+      if (cost >= ShortestPath::infinity)
+        return;
+      auto it = distance.find(next);
+      if (it == distance.end() || dist + cost < it->second) {
+        distance[next] = dist + cost;
+        previous[next] = pos;
+        q.push({dist + cost + next.dist8(to), next});
+      }
+    };
+    Vec2 clusterPos = getClusterPos(pos);
+    Cluster& cluster = updateCluster(clusterPos);
+    if (pos == from) {
+      for (Vec2 node : cluster.nodes)
+        relax(node, startDistance[node]);
+      if (clusterPos == goalCluster)
+        relax(to, startDistance[to]);
+    }
+    int numNodes = cluster.nodes.size();
+    for (int i = 0; i < numNodes; ++i)
+      if (cluster.nodes[i] == pos) {
+        for (int j = 0; j < numNodes; ++j)
+          relax(cluster.nodes[j], cluster.distance[i * numNodes + j]);
+        for (Vec2 exit : cluster.exits[i])
+          relax(exit, getCost(exit));
+        if (clusterPos == goalCluster)
+          relax(to, goalDistance[pos]);
+      }
+  }
+  return Nothing();
+}
@@ -0,0 +1,55 @@
+#ifndef _CLUSTER_GRAPH_H
+#define _CLUSTER_GRAPH_H
+
+#include "util.h"
+
+/** Abstract graph for hierarchical pathfinding. The area is split into square clusters. The graph connects
+    entrances on the borders of neighbouring clusters, with the shortest distances between the entrances of
+    each cluster. A cluster is computed when a search first reaches it and recomputed after one of its squares
+    changes.*/
+class ClusterGraph {
+  public:
+  /** The entry function returns the cost of entering a square, or ShortestPath::infinity if it's blocked.*/
+  ClusterGraph(Rectangle bounds, function<double(Vec2)> entryFun);
+
+  /** Returns a path from one square to another, as a list of squares that starts with from and ends with to.
+      Each square is either next to the previous one or in the same cluster. Returns Nothing if there is no
+      path at all.*/
+  Optional<vector<Vec2>> getWaypoints(Vec2 from, Vec2 to);
+
+  /** Returns the number of squares and nodes that the searches of the graph have expanded so far.*/
+  long long getNumExpanded() const;
+
+  void squareChanged(Vec2 pos);
+
+  /** Returns the cluster that contains the square, in a graph of the given area.*/
+  static Rectangle getCluster(Rectangle bounds, Vec2 pos);
+
+  static const int clusterSize = 16;
+
+  private:
+  struct Cluster {
+    bool valid = false;
+    vector<Vec2> nodes;
+    // Squares in neighbouring clusters that each node leads to.
+    vector<vector<Vec2>> exits;
+    // Distance from node i to node j inside the cluster is at i * nodes.size() + j.
+    vector<double> distance;
+  };
+
+  Vec2 getClusterPos(Vec2 pos) const;
+  static Rectangle getClusterArea(Rectangle bounds, Vec2 clusterPos);
+  Cluster& updateCluster(Vec2 clusterPos);
+  void addEntrances(Cluster&, Rectangle area, Vec2 dir);
+  void addNode(Cluster&, Vec2 pos, Vec2 exit);
+  Table<double> getDistances(Rectangle area, Vec2 source, Optional<Vec2> goal, bool reversed);
+  double getCost(Vec2 pos);
+  bool isPassable(Vec2 pos);
+
+  Rectangle bounds;
+  function<double(Vec2)> entryFun;
+  Table<Cluster> clusters;
+  long long numExpanded = 0;
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include "collective.h"
 #include "level.h"
 #include "task.h"
+#include "shortest_path.h"
 #include "player.h"
 #include "message_buffer.h"
 #include "model.h"
@@ -94,7 +95,7 @@ map<MinionTask, MinionTaskInfo> taskInfo {
     {MinionTask::STUDY, {SquareType::LIBRARY, "studying", Collective::Warning::LIBRARY}},
 };
 
-Collective::Collective(Model* m) : mana(200), model(m) {
+Collective::Collective(Model* m, RandomGen r) : mana(200), model(m), random(r) {
   EventListener::addListener(this);
   // init the map so the values can be safely read with .at()
   mySquares[SquareType::TREE_TRUNK].clear();
@@ -173,7 +174,9 @@ vector<pair<Item*, Vec2>> Collective::getTrapItems(TrapType type, set<Vec2> squa
 }
 
 ViewObject Collective::getResourceViewObject(ResourceId id) const {
-  return ItemFactory::fromId(resourceInfo.at(id).itemId)->getViewObject();
+  // Only the look of the item is needed, so it can't change the course of the game.
+  RandomGen viewRandom = RandomGen::getStream(RandomStream::VIEW);
+  return ItemFactory::fromId(viewRandom, resourceInfo.at(id).itemId)->getViewObject();
 }
 
 static string getTechName(TechId id) {
@@ -222,14 +225,14 @@ void Collective::handleMarket(View* view, int prevItem) {
   vector<View::ListElem> options;
   vector<PItem> items;
   for (ItemId id : marketItems) {
-    items.push_back(ItemFactory::fromId(id));
+    items.push_back(ItemFactory::fromId(random, id));
     options.emplace_back(items.back()->getName() + "    $" + convertToString(items.back()->getPrice()),
         items.back()->getPrice() > numGold(ResourceId::GOLD) ? View::INACTIVE : View::NORMAL);
   }
   auto index = view->chooseFromList("Buy items", options, prevItem);
   if (!index)
     return;
-  Vec2 dest = chooseRandom(mySquares[SquareType::STOCKPILE]);
+  Vec2 dest = random.choose(mySquares[SquareType::STOCKPILE]);
   takeGold({ResourceId::GOLD, items[*index]->getPrice()});
   level->getSquare(dest)->dropItem(std::move(items[*index]));
   view->updateView(this);
@@ -314,7 +317,7 @@ void Collective::handleNecromancy(View* view, int prevItem, bool firstTime) {
   }
   vector<pair<PCreature, int>> creatures;
   for (SpawnInfo info : raisingInfo) {
-    creatures.push_back({CreatureFactory::fromId(info.id, Tribe::player, MonsterAIFactory::collective(this)),
+    creatures.push_back({CreatureFactory::fromId(random, info.id, Tribe::player, MonsterAIFactory::collective(this)),
         info.manaCost});
     options.emplace_back(creatures.back().first->getName() + "  mana: " + convertToString(info.manaCost) +
           "  level: " + getTechLevelName(info.minLevel),
@@ -325,10 +328,10 @@ void Collective::handleNecromancy(View* view, int prevItem, bool firstTime) {
   if (!index)
     return;
   // TODO: try many corpses before failing
-  auto elem = chooseRandom(corpses);
+  auto elem = random.choose(corpses);
   PCreature& creature = creatures[*index].first;
   mana -= creatures[*index].second;
-  for (Vec2 v : elem.first.neighbors8(true))
+  for (Vec2 v : elem.first.neighbors8(random))
     if (level->getSquare(v)->canEnter(creature.get())) {
       level->getSquare(elem.first)->removeItems({elem.second});
       addCreature(creature.get(), MinionType::UNDEAD);
@@ -405,7 +408,7 @@ void Collective::handleSpawning(View* view, TechId techId, SquareType spawnSquar
 
     vector<pair<PCreature, int>> creatures;
     for (SpawnInfo info : spawnInfo) {
-      creatures.push_back({CreatureFactory::fromId(info.id, Tribe::player, MonsterAIFactory::collective(this)),
+      creatures.push_back({CreatureFactory::fromId(random, info.id, Tribe::player, MonsterAIFactory::collective(this)),
           info.manaCost});
       options.emplace_back(creatures.back().first->getName() + "  mana: " + convertToString(info.manaCost) + 
             "   level: " + getTechLevelName(info.minLevel),
@@ -414,10 +417,10 @@ void Collective::handleSpawning(View* view, TechId techId, SquareType spawnSquar
     auto index = view->chooseFromList(title + " level: " + getTechLevelName(techLevel), options, prevItem);
     if (!index)
       return;
-    Vec2 pos = chooseRandom(cages);
+    Vec2 pos = random.choose(cages);
     PCreature& creature = creatures[*index].first;
     mana -= creatures[*index].second;
-    for (Vec2 v : pos.neighbors8(true))
+    for (Vec2 v : pos.neighbors8(random))
       if (level->getSquare(v)->canEnter(creature.get())) {
         addCreature(creature.get(), minionType);
         level->addCreature(v, std::move(creature));
@@ -484,7 +487,7 @@ void Collective::refreshGameInfo(View::GameInfo& gameInfo) const {
             if (elem.cost > 0)
               cost = {getResourceViewObject(elem.resourceId), elem.cost};
             info.buttons.push_back({
-                SquareFactory::get(elem.type)->getViewObject(),
+                SquareFactory::getViewObject(elem.type),
                 elem.name,
                 cost,
                 (elem.cost > 0 ? "[" + convertToString(mySquares.at(elem.type).size()) + "]" : ""),
@@ -611,6 +614,10 @@ ViewIndex Collective::getViewIndex(Vec2 pos) const {
   return index;
 }
 
+Optional<vector<Vec2>> Collective::getOverlaySquares() const {
+  return concat<Vec2>({getKeys(marked), getKeys(traps), getKeys(guardPosts), getKeys(doors)});
+}
+
 bool Collective::staticPosition() const {
   return false;
 }
@@ -706,7 +713,7 @@ void Collective::takeGold(CostInfo cost) {
       credit[cost.id] = 0;
     }
   }
-  for (Vec2 pos : randomPermutation(mySquares[resourceInfo.at(cost.id).storageType])) {
+  for (Vec2 pos : random.permutation(mySquares[resourceInfo.at(cost.id).storageType])) {
     vector<Item*> goldHere = level->getSquare(pos)->getItems(resourceInfo.at(cost.id).predicate);
     for (Item* it : goldHere) {
       level->getSquare(pos)->removeItem(it);
@@ -724,8 +731,8 @@ void Collective::returnGold(CostInfo amount) {
   if (mySquares[resourceInfo.at(amount.id).storageType].empty()) {
     credit[amount.id] += amount.value;
   } else
-    level->getSquare(chooseRandom(mySquares[resourceInfo.at(amount.id).storageType]))->
-        dropItems(ItemFactory::fromId(resourceInfo.at(amount.id).itemId, amount.value));
+    level->getSquare(random.choose(mySquares[resourceInfo.at(amount.id).storageType]))->
+        dropItems(ItemFactory::fromId(random, resourceInfo.at(amount.id).itemId, amount.value));
 }
 
 int Collective::getImpCost() const {
@@ -835,9 +842,9 @@ void Collective::processInput(View* view) {
           case BuildInfo::IMP:
               if (mana >= getImpCost() && selection == NONE) {
                 selection = SELECT;
-                PCreature imp = CreatureFactory::fromId(CreatureId::IMP, Tribe::player,
+                PCreature imp = CreatureFactory::fromId(random, CreatureId::IMP, Tribe::player,
                     MonsterAIFactory::collective(this));
-                for (Vec2 v : pos.neighbors8(true))
+                for (Vec2 v : pos.neighbors8(random))
                   if (v.inRectangle(level->getBounds()) && level->getSquare(v)->canEnter(imp.get()) 
                       && canSee(v)) {
                     mana -= getImpCost();
@@ -973,13 +980,13 @@ void Collective::onAppliedSquare(Vec2 pos) {
     mana += 1 + max(0., 1 - double(getDangerLevel()) / 1000);
   }
   if (mySquares.at(SquareType::LABORATORY).count(pos))
-    if (Random.roll(30)) {
-      level->getSquare(pos)->dropItems(ItemFactory::potions().random());
+    if (random.roll(30)) {
+      level->getSquare(pos)->dropItems(ItemFactory::potions().random(random));
       Statistics::add(StatId::POTION_PRODUCED);
     }
   if (mySquares.at(SquareType::WORKSHOP).count(pos))
-    if (Random.roll(40)) {
-      vector<PItem> items  = ItemFactory::workshop().random();
+    if (random.roll(40)) {
+      vector<PItem> items  = ItemFactory::workshop().random(random);
       if (items[0]->getType() == ItemType::WEAPON)
         Statistics::add(StatId::WEAPON_PRODUCED);
       if (items[0]->getType() == ItemType::ARMOR)
@@ -1016,10 +1023,17 @@ void Collective::addToMemory(Vec2 pos, const Creature* c) {
   }
   else {
     ViewIndex index = level->getSquare(pos)->getViewIndex(c);
-    memory[level].clearSquare(pos);
+    // Built in full first, so that squares that look the same as remembered don't count as changed.
+    ViewIndex remembered;
     for (ViewLayer l : { ViewLayer::ITEM, ViewLayer::FLOOR_BACKGROUND, ViewLayer::FLOOR, ViewLayer::LARGE_ITEM})
       if (index.hasObject(l))
-        memory[level].addObject(pos, index.getObject(l));
+        remembered.insert(index.getObject(l));
+    if (remembered.isEmpty())
+      memory[level].clearSquare(pos);
+    else {
+      remembered.setHighlight(HighlightType::MEMORY);
+      memory[level].update(pos, remembered);
+    }
   }
 }
 
@@ -1155,10 +1169,19 @@ void Collective::tick() {
     delayDangerousTasks(enemyPos, heart->getTime() + 50);
 }
 
-static Vec2 chooseRandomClose(Vec2 start, const set<Vec2>& squares) {
+/** Chooses one of the squares close to start, so that items get spread over them. The distance is measured by
+    walking if a movement type is given.*/
+static Vec2 chooseRandomClose(RandomGen& random, const Level* level, Optional<MovementType> movement, Vec2 start,
+    const set<Vec2>& squares) {
   int minD = 10000;
   int margin = 5;
   int a;
+  if (movement) {
+    vector<Vec2> close = ShortestPath::getNearest(level, *movement, start, vector<Vec2>(squares.begin(),
+          squares.end()), margin);
+    if (!close.empty())
+      return random.choose(close);
+  }
   vector<Vec2> close;
   for (Vec2 v : squares)
     if ((a = v.dist8(start)) < minD)
@@ -1167,7 +1190,7 @@ static Vec2 chooseRandomClose(Vec2 start, const set<Vec2>& squares) {
     if (v.dist8(start) < minD + margin)
       close.push_back(v);
   CHECK(!close.empty());
-  return chooseRandom(close);
+  return random.choose(close);
 }
 
 void Collective::fetchItems(Vec2 pos, ItemFetchInfo elem) {
@@ -1181,7 +1204,10 @@ void Collective::fetchItems(Vec2 pos, ItemFetchInfo elem) {
       warning[int(elem.warning)] = false;
       if (elem.oneAtATime)
         equipment = {equipment[0]};
-      Vec2 target = chooseRandomClose(pos, mySquares[elem.destination]);
+      Optional<MovementType> movement;
+      if (!imps.empty())
+        movement = imps[0]->getMovementType();
+      Vec2 target = chooseRandomClose(random, level, movement, pos, mySquares[elem.destination]);
       addTask(Task::bringItem(this, pos, equipment, target));
       markedItems.insert(equipment.begin(), equipment.end());
     }
@@ -1225,10 +1251,10 @@ void Collective::onChangeLevelEvent(const Creature* c, const Level* from, Vec2 p
 }
 
 MoveInfo Collective::getBeastMove(Creature* c) {
-  if (!Random.roll(5))
+  if (!random.roll(5))
     return NoMove;
   Vec2 radius(7, 7);
-  for (Vec2 v : randomPermutation(Rectangle(c->getPosition() - radius, c->getPosition() + radius).getAllSquares()))
+  for (Vec2 v : random.permutation(Rectangle(c->getPosition() - radius, c->getPosition() + radius).getAllSquares()))
     if (v.inRectangle(level->getBounds()) && !memory[level].hasViewIndex(v)) {
       if (auto move = c->getMoveTowards(v))
         return {1.0, [c, move]() { return c->move(*move); }};
@@ -1252,7 +1278,7 @@ MoveInfo Collective::getMinionMove(Creature* c) {
     } else 
       v = possessed->getPosition();
     if (v) {
-      if (auto move = c->getMoveTowards(*v))
+      if (auto move = c->getSharedMoveTowards(*v))
         return {1.0, [=] {
           c->move(*move);
         }};
@@ -1282,7 +1308,7 @@ MoveInfo Collective::getMinionMove(Creature* c) {
         minionTasks.at(c).getState());
     if (elem.second.attender == c) {
       if (isTraining) {
-        minionTasks.at(c).update();
+        minionTasks.at(c).update(random);
         minionTaskStrings[c] = "guarding";
         if (c->getPosition().dist8(elem.first) > 1) {
           if (auto move = c->getMoveTowards(elem.first))
@@ -1322,18 +1348,18 @@ MoveInfo Collective::getMinionMove(Creature* c) {
           addTask(Task::pickItem(this, v, {it}), c);
         return taskMap.at(c)->getMove(c);
       }
-  minionTasks.at(c).update();
+  minionTasks.at(c).update(random);
   if (c->getHealth() < 1 && c->canSleep())
     minionTasks.at(c).setState(MinionTask::SLEEP);
   if (c == heart && !myTiles.empty() && !myTiles.count(c->getPosition())) {
-    if (auto move = c->getMoveTowards(chooseRandom(myTiles)))
+    if (auto move = c->getMoveTowards(random.choose(myTiles)))
       return {1.0, [=] {
         c->move(*move);
       }};
   }
   MinionTaskInfo info = taskInfo.at(minionTasks.at(c).getState());
   if (mySquares[info.square].empty()) {
-    minionTasks.at(c).updateToNext();
+    minionTasks.at(c).updateToNext(random);
     warning[int(info.warning)] = true;
     return NoMove;
   }
@@ -1368,21 +1394,34 @@ MoveInfo Collective::getMove(Creature* c) {
     } else
       return task->getMove(c);
   }
-  Task* closest = nullptr;
+  vector<Task*> candidates;
   for (PTask& task : tasks) {
     if (isDelayed(task.get(), c->getTime()))
       continue;
     double dist = (task->getPosition() - c->getPosition()).length8();
     if ((!taken.count(task.get()) || (task->canTransfer() 
                                 && (task->getPosition() - taken.at(task.get())->getPosition()).length8() > dist))
-           && (!closest ||
-           dist < (closest->getPosition() - c->getPosition()).length8()) && !locked.count(make_pair(c, task.get()))) {
-      bool valid = task->getMove(c).isValid();
-      if (valid)
-        closest = task.get();
-      else
-        locked.insert(make_pair(c, task.get()));
-    }
+           && !locked.count(make_pair(c, task.get())))
+      candidates.push_back(task.get());
+  }
+  // The nearest task by walking distance is found in a single search. Tasks that turn out to be invalid are
+  // locked and the search is repeated without them. Tasks that the imp can't get to are locked too.
+  Task* closest = nullptr;
+  while (!closest && !candidates.empty()) {
+    vector<Vec2> positions;
+    for (Task* task : candidates)
+      positions.push_back(task->getPosition());
+    vector<Vec2> nearest = ShortestPath::getNearest(level, c->getMovementType(), c->getPosition(), positions);
+    vector<Task*> remaining;
+    for (Task* task : candidates)
+      if (nearest.empty() || (!closest && task->getPosition() == nearest[0])) {
+        if (!nearest.empty() && task->getMove(c).isValid())
+          closest = task;
+        else
+          locked.insert(make_pair(c, task));
+      } else
+        remaining.push_back(task);
+    candidates = remaining;
   }
   if (closest) {
     if (taken.count(closest)) {
@@ -1397,7 +1436,7 @@ MoveInfo Collective::getMove(Creature* c) {
       Vec2 heartPos = heart->getPosition();
       if (heartPos.dist8(c->getPosition()) < 3)
         return NoMove;
-      if (auto move = c->getMoveTowards(heartPos))
+      if (auto move = c->getSharedMoveTowards(heartPos))
         return {1.0, [=] {
           c->move(*move);
         }};
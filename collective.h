@@ -23,7 +23,7 @@ class Model;
 
 class Collective : public CreatureView, public EventListener {
   public:
-  Collective(Model*);
+  Collective(Model*, RandomGen);
   virtual const MapMemory& getMemory(const Level* l) const override;
   virtual ViewIndex getViewIndex(Vec2 pos) const override;
   virtual void refreshGameInfo(View::GameInfo&) const  override;
@@ -31,6 +31,7 @@ class Collective : public CreatureView, public EventListener {
   virtual bool canSee(const Creature*) const  override;
   virtual bool canSee(Vec2 position) const  override;
   virtual vector<const Creature*> getUnknownAttacker() const override;
+  virtual Optional<vector<Vec2>> getOverlaySquares() const override;
 
   virtual bool staticPosition() const override;
 
@@ -252,6 +253,7 @@ class Collective : public CreatureView, public EventListener {
   double mana;
   int points = 0;
   Model* model;
+  RandomGen random;
   vector<const Creature*> kills;
   bool showWelcomeMsg = true;
   bool showDigMsg = true;
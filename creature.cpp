@@ -7,11 +7,14 @@
 #include "ranged_weapon.h"
 #include "statistics.h"
 #include "options.h"
+#include "path_service.h"
+#include "benchmark.h"
 
 using namespace std;
 
 Creature* Creature::getDefault() {
-  static PCreature defaultCreature = CreatureFactory::fromId(CreatureId::GNOME, Tribe::monster,
+  static RandomGen random = RandomGen::getStream(RandomStream::PROTOTYPE, 1);
+  static PCreature defaultCreature = CreatureFactory::fromId(random, CreatureId::GNOME, Tribe::monster,
       MonsterAIFactory::idle());
   return defaultCreature.get();
 }
@@ -22,9 +25,30 @@ void Creature::noExperienceLevels() {
   increaseExperience = false;
 }
 
-Creature::Creature(ViewObject o, Tribe* t, const CreatureAttributes& attr, ControllerFactory f) : CreatureAttributes(attr), viewObject(o), time(0), tribe(t), dead(false), lastTick(0), controller(f.get(this)) {
-  static int cnt = 1;
-  uniqueId = ++cnt;
+static int idCounter = 1;
+static thread_local vector<Creature*>* deferredCreatures = nullptr;
+
+Creature::Creature(ViewObject o, Tribe* t, const CreatureAttributes& attr, ControllerFactory f) : CreatureAttributes(attr), viewObject(o), time(0), tribe(t), dead(false), lastTick(0), controller(f.get(this)),
+    movementType(computeMovementType()) {
+  if (deferredCreatures)
+    deferredCreatures->push_back(this);
+  else
+    registerCreature();
+}
+
+Creature::~Creature() {
+  if (deferredCreatures)
+    if (Optional<int> index = findElement(*deferredCreatures, this))
+      deferredCreatures->erase(deferredCreatures->begin() + *index);
+}
+
+void Creature::deferRegistration(vector<Creature*>* creatures) {
+  deferredCreatures = creatures;
+}
+
+void Creature::registerCreature() {
+  uniqueId = ++idCounter;
+  random = RandomGen::getStream(RandomStream::CREATURE, uniqueId);
   tribe->addMember(this);
   for (Skill* skill : skills)
     skill->onTeach(this);
@@ -202,7 +226,7 @@ void Creature::swapPosition(Vec2 direction) {
 void Creature::makeMove() {
   CHECK(!isDead());
   if (holding && holding->isDead())
-    holding = nullptr;
+    setHeld(nullptr);
   if (sleeping) {
     controller->sleeping();
     spendTime(1);
@@ -221,7 +245,7 @@ void Creature::makeMove() {
   if (!hidden)
     viewObject.setHidden(false);
   unknownAttacker.clear();
-  if (fireCreature && Random.roll(5))
+  if (fireCreature && getRandom().roll(5))
     getSquare()->setOnFire(1);
   if (!getSquare()->isCovered())
     shineLight();
@@ -251,9 +275,15 @@ void Creature::wait() {
 }
 
 int Creature::getUniqueId() const {
+  CHECK(uniqueId > 0) << "The creature's id is only known once it is registered";
   return uniqueId;
 }
 
+RandomGen& Creature::getRandom() const {
+  CHECK(uniqueId > 0) << "The creature's random stream is only known once it is registered";
+  return random;
+}
+
 const Equipment& Creature::getEquipment() const {
   return equipment;
 }
@@ -317,6 +347,7 @@ vector<const Creature*> Creature::getVisibleCreatures() const {
 
 void Creature::addSkill(Skill* skill) {
   skills.insert(skill);
+  updateMovementType();
   skill->onTeach(this);
   privateMessage(skill->getHelpText());
 }
@@ -561,6 +592,7 @@ void Creature::blind(double time) {
     you(MsgType::ARE, "blind!");
   viewObject.setBlind(true);
   blinded.set(getTime() + time);
+  updateMovementType();
 }
 
 bool Creature::isBlind() const {
@@ -825,6 +857,7 @@ void Creature::tick(double realTime) {
   if (blinded.isFinished(realTime)) {
     you("can see again");
     viewObject.setBlind(false);
+    updateMovementType();
   }
   if (invisible.isFinished(realTime)) {
     you(MsgType::TURN_VISIBLE, "");
@@ -862,12 +895,12 @@ BodyPart Creature::armOrWing() const {
     return BodyPart::WING;
   if (wings == 0)
     return BodyPart::ARM;
-  return chooseRandom({ BodyPart::WING, BodyPart::ARM }, {1, 1});
+  return getRandom().choose({ BodyPart::WING, BodyPart::ARM }, {1, 1});
 }
 
 BodyPart Creature::getBodyPart(AttackLevel attack) const {
   if (flyer)
-    return chooseRandom({BodyPart::TORSO, BodyPart::HEAD, BodyPart::LEG, BodyPart::WING, BodyPart::ARM}, {1, 1, 1, 2, 1});
+    return getRandom().choose({BodyPart::TORSO, BodyPart::HEAD, BodyPart::LEG, BodyPart::WING, BodyPart::ARM}, {1, 1, 1, 2, 1});
   switch (attack) {
     case AttackLevel::HIGH: 
        return BodyPart::HEAD;
@@ -875,12 +908,12 @@ BodyPart Creature::getBodyPart(AttackLevel attack) const {
        if (size == CreatureSize::SMALL || size == CreatureSize::MEDIUM || collapsed)
          return BodyPart::HEAD;
        else
-         return chooseRandom({BodyPart::TORSO, armOrWing()}, {1, 1});
+         return getRandom().choose({BodyPart::TORSO, armOrWing()}, {1, 1});
     case AttackLevel::LOW:
        if (size == CreatureSize::SMALL || collapsed)
-         return chooseRandom({BodyPart::TORSO, armOrWing(), BodyPart::HEAD, BodyPart::LEG}, {1, 1, 1, 1});
+         return getRandom().choose({BodyPart::TORSO, armOrWing(), BodyPart::HEAD, BodyPart::LEG}, {1, 1, 1, 1});
        if (size == CreatureSize::MEDIUM)
-         return chooseRandom({BodyPart::TORSO, armOrWing(), BodyPart::LEG}, {1, 1, 3});
+         return getRandom().choose({BodyPart::TORSO, armOrWing(), BodyPart::LEG}, {1, 1, 3});
        else
          return BodyPart::LEG;
   }
@@ -955,6 +988,7 @@ void Creature::injureWing(bool drop) {
   if (flyer) {
     you(MsgType::FALL, getSquare()->getName());
     flyer = false;
+    updateMovementType();
   }
   if ((legs < 2 || injuredLegs > 0) && !collapsed) {
     collapsed = true;
@@ -999,8 +1033,8 @@ void Creature::attack(const Creature* c1, bool spend) {
       << "Bad attack direction " << c->getPosition() - getPosition();
   CHECK(canAttack(c));
   Debug() << getTheName() << " attacking " << c->getName();
-  auto rToHit = [=] () { return Random.getRandom(GET_ID(uniqueId), -toHitVariance, toHitVariance); };
-  auto rDamage = [=] () { return Random.getRandom(GET_ID(uniqueId), -damageVariance, damageVariance); };
+  auto rToHit = [=] () { return getRandom().getRandom(GET_ID(getUniqueId()), -toHitVariance, toHitVariance); };
+  auto rDamage = [=] () { return getRandom().getRandom(GET_ID(getUniqueId()), -damageVariance, damageVariance); };
   int toHit = rToHit() + rToHit() + getAttr(AttrType::TO_HIT);
   int damage = rDamage() + rDamage() + getAttr(AttrType::DAMAGE);
   bool backstab = false;
@@ -1279,6 +1313,7 @@ void Creature::heal(double amount, bool replaceLimbs) {
         wings += lostWings;
         lostWings = 0;
         flyer = true;
+        updateMovementType();
       }
      if (injuredLegs > 0) {
         you(MsgType::YOUR, string(injuredLegs > 1 ? "legs are" : "leg is") + " in better shape");
@@ -1326,7 +1361,7 @@ void Creature::poisonWithGas(double amount) {
 
 void Creature::shineLight() {
   if (undead) {
-    if (Random.roll(10)) {
+    if (getRandom().roll(10)) {
       you(MsgType::YOUR, "body crumbles to dust");
       die(nullptr);
     } else
@@ -1336,6 +1371,7 @@ void Creature::shineLight() {
 
 void Creature::setHeld(const Creature* c) {
   holding = c;
+  updateMovementType();
 }
 
 bool Creature::isHeld() const {
@@ -1491,9 +1527,9 @@ AttackLevel Creature::getRandomAttackLevel() const {
     return AttackLevel::LOW;
   switch (*size) {
     case CreatureSize::SMALL: return AttackLevel::LOW;
-    case CreatureSize::MEDIUM: return chooseRandom({AttackLevel::LOW, AttackLevel::MIDDLE}, {1,1});
-    case CreatureSize::LARGE: return chooseRandom({AttackLevel::LOW, AttackLevel::MIDDLE, AttackLevel::HIGH},{1,2,2});
-    case CreatureSize::HUGE: return chooseRandom({AttackLevel::MIDDLE, AttackLevel::HIGH}, {1,3});
+    case CreatureSize::MEDIUM: return getRandom().choose({AttackLevel::LOW, AttackLevel::MIDDLE}, {1,1});
+    case CreatureSize::LARGE: return getRandom().choose({AttackLevel::LOW, AttackLevel::MIDDLE, AttackLevel::HIGH},{1,2,2});
+    case CreatureSize::HUGE: return getRandom().choose({AttackLevel::MIDDLE, AttackLevel::HIGH}, {1,3});
   }
   return AttackLevel::LOW;
 }
@@ -1553,9 +1589,9 @@ void Creature::throwItem(Item* item, Vec2 direction) {
     dist = 2 * str / 15;
   else 
     FAIL << "Item too heavy.";
-  int toHit = Random.getRandom(GET_ID(uniqueId), -toHitVariance, toHitVariance) +
+  int toHit = getRandom().getRandom(GET_ID(getUniqueId()), -toHitVariance, toHitVariance) +
       getAttr(AttrType::THROWN_TO_HIT) + item->getModifier(AttrType::THROWN_TO_HIT);
-  int damage = Random.getRandom(GET_ID(uniqueId), -attackVariance, attackVariance) +
+  int damage = getRandom().getRandom(GET_ID(getUniqueId()), -attackVariance, attackVariance) +
       getAttr(AttrType::THROWN_DAMAGE) + item->getModifier(AttrType::THROWN_DAMAGE);
   if (hasSkill(Skill::knifeThrowing) && item->getAttackType() == AttackType::STAB) {
     damage += 7;
@@ -1648,6 +1684,18 @@ bool Creature::canFly() const {
   return flyer;
 }
 
+const MovementType& Creature::getMovementType() const {
+  return movementType;
+}
+
+MovementType Creature::computeMovementType() const {
+  return MovementType(walker, flyer, canSwim(), *size, isBlind() || isHeld(), tribe == Tribe::player, farmAnimal);
+}
+
+void Creature::updateMovementType() {
+  movementType = computeMovementType();
+}
+
 bool Creature::canWalk() const {
   return walker;
 }
@@ -1716,31 +1764,83 @@ Optional<Vec2> Creature::getMoveTowards(Vec2 pos, bool avoidEnemies) {
   return getMoveTowards(pos, false, avoidEnemies);
 }
 
+Optional<Vec2> Creature::getSharedMoveTowards(Vec2 pos) {
+  if (pos == getPosition())
+    return Nothing();
+  if (!getLevel()->canReach(getMovementType(), getPosition(), pos)) {
+    Debug() << "Cannot reach " << pos;
+    return Nothing();
+  }
+  std::shared_ptr<FlowField> field = getLevel()->getFlowField(getMovementType(), pos, getTime());
+  if (field->getDistance(getPosition()) >= ShortestPath::infinity) {
+    Debug() << "Cannot move toward " << pos;
+    return Nothing();
+  }
+  for (Vec2 dir : field->getMoves(getPosition()))
+    if (canMove(dir))
+      return dir;
+  return Nothing();
+}
+
 Optional<Vec2> Creature::getMoveTowards(Vec2 pos, bool away, bool avoidEnemies) {
   Debug() << "" << getPosition() << (away ? "Moving away from" : " Moving toward ") << pos;
+  if (PathService::isEnabled())
+    return getMoveTowardsAsync(pos, away);
   bool newPath = false;
   bool targetChanged = shortestPath && shortestPath->getTarget().dist8(pos) > getPosition().dist8(pos) / 10;
-  if (!shortestPath || targetChanged || shortestPath->isReversed() != away) {
+  bool canRepair = shortestPath && !away && !shortestPath->isReversed()
+      && shortestPath->isReachable(getPosition());
+  if (shortestPath && shortestPath->isSuspended() && !targetChanged && !away) {
+    shortestPath->resume(getLevel(), this, getPosition());
+    newPath = true;
+  } else if (targetChanged && canRepair && shortestPath->repairTarget(getLevel(), this, getPosition(), pos)) {
+    Debug() << "Repaired the path to " << pos;
+    Benchmark::add(BenchCounter::PATH_REPAIRS);
+  } else if (!shortestPath || targetChanged || shortestPath->isReversed() != away) {
     newPath = true;
+    Benchmark::add(BenchCounter::PATH_SEARCHES);
     if (!away)
-      shortestPath = ShortestPath(getLevel(), this, pos, getPosition());
+      shortestPath = ShortestPath(getLevel(), this, pos, getPosition(), 0, false, true);
     else
       shortestPath = ShortestPath(getLevel(), this, pos, getPosition(), -1.5);
   }
   CHECK(shortestPath);
+  if (shortestPath->isSuspended()) {
+    Debug() << "Waiting for the path to " << pos;
+    Benchmark::add(BenchCounter::PATH_DEFERRALS);
+    return getGreedyMove(pos, away);
+  }
   if (shortestPath->isReachable(getPosition())) {
     Vec2 pos2 = shortestPath->getNextMove(getPosition());
     if (canMove(pos2 - getPosition())) {
       return pos2 - getPosition();
     }
+    if (!away && !shortestPath->isReversed()) {
+      if (shortestPath->repairBlocked(getLevel(), this, getPosition())) {
+        Debug() << "Going around " << pos2;
+        Benchmark::add(BenchCounter::PATH_REPAIRS);
+        Vec2 pos3 = shortestPath->getNextMove(getPosition());
+        if (canMove(pos3 - getPosition()))
+          return pos3 - getPosition();
+      } else if (getLevel()->getOccupiedSquares()[pos2] && getLevel()->getSquare(pos2)->canEnterEmpty(this)) {
+        // Searching again would lead through the same creature, so wait until it moves.
+        Debug() << "Waiting for " << pos2 << " to clear.";
+        return Nothing();
+      }
+    }
   }
   if (newPath)
     return Nothing();
   Debug() << "Reconstructing shortest path.";
+  Benchmark::add(BenchCounter::PATH_SEARCHES);
   if (!away)
-    shortestPath = ShortestPath(getLevel(), this, pos, getPosition());
+    shortestPath = ShortestPath(getLevel(), this, pos, getPosition(), 0, false, true);
   else
     shortestPath = ShortestPath(getLevel(), this, pos, getPosition(), -1.5);
+  if (shortestPath->isSuspended()) {
+    Benchmark::add(BenchCounter::PATH_DEFERRALS);
+    return getGreedyMove(pos, away);
+  }
   if (shortestPath->isReachable(getPosition())) {
     Vec2 pos2 = shortestPath->getNextMove(getPosition());
     if (canMove(pos2 - getPosition())) {
@@ -1753,6 +1853,36 @@ Optional<Vec2> Creature::getMoveTowards(Vec2 pos, bool away, bool avoidEnemies)
   }
 }
 
+/** Follows the last path found by the PathService. A new path is requested if it doesn't lead anywhere
+    useful, and until it's found a greedy step is taken.*/
+Optional<Vec2> Creature::getMoveTowardsAsync(Vec2 pos, bool away) {
+  if (pathQuery && pathQuery->isAnswered()) {
+    shortestPath = std::move(pathQuery->getPath());
+    pathQuery.reset();
+  }
+  int tolerance = getPosition().dist8(pos) / 10;
+  if (shortestPath && shortestPath->getTarget().dist8(pos) <= tolerance && shortestPath->isReversed() == away
+      && shortestPath->isReachable(getPosition())) {
+    Vec2 pos2 = shortestPath->getNextMove(getPosition());
+    if (canMove(pos2 - getPosition()))
+      return pos2 - getPosition();
+  }
+  if (!pathQuery || pathQuery->getTarget().dist8(pos) > tolerance || pathQuery->isAway() != away)
+    pathQuery = PathService::submit(this, pos, away);
+  return getGreedyMove(pos, away);
+}
+
+Optional<Vec2> Creature::getGreedyMove(Vec2 pos, bool away) {
+  if (pos == getPosition())
+    return Nothing();
+  pair<Vec2, Vec2> dirs = (away ? getPosition() - pos : pos - getPosition()).approxL1();
+  if (canMove(dirs.first))
+    return dirs.first;
+  if (canMove(dirs.second))
+    return dirs.second;
+  return Nothing();
+}
+
 Optional<Vec2> Creature::getMoveAway(Vec2 pos, bool pathfinding) {
   if ((pos - getPosition()).length8() <= 5 && pathfinding) {
     Optional<Vec2> move = getMoveTowards(pos, true, false);
@@ -1766,7 +1896,7 @@ Optional<Vec2> Creature::getMoveAway(Vec2 pos, bool pathfinding) {
   if (canMove(dirs.second))
     moves.push_back(dirs.second);
   if (moves.size() > 0)
-    return moves[Random.getRandom(moves.size())];
+    return moves[getRandom().getRandom(moves.size())];
   return Nothing();
 }
 
@@ -1785,14 +1915,14 @@ void Creature::youHit(BodyPart part, AttackType type) const {
           case AttackType::PUNCH: you(MsgType::YOUR, "neck is broken!"); break;
           case AttackType::HIT: you(MsgType::ARE, "hit in the back of the head!"); break;
           case AttackType::STAB: you(MsgType::ARE, "stabbed in the " + 
-                                     chooseRandom<string>({"back", "neck"})); break;
+                                     getRandom().choose<string>({"back", "neck"})); break;
           default: FAIL << "Unhandled attack type " << int(type);
         }
         break;
     case BodyPart::HEAD: 
         switch (type) {
           case AttackType::SHOOT: you(MsgType::ARE, "shot in the " +
-                                      chooseRandom<string>({"eye", "neck", "forehead"}) + "!"); break;
+                                      getRandom().choose<string>({"eye", "neck", "forehead"}) + "!"); break;
           case AttackType::BITE: you(MsgType::YOUR, "head is bitten off!"); break;
           case AttackType::CUT: you(MsgType::YOUR, "head is chopped off!"); break;
           case AttackType::CRUSH: you(MsgType::YOUR, "skull is shattered!"); break;
@@ -1808,7 +1938,7 @@ void Creature::youHit(BodyPart part, AttackType type) const {
           case AttackType::BITE: you(MsgType::YOUR, "internal organs are ripped out!"); break;
           case AttackType::CUT: you(MsgType::ARE, "cut in half!"); break;
           case AttackType::STAB: you(MsgType::ARE, "stabbed in the " +
-                                     chooseRandom<string>({"stomach", "heart"}, {1, 1}) + "!"); break;
+                                     getRandom().choose<string>({"stomach", "heart"}, {1, 1}) + "!"); break;
           case AttackType::CRUSH: you(MsgType::YOUR, "ribs and internal organs are crushed!"); break;
           case AttackType::HIT: you(MsgType::ARE, "hit in the chest!"); break;
           case AttackType::PUNCH: you(MsgType::YOUR, "stomach receives a deadly blow!"); break;
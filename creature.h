@@ -13,17 +13,27 @@
 #include "map_memory.h"
 #include "creature_view.h"
 #include "controller.h"
+#include "movement_type.h"
 
 class Level;
 class Tribe;
+class PathQuery;
 
 class Creature : private CreatureAttributes, public CreatureView {
   public:
   typedef CreatureAttributes CreatureAttributes;
   Creature(ViewObject o, Tribe* tribe, const CreatureAttributes& attr, ControllerFactory);
-  virtual ~Creature() {}
+  virtual ~Creature();
 
   static Creature* getDefault();
+
+  /** Creatures made on this thread from now on get their unique id, join their tribe and learn their skills only
+      when registerCreature is called, and are added to the list meanwhile. Used when levels are generated on
+      several threads, so that all that doesn't depend on the order of the threads. Nullptr registers them right
+      away again.*/
+  static void deferRegistration(vector<Creature*>*);
+  void registerCreature();
+
   static void noExperienceLevels();
 
   const ViewObject& getViewObject() const;
@@ -54,6 +64,10 @@ class Creature : private CreatureAttributes, public CreatureView {
   const Equipment& getEquipment() const;
   vector<PItem> steal(const vector<Item*> items);
   int getUniqueId() const;
+
+  /** Returns the random stream of the creature, derived from the game seed and its unique id.*/
+  RandomGen& getRandom() const;
+
   virtual bool canSee(const Creature*) const override;
   virtual bool canSee(Vec2 pos) const override;
   void slowDown(double duration);
@@ -189,6 +203,10 @@ class Creature : private CreatureAttributes, public CreatureView {
   Item* getWeapon() const;
 
   Optional<Vec2> getMoveTowards(Vec2 pos, bool avoidEnemies = false);
+
+  /** Like getMoveTowards, but follows a flow field shared by all creatures heading to the same target. Use it
+      for targets that a whole group is moving to.*/
+  Optional<Vec2> getSharedMoveTowards(Vec2 pos);
   Optional<Vec2> getMoveAway(Vec2 pos, bool pathfinding = true);
   bool atTarget() const;
   void die(const Creature* attacker = nullptr, bool dropInventory = true);
@@ -216,6 +234,7 @@ class Creature : private CreatureAttributes, public CreatureView {
   void setSpeed(double);
   double getSpeed() const;
   CreatureSize getSize() const;
+  const MovementType& getMovementType() const;
 
   typedef function<bool(const Creature*, const Creature*)> CreatureVision;
 
@@ -230,6 +249,8 @@ class Creature : private CreatureAttributes, public CreatureView {
 
   private:
   Optional<Vec2> getMoveTowards(Vec2 pos, bool away, bool avoidEnemies);
+  Optional<Vec2> getMoveTowardsAsync(Vec2 pos, bool away);
+  Optional<Vec2> getGreedyMove(Vec2 pos, bool away);
   double getInventoryWeight() const;
   Item* getAmmo() const;
   void updateViewObject();
@@ -247,6 +268,8 @@ class Creature : private CreatureAttributes, public CreatureView {
   void spendTime(double time);
   BodyPart armOrWing() const;
   void updateVisibleEnemies();
+  MovementType computeMovementType() const;
+  void updateMovementType();
   pair<double, double> getStanding(const Creature* c) const;
 
   ViewObject viewObject;
@@ -254,8 +277,11 @@ class Creature : private CreatureAttributes, public CreatureView {
   Vec2 position;
   double time;
   Equipment equipment;
-  int uniqueId;
+  // Both are set by registerCreature, and 0 means that the creature isn't registered yet.
+  int uniqueId = 0;
+  mutable RandomGen random;
   Optional<ShortestPath> shortestPath;
+  std::shared_ptr<PathQuery> pathQuery;
   unordered_set<const Creature*> knownHiding;
   Tribe* tribe;
   unordered_map<const Tribe*, double> standingOverride;
@@ -300,6 +326,8 @@ class Creature : private CreatureAttributes, public CreatureView {
   stack<PController> controllerStack;
   vector<CreatureVision*> creatureVision;
   mutable vector<const Creature*> kills;
+  // Kept up to date by updateMovementType, as squares ask for it every time a creature tries to enter them.
+  MovementType movementType;
 };
 
 
@@ -52,6 +52,7 @@ class CreatureAttributes {
   bool notLiving = false;
   bool walker = true;
   bool isFood = false;
+  bool farmAnimal = false;
   bool stationary = false;
   bool noSleep = false;
   double courage = 1;
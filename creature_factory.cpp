@@ -22,7 +22,7 @@ class BoulderController : public Monster {
 
   virtual void makeMove() override {
     if (myTribe != nullptr && stopped) {
-      for (Vec2 v : Vec2::directions8(true)) {
+      for (Vec2 v : Vec2::directions8(creature->getRandom())) {
         int radius = 4;
         bool found = false;
         for (int i = 1; i <= radius; ++i) {
@@ -127,7 +127,7 @@ class Boulder : public Creature {
             return new BoulderController(c, myTribe); })) {}
 
   virtual void dropCorpse() override {
-    drop(ItemFactory::fromId(ItemId::ROCK, Random.getRandom(10, 20)));
+    drop(ItemFactory::fromId(getRandom(), ItemId::ROCK, getRandom().getRandom(10, 20)));
   }
 };
 
@@ -167,8 +167,7 @@ PCreature CreatureFactory::getGuardingBoulder(Tribe* tribe) {
 
 class KrakenController : public Monster {
   public:
-  KrakenController(Creature* c) : Monster(c, MonsterAIFactory::monster()) {
-    numSpawns = chooseRandom({1, 2}, {4, 1});
+  KrakenController(Creature* c, int spawns) : Monster(c, MonsterAIFactory::monster()), numSpawns(spawns) {
   }
 
   void makeReady() {
@@ -241,7 +240,7 @@ class KrakenController : public Monster {
               makeReady();
             break;
           }
-          PCreature spawn = CreatureFactory::fromId(CreatureId::KRAKEN, creature->getTribe());
+          PCreature spawn = CreatureFactory::fromId(creature->getRandom(), CreatureId::KRAKEN, creature->getTribe());
           pair<Vec2, Vec2> dirs = v.approxL1();
           vector<Vec2> moves;
           if (creature->getSquare(dirs.first)->canEnter(spawn.get()))
@@ -252,7 +251,7 @@ class KrakenController : public Monster {
             if (!ready) {
               makeReady();
             } else {
-              Vec2 move = chooseRandom(moves);
+              Vec2 move = creature->getRandom().choose(moves);
               spawns.push_back(spawn.get());
               dynamic_cast<KrakenController*>(spawn->getController())->father = this;
               creature->getLevel()->addCreature(creature->getPosition() + move, std::move(spawn));
@@ -285,7 +284,7 @@ class KrakenController : public Monster {
       if (getLevel()->inBounds(getPosition() + v))
         if (Creature* enemy = getSquare(v)->getCreature())
           if (canSee(enemy) && isEnemy(enemy) && enemy->isPlayer()) {
-            PCreature c = CreatureFactory::fromId(chooseRandom(creatures), getTribe());
+            PCreature c = CreatureFactory::fromId(getRandom(), getRandom().choose(creatures), getTribe());
             enemy->you(MsgType::ARE, "frozen in place by " + getTheName() + "!");
             enemy->setHeld(c.get());
             globalMessage(getTheName() + " turns into " + c->getAName());
@@ -470,8 +469,8 @@ class VillageElder : public Creature {
         who->privateMessage(getName() + " teaches you the " + teachSkill->getName());
         if (teachSkill == Skill::archery) {
           who->privateMessage(getName() + " hands you a bow and a quiver of arrows.");
-          who->take(std::move(ItemFactory::fromId(ItemId::BOW)));
-          who->take(ItemFactory::fromId(ItemId::ARROW, Random.getRandom(20, 36)));
+          who->take(std::move(ItemFactory::fromId(getRandom(), ItemId::BOW)));
+          who->take(ItemFactory::fromId(getRandom(), ItemId::ARROW, getRandom().getRandom(20, 36)));
         }
         return true;
       }
@@ -483,7 +482,7 @@ class VillageElder : public Creature {
       if (q.first->isFinished()) {  
         who->privateMessage("\"" + (*who->getFirstName()) +
             ", you have fulfilled your quest. Here is your payment.\"");
-        who->takeItems(ItemFactory::fromId(ItemId::GOLD_PIECE, q.second), this);
+        who->takeItems(ItemFactory::fromId(getRandom(), ItemId::GOLD_PIECE, q.second), this);
         removeElement(quests, q);
         return true;
       }
@@ -516,7 +515,7 @@ class VillageElder : public Creature {
       Creature::onChat(who);
     else
       while (1) {
-        Location* l = locations[Random.getRandom(locations.size())];
+        Location* l = locations[getRandom().getRandom(locations.size())];
         if (l->hasName() && l != getLevel()->getLocation(getPosition())) {
           Vec2 dir = l->getBounds().middle() - getPosition();
           string dist = dir.lengthD() > 150 ? "far" : "close";
@@ -549,16 +548,16 @@ class DragonController : public Monster {
   }
 };
 
-PCreature CreatureFactory::addInventory(PCreature c, const vector<ItemId>& items) {
+PCreature CreatureFactory::addInventory(RandomGen& random, PCreature c, const vector<ItemId>& items) {
   for (ItemId item : items) {
-    PItem it = ItemFactory::fromId(item);
+    PItem it = ItemFactory::fromId(random, item);
     Item* ref = it.get();
     c->take(std::move(it));
   }
   return c;
 }
 
-PCreature CreatureFactory::getShopkeeper(Location* shopArea, Tribe* tribe) {
+PCreature CreatureFactory::getShopkeeper(RandomGen& random, Location* shopArea, Tribe* tribe) {
   PCreature ret(new Creature(
       ViewObject(tribe == Tribe::dwarven ? ViewId::DWARVEN_SHOPKEEPER : ViewId::ELVEN_SHOPKEEPER,
           ViewLayer::CREATURE, "Shopkeeper"), tribe,
@@ -576,23 +575,23 @@ PCreature CreatureFactory::getShopkeeper(Location* shopArea, Tribe* tribe) {
         c.firstName = NameGenerator::firstNames.getNext();),
       ControllerFactory([shopArea](Creature* c) { 
           return new ShopkeeperController(c, shopArea); })));
-  vector<ItemId> inventory(Random.getRandom(100, 300), ItemId::GOLD_PIECE);
+  vector<ItemId> inventory(random.getRandom(100, 300), ItemId::GOLD_PIECE);
   inventory.push_back(ItemId::SWORD);
   inventory.push_back(ItemId::LEATHER_ARMOR);
   inventory.push_back(ItemId::LEATHER_BOOTS);
   inventory.push_back(ItemId::HEALING_POTION);
   inventory.push_back(ItemId::HEALING_POTION);
-  return addInventory(std::move(ret), inventory);
+  return addInventory(random, std::move(ret), inventory);
 }
 
 
-PCreature CreatureFactory::random(MonsterAIFactory actorFactory) {
+PCreature CreatureFactory::random(RandomGen& random, MonsterAIFactory actorFactory) {
   if (unique.size() > 0) {
     CreatureId id = unique.back();
     unique.pop_back();
-    return fromId(id, tribe, actorFactory);
+    return fromId(random, id, tribe, actorFactory);
   }
-  return fromId(chooseRandom(creatures, weights), tribe, actorFactory);
+  return fromId(random, random.choose(creatures, weights), tribe, actorFactory);
 }
 
 PCreature get(ViewId viewId,
@@ -719,7 +718,7 @@ CreatureFactory CreatureFactory::pyramid(int level) {
     return CreatureFactory(Tribe::monster, { CreatureId::MUMMY }, {1}, { });
 }
 
-CreatureFactory CreatureFactory::level(int num) {
+CreatureFactory CreatureFactory::level(RandomGen& random, int num) {
   int maxLevel = 8;
   CHECK(num <= maxLevel && num > 0);
   map<CreatureId, vector<int>> frequencies {
@@ -742,8 +741,8 @@ CreatureFactory CreatureFactory::level(int num) {
       { CreatureId::NIGHTMARE, { 5, 5, 10, 10, 20, 30, 30, 40, 40, 40 }},
       { CreatureId::DWARF, { 400, 200, 100, 50, 50, 30, 20, 20 }}};
   vector<vector<CreatureId>> uniqueMonsters(maxLevel);
-  uniqueMonsters[Random.getRandom(5, maxLevel)].push_back(CreatureId::SPECIAL_MONSTER);
-  uniqueMonsters[Random.getRandom(5, maxLevel)].push_back(CreatureId::SPECIAL_HUMANOID);
+  uniqueMonsters[random.getRandom(5, maxLevel)].push_back(CreatureId::SPECIAL_MONSTER);
+  uniqueMonsters[random.getRandom(5, maxLevel)].push_back(CreatureId::SPECIAL_HUMANOID);
   vector<CreatureId> ids;
   vector<double> freq;
   for (auto elem : frequencies) {
@@ -758,21 +757,22 @@ CreatureFactory CreatureFactory::singleType(Tribe* tribe, CreatureId id) {
   return CreatureFactory(tribe, { id}, {1}, {});
 }
 
-vector<PCreature> CreatureFactory::getFlock(int size, CreatureId id, Creature* leader) {
+vector<PCreature> CreatureFactory::getFlock(RandomGen& random, int size, CreatureId id, Creature* leader) {
   vector<PCreature> ret;
   for (int i : Range(size)) {
-    PCreature c = fromId(id, leader->getTribe(), MonsterAIFactory::follower(leader, 5));
+    PCreature c = fromId(random, id, leader->getTribe(), MonsterAIFactory::follower(leader, 5));
     ret.push_back(std::move(c));
   }
   return ret;
 }
 
-PCreature getSpecial(const string& name, Tribe* tribe, bool humanoid, ControllerFactory factory) {
+PCreature getSpecial(RandomGen& random, const string& name, Tribe* tribe, bool humanoid,
+    ControllerFactory factory) {
   RandomGen r;
   r.init(hash<string>()(name));
   PCreature c = get(humanoid ? ViewId::SPECIAL_HUMANOID : ViewId::SPECIAL_BEAST, CATTR(
         c.speed = r.getRandom(70, 150);
-        c.size = chooseRandom({CreatureSize::SMALL, CreatureSize::MEDIUM, CreatureSize::LARGE}, {1, 1, 1});
+        c.size = random.choose({CreatureSize::SMALL, CreatureSize::MEDIUM, CreatureSize::LARGE}, {1, 1, 1});
         c.strength = r.getRandom(16, 25);
         c.dexterity = r.getRandom(16, 25);
         c.barehandedDamage = r.getRandom(5, 15);
@@ -787,7 +787,7 @@ PCreature getSpecial(const string& name, Tribe* tribe, bool humanoid, Controller
           c.chatReactionFriendly = c.chatReactionHostile = "The " + name + " snarls.";
         }
         c.name = name;
-        if (!(*c.humanoid) && Random.roll(10)) {
+        if (!(*c.humanoid) && random.roll(10)) {
           c.noBody = true;
           c.wings = c.arms = c.legs = 0;
           *c.strength -= 5;
@@ -803,13 +803,13 @@ PCreature getSpecial(const string& name, Tribe* tribe, bool humanoid, Controller
             *c.strength += 5;
             *c.dexterity += 5;
             c.barehandedDamage += 5;
-            switch (Random.getRandom(8)) {
+            switch (random.getRandom(8)) {
               case 0: c.attackEffect = EffectType::POISON; break;
               case 1: c.attackEffect = EffectType::FIRE; c.barehandedAttack = AttackType::HIT; break;
               default: break;
             }
           }
-          if (Random.roll(10))
+          if (random.roll(10))
             c.undead = true;
         }
         if (r.roll(3))
@@ -817,24 +817,24 @@ PCreature getSpecial(const string& name, Tribe* tribe, bool humanoid, Controller
         c.specialMonster = true;
         ), tribe, factory);
   if (c->isHumanoid()) {
-    if (Random.roll(400)) {
-      c->take(ItemFactory::fromId(ItemId::BOW));
-      c->take(ItemFactory::fromId(ItemId::ARROW, Random.getRandom(20, 36)));
+    if (random.roll(400)) {
+      c->take(ItemFactory::fromId(random, ItemId::BOW));
+      c->take(ItemFactory::fromId(random, ItemId::ARROW, random.getRandom(20, 36)));
     } else
-      c->take(ItemFactory::fromId(chooseRandom(
+      c->take(ItemFactory::fromId(random, random.choose(
             {ItemId::SWORD, ItemId::BATTLE_AXE, ItemId::WAR_HAMMER})));
   } else {
- /*   switch (Random.getRandom(3)) {
+ /*   switch (random.getRandom(3)) {
       case 0:
-        c->take(ItemFactory::fromId(
-              chooseRandom({ItemId::WARNING_AMULET, ItemId::HEALING_AMULET, ItemId::DEFENSE_AMULET})));
+        c->take(ItemFactory::fromId(random,
+              random.choose({ItemId::WARNING_AMULET, ItemId::HEALING_AMULET, ItemId::DEFENSE_AMULET})));
         break;
       case 1:
-        c->take(ItemFactory::fromId(ItemId::INVISIBLE_POTION, Random.getRandom(3, 6)));
+        c->take(ItemFactory::fromId(random, ItemId::INVISIBLE_POTION, random.getRandom(3, 6)));
         break;
       case 2:
-        c->take(ItemFactory::fromId(
-              chooseRandom({ItemId::STRENGTH_MUSHROOM, ItemId::DEXTERITY_MUSHROOM}), Random.getRandom(3, 6)));
+        c->take(ItemFactory::fromId(random,
+              random.choose({ItemId::STRENGTH_MUSHROOM, ItemId::DEXTERITY_MUSHROOM}), random.getRandom(3, 6)));
         break;
       default:
         FAIL << "Unhandled case value";
@@ -845,7 +845,7 @@ PCreature getSpecial(const string& name, Tribe* tribe, bool humanoid, Controller
   return c;
 }
 
-PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
+PCreature get(RandomGen& random, CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
   ControllerFactory factory = Monster::getFactory(actorFactory);
   switch (id) {
     case CreatureId::KEEPER: return get(ViewId::KEEPER, CATTR(
@@ -966,8 +966,8 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.chatReactionHostile = "\"Die!\"";
                                 c.name = "guard";), tribe, factory);
     case CreatureId::AVATAR: return PCreature(new VillageElder({}, {
-                                    {Quest::castleCellar, Random.getRandom(80, 120)},
-                                    {Quest::dragon, Random.getRandom(180, 320)}},
+                                    {Quest::castleCellar, random.getRandom(80, 120)},
+                                    {Quest::dragon, random.getRandom(180, 320)}},
                                 ViewObject(ViewId::AVATAR, ViewLayer::CREATURE, "Duke"), tribe, CATTR(
                                 c.speed = 100;
                                 c.size = CreatureSize::LARGE;
@@ -1169,7 +1169,7 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.name = NameGenerator::aztecNames.getNext();), tribe, factory);
     case CreatureId::GREAT_GOBLIN: return PCreature(new VillageElder(
                                 {},
-                                {{Quest::dwarves, Random.getRandom(300, 400)}},
+                                {{Quest::dwarves, random.getRandom(300, 400)}},
                                 ViewObject(ViewId::GREAT_GOBLIN, ViewLayer::CREATURE, "Great goblin"), Tribe::goblin,
                                 CATTR(
                                 c.speed = 100;
@@ -1228,6 +1228,7 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.weight = 3;
                                 c.walker = false;
                                 c.isFood = true;
+                                c.farmAnimal = true;
                                 c.name = "chicken";), tribe, factory);
     case CreatureId::DUNGEON_HEART: return get(ViewId::DUNGEON_HEART, CATTR(
                                 c.speed = 100;
@@ -1271,7 +1272,7 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.name = "dwarf";), Tribe::dwarven, factory);
     case CreatureId::DWARF_BARON: return PCreature(new VillageElder(
                                 {},
-                                {{Quest::goblins, Random.getRandom(300, 400)}},
+                                {{Quest::goblins, random.getRandom(300, 400)}},
                                 ViewObject(ViewId::DWARF_BARON, ViewLayer::CREATURE, "Dwarf baron"), Tribe::dwarven, 
                                 CATTR(
                                 c.speed = 80;
@@ -1325,7 +1326,7 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.name = "elf child";), Tribe::elven, factory);
     case CreatureId::ELF_LORD: return PCreature(new VillageElder(
                                 {},
-                                {{Quest::bandits, Random.getRandom(80, 120)}},
+                                {{Quest::bandits, random.getRandom(80, 120)}},
                                 ViewObject(ViewId::ELF_LORD, ViewLayer::CREATURE, "Elf lord"), Tribe::elven, CATTR(
                                 c.speed = 140;
                                 c.size = CreatureSize::MEDIUM;
@@ -1378,6 +1379,7 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.innocent = true;
                                 c.weight = 150;
                                 c.animal = true;
+                                c.farmAnimal = true;
                                 c.name = "pig";), tribe, factory);
     case CreatureId::JACKAL: return get(ViewId::JACKAL, CATTR(
                                 c.speed = 120;
@@ -1467,7 +1469,7 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.arms = 0;
                                 c.animal = true;
                                 c.name = "spider";), tribe, factory);
-    case CreatureId::FLY: {  bool fly = Random.roll(1);
+    case CreatureId::FLY: {  bool fly = random.roll(1);
                              return get(fly ? ViewId::FLY : ViewId::SCORPION, CATTR(
                                 c.speed = 150;
                                 c.size = CreatureSize::SMALL;
@@ -1550,7 +1552,8 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.name = "fire sphere";), tribe, ControllerFactory([=](Creature* c) {
                                       return new KamikazeController(c, actorFactory);
                                     }));
-    case CreatureId::KRAKEN: return get(ViewId::KRAKEN, CATTR(
+    case CreatureId::KRAKEN: {  int numSpawns = random.choose({1, 2}, {4, 1});
+                             return get(ViewId::KRAKEN, CATTR(
                                 c.speed = 40;
                                 c.size = CreatureSize::LARGE;
                                 c.strength = 15;
@@ -1563,8 +1566,8 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.skills.insert(Skill::swimming);
                                 c.weight = 100;
                                 c.name = "kraken";), tribe, ControllerFactory([=](Creature* c) {
-                                      return new KrakenController(c);
-                                    }));
+                                      return new KrakenController(c, numSpawns);
+                                    })); }
     case CreatureId::NIGHTMARE: /*return PCreature(new Shapechanger(
                                    ViewObject(ViewId::NIGHTMARE, ViewLayer::CREATURE, "nightmare"),
                                    Tribe::monster,
@@ -1613,37 +1616,39 @@ PCreature get(CreatureId id, Tribe* tribe, MonsterAIFactory actorFactory) {
                                 c.weight = 30;
                                 c.breathing = false;
                                 c.name = "Death";), Tribe::killEveryone, factory);
-    case CreatureId::SPECIAL_MONSTER: return getSpecial(NameGenerator::creatureNames.getNext(),
+    case CreatureId::SPECIAL_MONSTER: return getSpecial(random, NameGenerator::creatureNames.getNext(),
                                                         tribe, false, factory);
-    case CreatureId::SPECIAL_HUMANOID: return getSpecial(NameGenerator::creatureNames.getNext(),
+    case CreatureId::SPECIAL_HUMANOID: return getSpecial(random, NameGenerator::creatureNames.getNext(),
                                                         tribe, true, factory);
   }
   FAIL << "unhandled case";
   return PCreature(nullptr);
 }
 
-ItemId randomHealing() {
-  return chooseRandom({ItemId::HEALING_POTION, ItemId::FIRST_AID_KIT});
+ItemId randomHealing(RandomGen& random) {
+  return random.choose({ItemId::HEALING_POTION, ItemId::FIRST_AID_KIT});
 }
 
-ItemId randomBackup() {
-  return chooseRandom({ItemId::TELE_SCROLL, randomHealing()}, {1, 4});
+ItemId randomBackup(RandomGen& random) {
+  return random.choose({ItemId::TELE_SCROLL, randomHealing(random)}, {1, 4});
 }
 
-ItemId randomArmor() {
-  return chooseRandom({ItemId::LEATHER_ARMOR, ItemId::CHAIN_ARMOR}, {4, 1});
+ItemId randomArmor(RandomGen& random) {
+  return random.choose({ItemId::LEATHER_ARMOR, ItemId::CHAIN_ARMOR}, {4, 1});
 }
 
 class ItemList {
   public:
+  ItemList(RandomGen& r) : random(r) {}
+
   ItemList& maybe(double chance, ItemId id, int num = 1) {
-    if (Random.getDouble() <= chance)
+    if (random.getDouble() <= chance)
       add(id, num);
     return *this;
   }
 
   ItemList& maybe(double chance, const vector<ItemId>& ids) {
-    if (Random.getDouble() <= chance)
+    if (random.getDouble() <= chance)
       for (ItemId id : ids)
         add(id);
     return *this;
@@ -1660,92 +1665,93 @@ class ItemList {
   }
 
   private:
+  RandomGen& random;
   vector<ItemId> ret;
 };
 
-vector<ItemId> getInventory(CreatureId id) {
+vector<ItemId> getInventory(RandomGen& random, CreatureId id) {
   switch (id) {
-    case CreatureId::KEEPER: return ItemList()
+    case CreatureId::KEEPER: return ItemList(random)
             .add(ItemId::LEATHER_ARMOR);
-    case CreatureId::DEATH: return ItemList()
+    case CreatureId::DEATH: return ItemList(random)
             .add(ItemId::SCYTHE);
-    case CreatureId::LEPRECHAUN: return ItemList()
-            .add(ItemId::TELE_SCROLL, Random.getRandom(1, 4));
-    case CreatureId::GNOME: return ItemList()
-            .add(chooseRandom({ItemId::KNIFE}))
+    case CreatureId::LEPRECHAUN: return ItemList(random)
+            .add(ItemId::TELE_SCROLL, random.getRandom(1, 4));
+    case CreatureId::GNOME: return ItemList(random)
+            .add(random.choose({ItemId::KNIFE}))
             .maybe(0.3, ItemId::LEATHER_BOOTS)
-            .maybe(0.05, ItemList().add(ItemId::BOW).add(ItemId::ARROW, Random.getRandom(20, 36)));
-    case CreatureId::ARCHER: return ItemList()
-            .add(ItemId::BOW).add(ItemId::ARROW, Random.getRandom(20, 36))
+            .maybe(0.05, ItemList(random).add(ItemId::BOW).add(ItemId::ARROW, random.getRandom(20, 36)));
+    case CreatureId::ARCHER: return ItemList(random)
+            .add(ItemId::BOW).add(ItemId::ARROW, random.getRandom(20, 36))
             .add(ItemId::KNIFE)
             .add(ItemId::LEATHER_ARMOR)
             .add(ItemId::LEATHER_BOOTS)
-            .add(randomHealing())
-            .add(ItemId::GOLD_PIECE, Random.getRandom(20, 50));
+            .add(randomHealing(random))
+            .add(ItemId::GOLD_PIECE, random.getRandom(20, 50));
     case CreatureId::CASTLE_GUARD:
-    case CreatureId::KNIGHT: return ItemList()
+    case CreatureId::KNIGHT: return ItemList(random)
             .add(ItemId::SWORD)
             .add(ItemId::CHAIN_ARMOR)
             .add(ItemId::LEATHER_BOOTS)
-            .add(randomHealing())
-            .add(ItemId::GOLD_PIECE, Random.getRandom(30, 80));
-    case CreatureId::DEVIL: return ItemList()
-            .add(chooseRandom({ItemId::BLINDNESS_POTION, ItemId::SLEEP_POTION, ItemId::SLOW_POTION}));
+            .add(randomHealing(random))
+            .add(ItemId::GOLD_PIECE, random.getRandom(30, 80));
+    case CreatureId::DEVIL: return ItemList(random)
+            .add(random.choose({ItemId::BLINDNESS_POTION, ItemId::SLEEP_POTION, ItemId::SLOW_POTION}));
     case CreatureId::DARK_KNIGHT:
-    case CreatureId::AVATAR: return ItemList()
+    case CreatureId::AVATAR: return ItemList(random)
             .add(ItemId::SPECIAL_BATTLE_AXE)
             .add(ItemId::CHAIN_ARMOR)
             .add(ItemId::IRON_HELM)
             .add(ItemId::IRON_BOOTS)
-            .add(ItemId::HEALING_POTION, Random.getRandom(1, 4))
-            .add(ItemId::GOLD_PIECE, Random.getRandom(200, 300));
-    case CreatureId::BILE_DEMON: return ItemList().add(ItemId::WAR_HAMMER);
+            .add(ItemId::HEALING_POTION, random.getRandom(1, 4))
+            .add(ItemId::GOLD_PIECE, random.getRandom(200, 300));
+    case CreatureId::BILE_DEMON: return ItemList(random).add(ItemId::WAR_HAMMER);
     case CreatureId::BANDIT:
-    case CreatureId::GOBLIN: return ItemList()
-            .add(chooseRandom({ItemId::SWORD}, {3}))
+    case CreatureId::GOBLIN: return ItemList(random)
+            .add(random.choose({ItemId::SWORD}, {3}))
             .add(ItemId::LEATHER_ARMOR)
-            .maybe(0.3, randomBackup());
-    case CreatureId::GREAT_GOBLIN: return ItemList()
-            .add(chooseRandom({ItemId::SPECIAL_BATTLE_AXE, ItemId::SPECIAL_WAR_HAMMER}, {1, 1}))
+            .maybe(0.3, randomBackup(random));
+    case CreatureId::GREAT_GOBLIN: return ItemList(random)
+            .add(random.choose({ItemId::SPECIAL_BATTLE_AXE, ItemId::SPECIAL_WAR_HAMMER}, {1, 1}))
             .add(ItemId::IRON_HELM)
             .add(ItemId::IRON_BOOTS)
             .add(ItemId::CHAIN_ARMOR)
-            .add(randomBackup())
-            .add(ItemId::KNIFE, Random.getRandom(2, 5))
-            .add(ItemId::GOLD_PIECE, Random.getRandom(100, 200));
-    case CreatureId::DWARF: return ItemList()
-            .add(chooseRandom({ItemId::BATTLE_AXE, ItemId::WAR_HAMMER}, {1, 1}))
-            .maybe(0.6, randomBackup())
+            .add(randomBackup(random))
+            .add(ItemId::KNIFE, random.getRandom(2, 5))
+            .add(ItemId::GOLD_PIECE, random.getRandom(100, 200));
+    case CreatureId::DWARF: return ItemList(random)
+            .add(random.choose({ItemId::BATTLE_AXE, ItemId::WAR_HAMMER}, {1, 1}))
+            .maybe(0.6, randomBackup(random))
             .add(ItemId::CHAIN_ARMOR)
             .maybe(0.5, ItemId::IRON_HELM)
             .maybe(0.3, ItemId::IRON_BOOTS)
-            .maybe(0.2, ItemId::GOLD_PIECE, Random.getRandom(10, 30));
-    case CreatureId::DWARF_BARON: return ItemList()
-            .add(chooseRandom({ItemId::SPECIAL_BATTLE_AXE, ItemId::SPECIAL_WAR_HAMMER}, {1, 1}))
-            .add(randomBackup())
+            .maybe(0.2, ItemId::GOLD_PIECE, random.getRandom(10, 30));
+    case CreatureId::DWARF_BARON: return ItemList(random)
+            .add(random.choose({ItemId::SPECIAL_BATTLE_AXE, ItemId::SPECIAL_WAR_HAMMER}, {1, 1}))
+            .add(randomBackup(random))
             .add(ItemId::CHAIN_ARMOR)
             .add(ItemId::IRON_BOOTS)
             .add(ItemId::IRON_HELM);
-    case CreatureId::ELF_LORD: return ItemList()
+    case CreatureId::ELF_LORD: return ItemList(random)
             .add(ItemId::SPECIAL_ELVEN_SWORD)
             .add(ItemId::LEATHER_ARMOR)
             .add(ItemId::BOW)
-            .add(ItemId::ARROW, Random.getRandom(20, 36))
-            .add(randomBackup());
-    case CreatureId::ELF_ARCHER: return ItemList()
+            .add(ItemId::ARROW, random.getRandom(20, 36))
+            .add(randomBackup(random));
+    case CreatureId::ELF_ARCHER: return ItemList(random)
             .add(ItemId::ELVEN_SWORD)
             .add(ItemId::LEATHER_ARMOR)
             .add(ItemId::BOW)
-            .add(ItemId::ARROW, Random.getRandom(20, 36))
-            .add(randomBackup());
-    case CreatureId::MUMMY_LORD: return ItemList()
-            .add(ItemId::GOLD_PIECE, Random.getRandom(100, 200)).add(
-            chooseRandom({ItemId::SPECIAL_BATTLE_AXE, ItemId::SPECIAL_WAR_HAMMER, ItemId::SPECIAL_SWORD}, {1, 1, 1}));
+            .add(ItemId::ARROW, random.getRandom(20, 36))
+            .add(randomBackup(random));
+    case CreatureId::MUMMY_LORD: return ItemList(random)
+            .add(ItemId::GOLD_PIECE, random.getRandom(100, 200)).add(
+            random.choose({ItemId::SPECIAL_BATTLE_AXE, ItemId::SPECIAL_WAR_HAMMER, ItemId::SPECIAL_SWORD}, {1, 1, 1}));
     default: return {};
   }
 }
 
-PCreature CreatureFactory::fromId(CreatureId id, Tribe* t, MonsterAIFactory factory) {
-  return addInventory(get(id, t, factory), getInventory(id));
+PCreature CreatureFactory::fromId(RandomGen& random, CreatureId id, Tribe* t, MonsterAIFactory factory) {
+  return addInventory(random, get(random, id, t, factory), getInventory(random, id));
 }
 
@@ -18,8 +18,8 @@ class ItemFactory;
 
 class CreatureFactory {
   public:
-  static PCreature fromId(CreatureId, Tribe*, MonsterAIFactory = MonsterAIFactory::monster());
-  static vector<PCreature> getFlock(int size, CreatureId, Creature* leader);
+  static PCreature fromId(RandomGen&, CreatureId, Tribe*, MonsterAIFactory = MonsterAIFactory::monster());
+  static vector<PCreature> getFlock(RandomGen&, int size, CreatureId, Creature* leader);
   static CreatureFactory humanVillage();
   static CreatureFactory humanVillagePeaceful();
   static CreatureFactory elvenVillage();
@@ -36,17 +36,17 @@ class CreatureFactory {
   static CreatureFactory collectiveElfFinalAttack();
   static CreatureFactory collectiveSurpriseEnemies();
   static CreatureFactory goblinTown(int num);
-  static CreatureFactory level(int num);
+  static CreatureFactory level(RandomGen&, int num);
   static CreatureFactory bottomLevel();
   static CreatureFactory singleType(Tribe*, CreatureId);
   static CreatureFactory pyramid(int level);
-  PCreature random(MonsterAIFactory = MonsterAIFactory::monster());
+  PCreature random(RandomGen&, MonsterAIFactory = MonsterAIFactory::monster());
 
-  static PCreature getShopkeeper(Location* shopArea, Tribe*);
+  static PCreature getShopkeeper(RandomGen&, Location* shopArea, Tribe*);
   static PCreature getRollingBoulder(Vec2 direction);
   static PCreature getGuardingBoulder(Tribe* tribe);
 
-  static PCreature addInventory(PCreature c, const vector<ItemId>& items);
+  static PCreature addInventory(RandomGen&, PCreature c, const vector<ItemId>& items);
 
   static void init();
   
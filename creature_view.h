@@ -16,6 +16,12 @@ class CreatureView {
   virtual const Level* getLevel() const = 0;
   virtual vector<const Creature*> getUnknownAttacker() const = 0;
   virtual vector<const Creature*> getVisibleCreatures() const { return {}; }
+
+  /** Returns the squares where getViewIndex shows something that isn't on the level or in memory, like planned
+      constructions. Views may keep the view indexes of other squares until the level or memory tells that they
+      changed, except for squares with creatures. Returns Nothing if any square can change at any time, like
+      when the visibility depends on where the creature stands.*/
+  virtual Optional<vector<Vec2>> getOverlaySquares() const { return Nothing(); }
 };
 
 #endif
@@ -14,6 +14,8 @@ Debug::Debug(DebugType t, const string& msg, int line)
 }
 
 static ofstream output;
+// Path searches may log from worker threads.
+static std::mutex outputMutex;
 
 void Debug::init() {
   output.open("log.out");
@@ -22,7 +24,8 @@ void Debug::init() {
 void Debug::add(const string& a) {
   out += a;
 }
-Debug::~Debug() {
+Debug::~Debug() noexcept(false) {
+  std::lock_guard<std::mutex> lock(outputMutex);
   if (type == FATAL) {
     output << out << endl;
     output.flush();
@@ -61,7 +61,7 @@ class Debug {
   Debug& operator<<(const vector<T>& container);
   template<class T>
   Debug& operator<<(const vector<vector<T> >& container);
-  ~Debug();
+  ~Debug() noexcept(false);
 
   private:
   string out;
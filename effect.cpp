@@ -98,7 +98,7 @@ static int summonCreatures(Creature* c, int radius, vector<PCreature> creatures)
   int numCreated = 0;
   vector<Vec2> area = Rectangle(-radius, -radius, radius, radius).getAllSquares();
   for (int i : All(creatures))
-    for (Vec2 v : randomPermutation(area))
+    for (Vec2 v : c->getRandom().permutation(area))
       if (c->getSquare(v)->canEnter(creatures[i].get())) {
         ++numCreated;
         c->getLevel()->addCreature(c->getPosition() + v, std::move(creatures[i]));
@@ -109,14 +109,14 @@ static int summonCreatures(Creature* c, int radius, vector<PCreature> creatures)
 
 static void insects(Creature* c) {
   vector<PCreature> creatures;
-  for (int i : Range(Random.getRandom(3, 7)))
-    creatures.push_back(CreatureFactory::fromId(CreatureId::FLY, c->getTribe()));
+  for (int i : Range(c->getRandom().getRandom(3, 7)))
+    creatures.push_back(CreatureFactory::fromId(c->getRandom(), CreatureId::FLY, c->getTribe()));
   summonCreatures(c, 1, std::move(creatures));
 }
 
 static void deception(Creature* c) {
   vector<PCreature> creatures;
-  for (int i : Range(Random.getRandom(3, 7))) {
+  for (int i : Range(c->getRandom().getRandom(3, 7))) {
     ViewObject viewObject(c->getViewObject().id(), ViewLayer::CREATURE, "Illusion");
     viewObject.setIllusion(true);
     creatures.push_back(PCreature(new Creature(viewObject, c->getTribe(), CATTR(
@@ -134,7 +134,7 @@ static void deception(Creature* c) {
           c.humanoid = true;
           c.name = "illusion";),
         ControllerFactory([c] (Creature* o) { return new IllusionController(o, c->getTime()
-            + Random.getRandom(5, 10));}))));
+            + c->getRandom().getRandom(5, 10));}))));
   }
   summonCreatures(c, 2, std::move(creatures));
 }
@@ -142,7 +142,7 @@ static void deception(Creature* c) {
 static void wordOfPower(Creature* c, EffectStrength strength) {
   Level* l = c->getLevel();
   EventListener::addExplosionEvent(c->getLevel(), c->getPosition());
-  for (Vec2 v : Vec2::directions8(true)) {
+  for (Vec2 v : Vec2::directions8(c->getRandom())) {
     if (Creature* other = c->getSquare(v)->getCreature()) {
       if (other->isStationary())
         continue;
@@ -163,7 +163,7 @@ static void wordOfPower(Creature* c, EffectStrength strength) {
     }
     for (PItem& it : c->getSquare(v)->removeItems(c->getSquare(v)->getItems())) {
       Item* ref = it.get();
-      l->throwItem(std::move(it), Attack(c, chooseRandom({AttackLevel::LOW, AttackLevel::MIDDLE, AttackLevel::HIGH}), ref->getAttackType(), 15, 15, false), wordOfPowerDist.at(strength), c->getPosition(), v);
+      l->throwItem(std::move(it), Attack(c, c->getRandom().choose({AttackLevel::LOW, AttackLevel::MIDDLE, AttackLevel::HIGH}), ref->getAttackType(), 15, 15, false), wordOfPowerDist.at(strength), c->getPosition(), v);
     }
   }
 }
@@ -176,7 +176,7 @@ static void emitPoisonGas(Creature* c, EffectStrength strength) {
 
 static void guardingBuilder(Creature* c) {
   Optional<Vec2> dest;
-  for (Vec2 v : Vec2::directions8(true))
+  for (Vec2 v : Vec2::directions8(c->getRandom()))
     if (c->canMove(v) && !c->getSquare(v)->getCreature()) {
       dest = v;
       break;
@@ -194,9 +194,9 @@ static void guardingBuilder(Creature* c) {
 }
 
 static void fireSpherePet(Creature* c) {
-  PCreature sphere = CreatureFactory::fromId(
+  PCreature sphere = CreatureFactory::fromId(c->getRandom(),
       CreatureId::FIRE_SPHERE, c->getTribe(), MonsterAIFactory::follower(c, 1));
-  for (Vec2 v : Vec2::directions8(true))
+  for (Vec2 v : Vec2::directions8(c->getRandom()))
     if (c->getSquare(v)->canEnter(sphere.get())) {
       c->getLevel()->addCreature(c->getPosition() + v, std::move(sphere));
       c->globalMessage("A fire sphere appears.");
@@ -205,7 +205,7 @@ static void fireSpherePet(Creature* c) {
 }
 
 static void enhanceArmor(Creature* c, int mod = 1, const string msg = "is improved") {
-  for (EquipmentSlot slot : randomPermutation({
+  for (EquipmentSlot slot : c->getRandom().permutation({
         EquipmentSlot::BODY_ARMOR, EquipmentSlot::HELMET, EquipmentSlot::BOOTS}))
     if (Item* item = c->getEquipment().getItem(slot)) {
       c->you(MsgType::YOUR, item->getName() + " " + msg);
@@ -218,7 +218,7 @@ static void enhanceArmor(Creature* c, int mod = 1, const string msg = "is improv
 static void enhanceWeapon(Creature* c, int mod = 1, const string msg = "is improved") {
   if (Item* item = c->getEquipment().getItem(EquipmentSlot::WEAPON)) {
     c->you(MsgType::YOUR, item->getName() + " " + msg);
-    item->addModifier(chooseRandom({AttrType::TO_HIT, AttrType::DAMAGE}), mod);
+    item->addModifier(c->getRandom().choose({AttrType::TO_HIT, AttrType::DAMAGE}), mod);
   }
 }
 
@@ -227,7 +227,7 @@ static void destroyEquipment(Creature* c) {
   for (Item* item : c->getEquipment().getItems())
     if (c->getEquipment().isEquiped(item))
       equiped.push_back(item);
-  Item* dest = chooseRandom(equiped);
+  Item* dest = c->getRandom().choose(equiped);
   c->you(MsgType::YOUR, dest->getName() + " crumbles to dust.");
   c->steal({dest});
   return;
@@ -243,12 +243,12 @@ static void heal(Creature* c, EffectStrength strength) {
 static void sleep(Creature* c, EffectStrength strength) {
   Square *square = c->getLevel()->getSquare(c->getPosition());
   c->you(MsgType::FALL_ASLEEP, square->getName());
-  c->sleep(Random.getRandom(sleepTime[strength]));
+  c->sleep(c->getRandom().getRandom(sleepTime[strength]));
 }
 
 static void portal(Creature* c) {
   Level* l = c->getLevel();
-  for (Vec2 v : c->getPosition().neighbors8(true))
+  for (Vec2 v : c->getPosition().neighbors8(c->getRandom()))
     if (l->getSquare(v)->canEnter(c)) {
       l->globalMessage(v, "A magic portal appears.");
       l->getSquare(v)->addTrigger(Trigger::getPortal(
@@ -298,7 +298,7 @@ static void teleport(Creature* c) {
     c->privateMessage("The spell didn't work.");
   CHECK(!good.empty());
   c->you(MsgType::TELE_DISAPPEAR, "");
-  l->moveCreature(c, chooseRandom(good) - pos);
+  l->moveCreature(c, c->getRandom().choose(good) - pos);
   c->you(MsgType::TELE_APPEAR, "");
 }
 
@@ -321,7 +321,7 @@ static void rollingBoulder(Creature* c) {
     }
     if (possibleDirs.empty())
       continue;
-    Vec2 dir = chooseRandom(possibleDirs);
+    Vec2 dir = c->getRandom().choose(possibleDirs);
     l->globalMessage(pos + dir * dist, 
         MessageBuffer::important("A huge rolling boulder appears!"),
         MessageBuffer::important("You hear a heavy boulder rolling."));
@@ -340,7 +340,7 @@ static void rollingBoulder(Creature* c) {
 static void acid(Creature* c) {
   c->you(MsgType::ARE, "hurt by the acid");
   c->bleed(0.2);
-  switch (Random.getRandom(2)) {
+  switch (c->getRandom().getRandom(2)) {
     case 0 : enhanceArmor(c, -1, "corrodes"); break;
     case 1 : enhanceWeapon(c, -1, "corrodes"); break;
   }
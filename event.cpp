@@ -4,16 +4,29 @@
 #include "creature.h"
 
 vector<EventListener*> EventListener::listeners;
+static thread_local vector<EventListener*>* deferredListeners = nullptr;
 
 void EventListener::initialize() {
   listeners.clear();
 }
 
 void EventListener::addListener(EventListener* l) {
-  listeners.push_back(l);
+  if (deferredListeners)
+    deferredListeners->push_back(l);
+  else
+    listeners.push_back(l);
+}
+
+void EventListener::deferListeners(vector<EventListener*>* l) {
+  deferredListeners = l;
 }
 
 void EventListener::removeListener(EventListener* l) {
+  if (deferredListeners)
+    if (Optional<int> index = findElement(*deferredListeners, l)) {
+      deferredListeners->erase(deferredListeners->begin() + *index);
+      return;
+    }
   removeElement(listeners, l);
 }
 
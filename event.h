@@ -35,6 +35,10 @@ class EventListener {
   static void addChangeLevelEvent(const Creature*, const Level* from, Vec2 pos, const Level* to, Vec2 toPos);
 
   static void addListener(EventListener*);
+
+  /** Listeners added on this thread from now on go to the list instead, like in Creature::deferRegistration.
+      Nullptr adds them right away again.*/
+  static void deferListeners(vector<EventListener*>*);
   static void removeListener(EventListener*);
 
   virtual const Level* getListenerLevel() const { return nullptr; }
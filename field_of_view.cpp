@@ -1,116 +1,380 @@
 #include "stdafx.h"
 
 #include "field_of_view.h"
+#include "benchmark.h"
 
 using namespace std;
 
 
-FieldOfView::FieldOfView(const Table<PSquare>& s) : squares(s), visibility(squares.getWidth(), squares.getHeight()) {
+long long FieldOfView::cacheLimit = 32 * 1024 * 1024;
+
+void FieldOfView::setCacheLimit(long long bytes) {
+  cacheLimit = bytes;
+}
+
+FieldOfView::FieldOfView(const Table<PSquare>& s)
+    : squares(s), opacity(squares), cacheIndex(squares.getWidth(), squares.getHeight(), -1),
+      viewers((squares.getWidth() + blockSize - 1) / blockSize, (squares.getHeight() + blockSize - 1) / blockSize) {
+}
+
+FieldOfView::OpacityMap::OpacityMap(const Table<PSquare>& squares)
+    : width(squares.getWidth() + 2 * sightRange), height(squares.getHeight() + 2 * sightRange),
+      rows(height, width), rowsReversed(height, width), columns(width, height), columnsReversed(width, height) {
+  for (Vec2 v : squares.getBounds())
+    update(squares, v);
+}
+
+void FieldOfView::OpacityMap::update(const Table<PSquare>& squares, Vec2 pos) {
+  bool opaque = !squares[pos]->canSeeThru();
+  int x = pos.x + sightRange;
+  int y = pos.y + sightRange;
+  rows.set(y, x, opaque);
+  rowsReversed.set(y, width - 1 - x, opaque);
+  columns.set(x, y, opaque);
+  columnsReversed.set(x, height - 1 - y, opaque);
+}
+
+uint64_t FieldOfView::OpacityMap::getRight(int x, int y, int count) const {
+  return rows.get(y + sightRange, x + sightRange, count);
+}
+
+uint64_t FieldOfView::OpacityMap::getLeft(int x, int y, int count) const {
+  return rowsReversed.get(y + sightRange, width - 1 - (x + sightRange), count);
+}
+
+uint64_t FieldOfView::OpacityMap::getDown(int x, int y, int count) const {
+  return columns.get(x + sightRange, y + sightRange, count);
+}
+
+uint64_t FieldOfView::OpacityMap::getUp(int x, int y, int count) const {
+  return columnsReversed.get(x + sightRange, height - 1 - (y + sightRange), count);
+}
+
+// All squares start as opaque, which is what the padding needs.
+FieldOfView::OpacityMap::Lines::Lines(int numLines, int length)
+    : wordsPerLine((length + 63) / 64), bits(numLines * wordsPerLine, ~uint64_t(0)) {
+}
+
+void FieldOfView::OpacityMap::Lines::set(int line, int pos, bool value) {
+  uint64_t& word = bits[line * wordsPerLine + pos / 64];
+  if (value)
+    word |= uint64_t(1) << (pos % 64);
+  else
+    word &= ~(uint64_t(1) << (pos % 64));
+}
+
+uint64_t FieldOfView::OpacityMap::Lines::get(int line, int pos, int count) const {
+  const uint64_t* word = &bits[line * wordsPerLine + pos / 64];
+  int shift = pos % 64;
+  uint64_t ret = word[0] >> shift;
+  if (shift + count > 64)
+    ret |= word[1] << (64 - shift);
+  if (count < 64)
+    ret &= (uint64_t(1) << count) - 1;
+  return ret;
 }
 
 bool FieldOfView::canSee(Vec2 from, Vec2 to) {
   if ((from - to).lengthD() > sightRange)
     return false;
-  if (!visibility[from])
-    visibility[from] = Visibility(squares, from.x, from.y);
-  return visibility[from]->checkVisible(to.x - from.x, to.y - from.y);
+  return getVisibility(from).checkVisible(to.x - from.x, to.y - from.y);
 }
   
 void FieldOfView::squareChanged(Vec2 pos) {
-  vector<Vec2> updateList;
-  if (!visibility[pos])
-    visibility[pos] = Visibility(squares, pos.x, pos.y);
-  for (Vec2 v : visibility[pos]->getVisibleTiles())
-    if (visibility[v] && visibility[v]->checkVisible(pos.x - v.x, pos.y - v.y)) {
-      visibility[v] = Nothing();
+  opacity.update(squares, pos);
+  vector<Viewer>& blockViewers = viewers[pos.x / blockSize][pos.y / blockSize];
+  int numKept = 0;
+  for (int i = 0; i < blockViewers.size(); ++i) {
+    Viewer viewer = blockViewers[i];
+    CacheEntry& entry = entries[viewer.index];
+    if (entry.generation != viewer.generation)
+      continue;
+    if (entry.visibility.checkVisible(pos.x - entry.pos.x, pos.y - entry.pos.y)) {
+      Benchmark::add(BenchCounter::FOV_CACHE_INVALIDATIONS);
+      removeEntry(viewer.index);
+    } else
+      blockViewers[numKept++] = viewer;
+  }
+  blockViewers.resize(numKept);
+}
+
+vector<Vec2> FieldOfView::getVisibleTiles(Vec2 from) {
+  return getVisibility(from).getVisibleTiles();
+}
+
+void FieldOfView::unlinkEntry(int index) {
+  CacheEntry& entry = entries[index];
+  if (entry.prev > -1)
+    entries[entry.prev].next = entry.next;
+  else
+    mostRecent = entry.next;
+  if (entry.next > -1)
+    entries[entry.next].prev = entry.prev;
+  else
+    leastRecent = entry.prev;
+}
+
+void FieldOfView::linkEntryFront(int index) {
+  CacheEntry& entry = entries[index];
+  entry.prev = -1;
+  entry.next = mostRecent;
+  if (mostRecent > -1)
+    entries[mostRecent].prev = index;
+  else
+    leastRecent = index;
+  mostRecent = index;
+}
+
+void FieldOfView::removeEntry(int index) {
+  unlinkEntry(index);
+  CacheEntry& entry = entries[index];
+  memoryUsage -= entry.memoryUsage;
+  ++entry.generation;
+  cacheIndex[entry.pos] = -1;
+  freeEntries.push_back(index);
+}
+
+void FieldOfView::addViewer(Vec2 block, int index) {
+  vector<Viewer>& blockViewers = viewers[block];
+  if (blockViewers.size() == blockViewers.capacity())
+    blockViewers.erase(remove_if(blockViewers.begin(), blockViewers.end(),
+          [this](const Viewer& viewer) { return entries[viewer.index].generation != viewer.generation; }),
+        blockViewers.end());
+  blockViewers.push_back({index, entries[index].generation});
+}
+
+const FieldOfView::Visibility& FieldOfView::getVisibility(Vec2 pos) {
+  int index = cacheIndex[pos];
+  if (index > -1) {
+    Benchmark::add(BenchCounter::FOV_CACHE_HITS);
+    if (index != mostRecent) {
+      unlinkEntry(index);
+      linkEntryFront(index);
     }
+    return entries[index].visibility;
+  }
+  Benchmark::add(BenchCounter::FOV_CACHE_MISSES);
+  long long start = Benchmark::getMicros();
+  Visibility visibility(opacity, pos.x, pos.y);
+  Benchmark::addTime(BenchPhase::FIELD_OF_VIEW, Benchmark::getMicros() - start);
+  vector<Vec2> blocks = visibility.getVisibleBlocks(blockSize, squares.getWidth(), squares.getHeight());
+  long long entryMemory = visibility.getMemoryUsage() + blocks.size() * sizeof(Viewer);
+  memoryUsage += entryMemory;
+  while (memoryUsage > cacheLimit && leastRecent > -1) {
+    Benchmark::add(BenchCounter::FOV_CACHE_EVICTIONS);
+    removeEntry(leastRecent);
+  }
+  if (freeEntries.empty()) {
+    index = entries.size();
+    entries.push_back({std::move(visibility), pos, entryMemory, 0, -1, -1});
+  } else {
+    index = freeEntries.back();
+    freeEntries.pop_back();
+    entries[index].visibility = std::move(visibility);
+    entries[index].pos = pos;
+    entries[index].memoryUsage = entryMemory;
+  }
+  cacheIndex[pos] = index;
+  linkEntryFront(index);
+  for (Vec2 block : blocks)
+    addViewer(block, index);
+  return entries[index].visibility;
 }
 
-void FieldOfView::Visibility::setVisible(int x, int y) {
-  if (!visible[x + sightRange][y + sightRange] && x * x + y * y <= sightRange * sightRange) {
-    visible[x + sightRange][y + sightRange] = 1;
-    visibleTiles.push_back(Vec2(px + x, py + y));
+FieldOfView::Visibility::Visibility() : px(0), py(0) {
+  memset(visible, 0, sizeof(visible));
+}
+
+namespace {
+
+/** The shadowcasting kernel scans the rows of a single quadrant, moving away from the viewpoint. These map
+    its rows to each of the four directions.*/
+struct QuadrantDown {
+  template <class OpacityMap>
+  static uint64_t getOpaque(const OpacityMap& opacity, int px, int py, int row, int from, int count) {
+    return opacity.getRight(px + from, py + row, count);
+  }
+
+  static void setVisible(uint64_t* visible, int range, int row, int from, int to) {
+    for (int i = from; i <= to; ++i)
+      visible[range + i] |= uint64_t(1) << (range + row);
+  }
+};
+
+struct QuadrantRight {
+  template <class OpacityMap>
+  static uint64_t getOpaque(const OpacityMap& opacity, int px, int py, int row, int from, int count) {
+    return opacity.getUp(px + row, py - from, count);
   }
+
+  static void setVisible(uint64_t* visible, int range, int row, int from, int to) {
+    visible[range + row] |= ((uint64_t(1) << (to - from + 1)) - 1) << (range - to);
+  }
+};
+
+struct QuadrantUp {
+  template <class OpacityMap>
+  static uint64_t getOpaque(const OpacityMap& opacity, int px, int py, int row, int from, int count) {
+    return opacity.getLeft(px - from, py - row, count);
+  }
+
+  static void setVisible(uint64_t* visible, int range, int row, int from, int to) {
+    for (int i = from; i <= to; ++i)
+      visible[range - i] |= uint64_t(1) << (range - row);
+  }
+};
+
+struct QuadrantLeft {
+  template <class OpacityMap>
+  static uint64_t getOpaque(const OpacityMap& opacity, int px, int py, int row, int from, int count) {
+    return opacity.getDown(px - row, py + from, count);
+  }
+
+  static void setVisible(uint64_t* visible, int range, int row, int from, int to) {
+    visible[range - row] |= ((uint64_t(1) << (to - from + 1)) - 1) << (range + from);
+  }
+};
+
 }
 
-static int totalIter = 0;
-static int numSamples = 0;
-
-FieldOfView::Visibility::Visibility(const Table<PSquare>& squares, int x, int y) : px(x), py(y) {
-  memset(visible, 0, (2 * sightRange + 1) * (2 * sightRange + 1));
-  calculate(2 * sightRange, 2 * sightRange,2 * sightRange, 2,-1,1,1,1,
-      [&](int px, int py) { return !squares[x + px][y + py]->canSeeThru(); },
-      [&](int px, int py) { setVisible(px ,py); });
-  calculate(2 * sightRange, 2 * sightRange,2 * sightRange, 2,-1,1,1,1,
-      [&](int px, int py) { return !squares[x + py][y - px]->canSeeThru(); },
-      [&](int px, int py) { setVisible(py, -px); });
-  calculate(2 * sightRange, 2 * sightRange,2 * sightRange,2,-1,1,1,1,
-      [&](int px, int py) { return !squares[x - px][y - py]->canSeeThru(); },
-      [&](int px, int py) { setVisible(-px, -py); });
-  calculate(2 * sightRange, 2 * sightRange,2 * sightRange,2,-1,1,1,1,
-      [&](int px, int py) { return !squares[x - py][y + px]->canSeeThru(); },
-      [&](int px, int py) { setVisible(-py, px); });
-  setVisible(0, 0);
-  ++numSamples;
-  totalIter += visibleTiles.size();
-  if (numSamples%100 == 0)
-    Debug() << numSamples << " iterations " << totalIter / numSamples << " avg";
-}
-
-const vector<Vec2>& FieldOfView::Visibility::getVisibleTiles() const {
-  return visibleTiles;
-}
-
-const vector<Vec2>& FieldOfView::getVisibleTiles(Vec2 from) {
-  if (!visibility[from]) {
-    visibility[from] = Visibility(squares, from.x, from.y);
+/** Returns the squares within range of the center, in the same layout as Visibility::visible.*/
+static vector<uint64_t> getCircleMasks(int range) {
+  vector<uint64_t> ret(2 * range + 1);
+  for (int x = -range; x <= range; ++x)
+    for (int y = -range; y <= range; ++y)
+      if (x * x + y * y <= range * range)
+        ret[x + range] |= uint64_t(1) << (y + range);
+  return ret;
+}
+
+FieldOfView::Visibility::Visibility(const OpacityMap& opacity, int x, int y) : px(x), py(y) {
+  memset(visible, 0, sizeof(visible));
+  calculate<QuadrantDown>(opacity, 2, -1, 1, 1, 1);
+  calculate<QuadrantRight>(opacity, 2, -1, 1, 1, 1);
+  calculate<QuadrantUp>(opacity, 2, -1, 1, 1, 1);
+  calculate<QuadrantLeft>(opacity, 2, -1, 1, 1, 1);
+  visible[sightRange] |= uint64_t(1) << sightRange;
+  static const vector<uint64_t> circle = getCircleMasks(sightRange);
+  for (int i = 0; i < 2 * sightRange + 1; ++i)
+    visible[i] &= circle[i];
+}
+
+vector<Vec2> FieldOfView::Visibility::getVisibleTiles() const {
+  vector<Vec2> ret;
+  for (int i = 0; i < 2 * sightRange + 1; ++i)
+    for (uint64_t bits = visible[i]; bits; bits &= bits - 1)
+      ret.push_back(Vec2(px + i - sightRange, py + __builtin_ctzll(bits) - sightRange));
+  return ret;
+}
+
+vector<Vec2> FieldOfView::Visibility::getVisibleBlocks(int blockSize, int width, int height) const {
+  vector<Vec2> ret;
+  // Bit i of a column mask is square py + i - sightRange, so this keeps the rows inside the level.
+  uint64_t rowMask = ~uint64_t(0);
+  if (py - sightRange < 0)
+    rowMask &= ~uint64_t(0) << (sightRange - py);
+  if (height - py + sightRange < 64)
+    rowMask &= (uint64_t(1) << (height - py + sightRange)) - 1;
+  int minX = max(0, px - sightRange);
+  int maxX = min(width - 1, px + sightRange);
+  for (int blockX = minX / blockSize; blockX <= maxX / blockSize; ++blockX) {
+    uint64_t columns = 0;
+    for (int x = max(minX, blockX * blockSize); x <= min(maxX, blockX * blockSize + blockSize - 1); ++x)
+      columns |= visible[x - px + sightRange];
+    columns &= rowMask;
+    while (columns) {
+      int blockY = (py + __builtin_ctzll(columns) - sightRange) / blockSize;
+      ret.push_back(Vec2(blockX, blockY));
+      int last = (blockY + 1) * blockSize - py + sightRange;
+      columns = last < 64 ? columns & (~uint64_t(0) << last) : 0;
+    }
   }
-  return visibility[from]->getVisibleTiles();
+  return ret;
 }
 
+long long FieldOfView::Visibility::getMemoryUsage() const {
+  return sizeof(CacheEntry);
+}
+
+/** Returns r such that (n * r[b]) >> 32 == n / b for 0 <= n < 2^16 and 0 < b < 64, which covers all
+    slopes in the kernel.*/
+static vector<uint64_t> getReciprocals() {
+  vector<uint64_t> ret(64);
+  for (int b = 1; b < 64; ++b)
+    ret[b] = (uint64_t(1) << 32) / b + 1;
+  return ret;
+}
+
+static const vector<uint64_t> reciprocals = getReciprocals();
+
+/** Returns floor(double(a) / b * c) without a division. When the exact result is whole the floating point
+    expression can be off by one, so it's evaluated in that case to keep the same visibility, unless a / b is
+    whole too.*/
+static int floorScaled(int a, int b, int c) {
+  int num = a * c;
+  int quotient = (abs(num) * reciprocals[b]) >> 32;
+  if (quotient * b != abs(num))
+    return num < 0 ? -quotient - 1 : quotient;
+  int ret = num < 0 ? -quotient : quotient;
+  return (b == 1 || a == b || a == -b || (double) a / b * c >= ret) ? ret : ret - 1;
+}
+
+/** Returns ceil(double(a) / b * c), see floorScaled.*/
+static int ceilScaled(int a, int b, int c) {
+  int num = a * c;
+  int quotient = (abs(num) * reciprocals[b]) >> 32;
+  if (quotient * b != abs(num))
+    return num < 0 ? -quotient : quotient + 1;
+  int ret = num < 0 ? -quotient : quotient;
+  return (b == 1 || a == b || a == -b || (double) a / b * c <= ret) ? ret : ret + 1;
+}
 
-void FieldOfView::Visibility::calculate(int left, int right, int up, int h, int x1, int y1, int x2, int y2,
-    function<bool (int, int)> isBlocking, function<void (int, int)> setVisible){
+template <class Quadrant>
+void FieldOfView::Visibility::calculate(const OpacityMap& opacity, int h, int x1, int y1, int x2, int y2) {
+  const int range = 2 * sightRange;
   if (y2*x1>=y1*x2) return;
-  if (h>up) return;
+  if (h>range) return;
   int leftx=x1, lefty=y1, rightx=x2, righty=y2;
-  int left_v=(int)floor((double)x1/y1*(h)), 
-      right_v=(int)ceil((double)x2/y2*(h)),
-      left_b=(int)floor((double)x1/y1*(h-1)),
-      right_b=(int)ceil((double)x2/y2*(h+1));
+  int left_v=floorScaled(x1, y1, h),
+      right_v=ceilScaled(x2, y2, h),
+      left_b=floorScaled(x1, y1, h-1);
   if (left_v % 2)
     ++left_v;
   if (right_v % 2)
     --right_v;
   if(left_b % 2)
     ++left_b;
-  if(right_b % 2)
-    --right_b;
 
-  if(left_b>=-left && left_b<=right && isBlocking(left_b/2,h/2)){
+  int row = h / 2;
+  if(left_b>=-range && left_b<=range && Quadrant::getOpaque(opacity, px, py, row, left_b/2, 1)){
     leftx=left_b+1;
     lefty=h+(left_b>=0?-1:1);
   }
-  if(left_v<-left) left_v=-left;
-  if(right_v>right) right_v=right;
-  bool prevBlocking = false;
-  for (int i=left_v/2;i<=right_v/2;++i){
-    setVisible(i, h / 2);
-    bool blocking = isBlocking(i, h / 2);
-    if(i > left_v / 2 && blocking && !prevBlocking)
-      calculate(left, right, up, h + 2, leftx, lefty, i * 2 - 1, h + (i<=0 ? -1:1), isBlocking, setVisible);
-    if(blocking){
-      leftx=i*2+1;
-      lefty=h+(i>=0?-1:1);
+  if(left_v<-range) left_v=-range;
+  if(right_v>range) right_v=range;
+  int from = left_v / 2;
+  int to = right_v / 2;
+  if (from <= to) {
+    Quadrant::setVisible(visible, sightRange, row, from, to);
+    // The view left of each run of blocking squares continues separately in the next row.
+    uint64_t blocking = Quadrant::getOpaque(opacity, px, py, row, from, to - from + 1);
+    while (blocking) {
+      int start = __builtin_ctzll(blocking);
+      if (start > 0)
+        calculate<Quadrant>(opacity, h + 2, leftx, lefty, (from + start) * 2 - 1,
+            h + (from + start <= 0 ? -1 : 1));
+      int end = start + __builtin_ctzll(~(blocking >> start)) - 1;
+      leftx = (from + end) * 2 + 1;
+      lefty = h + (from + end >= 0 ? -1 : 1);
+      blocking &= ~uint64_t(0) << (end + 1);
     }
-    prevBlocking = blocking;
   }
-  calculate(left, right, up, h + 2, leftx, lefty, rightx, righty, isBlocking, setVisible);
+  calculate<Quadrant>(opacity, h + 2, leftx, lefty, rightx, righty);
 }
 
 bool FieldOfView::Visibility::checkVisible(int x, int y) const {
   return x >= -sightRange && y >= -sightRange && x <= sightRange && y <= sightRange && 
-    visible[sightRange + x][sightRange + y] == 1;
+    (visible[sightRange + x] >> (sightRange + y)) & 1;
 }
 
 
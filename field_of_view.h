@@ -8,35 +8,114 @@ class FieldOfView {
   public:
   FieldOfView(const Table<PSquare>& squares);
   bool canSee(Vec2 from, Vec2 to);
-  const vector<Vec2>& getVisibleTiles(Vec2 from);
+  vector<Vec2> getVisibleTiles(Vec2 from);
   void squareChanged(Vec2 pos);
 
+  /** Sets the maximum number of bytes used by the visibility cache of a single level. The least recently
+      used visibilities are dropped when the limit is exceeded.*/
+  static void setCacheLimit(long long bytes);
+
   private:
 
   const static int sightRange = 30;
 
+  /** Packed bitmaps of the squares that block vision, kept in all four scan directions so that a row of any
+      quadrant is a run of adjacent bits. The level is padded by sightRange blocking squares on every side,
+      so lookups from any viewpoint need no bounds checks.*/
+  class OpacityMap {
+    public:
+    OpacityMap(const Table<PSquare>& squares);
+    void update(const Table<PSquare>& squares, Vec2 pos);
+
+    /** Each of these returns the opacity of count <= 64 squares starting at (x, y), nearest first in the
+        lowest bit.*/
+    uint64_t getRight(int x, int y, int count) const;
+    uint64_t getLeft(int x, int y, int count) const;
+    uint64_t getDown(int x, int y, int count) const;
+    uint64_t getUp(int x, int y, int count) const;
+
+    private:
+    class Lines {
+      public:
+      Lines(int numLines, int length);
+      void set(int line, int pos, bool value);
+      uint64_t get(int line, int pos, int count) const;
+
+      private:
+      int wordsPerLine;
+      vector<uint64_t> bits;
+    };
+
+    int width;
+    int height;
+    Lines rows;
+    Lines rowsReversed;
+    Lines columns;
+    Lines columnsReversed;
+  };
+
   class Visibility {
-    char visible[sightRange * 2 + 1][sightRange * 2 + 1];
-    vector<Vec2> visibleTiles;
-    void calculate(int,int,int,int, int, int, int, int,
-        function<bool (int, int)> isBlocking,
-        function<void (int, int)> setVisible);
-    void setVisible(int, int);
+    // Bit y + sightRange of visible[x + sightRange] is set if (x, y) relative to the viewpoint is visible.
+    uint64_t visible[sightRange * 2 + 1];
+    template <class Quadrant>
+    void calculate(const OpacityMap& opacity, int h, int x1, int y1, int x2, int y2);
 
     int px, py;
 
     public:
 
     bool checkVisible(int x,int y) const;
-    const vector<Vec2>& getVisibleTiles() const;
+    vector<Vec2> getVisibleTiles() const;
 
-    Visibility(const Table<PSquare>& squares, int x, int y);
+    /** Returns the blocks of blockSize x blockSize squares that contain a visible square within the level
+        of the given size.*/
+    vector<Vec2> getVisibleBlocks(int blockSize, int width, int height) const;
+    long long getMemoryUsage() const;
+
+    Visibility(const OpacityMap& opacity, int x, int y);
+    Visibility();
     Visibility(Visibility&&) = default;
     Visibility& operator = (Visibility&&) = default;
   };
 
+  const Visibility& getVisibility(Vec2 pos);
+  void removeEntry(int index);
+  void unlinkEntry(int index);
+  void linkEntryFront(int index);
+  void addViewer(Vec2 block, int index);
+
+  struct CacheEntry {
+    Visibility visibility;
+    Vec2 pos;
+    long long memoryUsage;
+    // Incremented whenever the entry is removed, which invalidates its viewer records.
+    int generation;
+    // Links in the LRU list, most recently used first.
+    int prev;
+    int next;
+  };
+
+  /** A cached visibility that sees some square of a block. The record is stale if the entry was removed
+      since.*/
+  struct Viewer {
+    int index;
+    int generation;
+  };
+
+  const static int blockSize = 8;
+
   const Table<PSquare>& squares;
-  Table<Optional<Visibility>> visibility;
+  OpacityMap opacity;
+  Table<int> cacheIndex;
+  /** Reverse visibility index, so a changed square only checks the cached visibilities that can see its
+      block. Stale records are dropped lazily.*/
+  Table<vector<Viewer>> viewers;
+  vector<CacheEntry> entries;
+  vector<int> freeEntries;
+  int mostRecent = -1;
+  int leastRecent = -1;
+  long long memoryUsage = 0;
+  static long long cacheLimit;
 };
 
 #endif
@@ -0,0 +1,65 @@
+#include "stdafx.h"
+
+#include "flow_field.h"
+#include "shortest_path.h"
+
+using namespace std;
+
+static const vector<Vec2> directions = Vec2::directions8();
+
+FlowField::FlowField(Rectangle bounds, function<double(Vec2)> fun, Vec2 t) : target(t), entryFun(fun),
+    cost(bounds, -1), distance(bounds, ShortestPath::infinity), done(bounds, false) {
+  cost[target] = 1;
+  distance[target] = 0;
+  queue.push({0, target});
+}
+
+Vec2 FlowField::getTarget() const {
+  return target;
+}
+
+double FlowField::getCost(Vec2 pos) {
+  if (cost[pos] < 0)
+    cost[pos] = entryFun(pos);
+  return cost[pos];
+}
+
+void FlowField::expandTo(Vec2 pos) {
+  while (!done[pos] && !queue.empty()) {
+    pair<double, Vec2> elem = queue.top();
+    queue.pop();
+    Vec2 v = elem.second;
+    if (done[v])
+      continue;
+    done[v] = true;
+    // The field is searched from the target, so the step from next to v costs entering v. Blocked squares
+    // stay at infinity, so no creature is ever sent into them.
+    for (Vec2 dir : directions) {
+      Vec2 next = v + dir;
+      if (next.inRectangle(distance.getBounds()) && !done[next] && getCost(next) < ShortestPath::infinity
+          && distance[v] + cost[v] < distance[next]) {
+        distance[next] = distance[v] + cost[v];
+        queue.push({distance[next], next});
+      }
+    }
+  }
+}
+
+double FlowField::getDistance(Vec2 pos) {
+  expandTo(pos);
+  return distance[pos];
+}
+
+vector<Vec2> FlowField::getMoves(Vec2 pos) {
+  expandTo(pos);
+  // All squares closer than pos are already done.
+  vector<pair<double, Vec2>> moves;
+  for (Vec2 dir : directions)
+    if ((pos + dir).inRectangle(distance.getBounds()) && distance[pos + dir] < distance[pos])
+      moves.push_back({cost[pos + dir] + distance[pos + dir], dir});
+  sort(moves.begin(), moves.end());
+  vector<Vec2> ret;
+  for (auto& elem : moves)
+    ret.push_back(elem.second);
+  return ret;
+}
@@ -0,0 +1,32 @@
+#ifndef _FLOW_FIELD_H
+#define _FLOW_FIELD_H
+
+#include "util.h"
+
+/** Distances to a single target from the squares of an area. Creatures heading to the same target share one
+    field and each of them picks its own step. The search from the target is resumed only as far as the
+    squares that are asked about, so a field used by a single nearby creature stays cheap.*/
+class FlowField {
+  public:
+  /** The entry function returns the cost of entering a square, or ShortestPath::infinity if it's blocked.*/
+  FlowField(Rectangle bounds, function<double(Vec2)> entryFun, Vec2 target);
+
+  Vec2 getTarget() const;
+  double getDistance(Vec2 pos);
+
+  /** Returns the directions from the square to its neighbours that are closer to the target, best first.*/
+  vector<Vec2> getMoves(Vec2 pos);
+
+  private:
+  void expandTo(Vec2 pos);
+  double getCost(Vec2 pos);
+
+  Vec2 target;
+  function<double(Vec2)> entryFun;
+  Table<double> cost;
+  Table<double> distance;
+  Table<bool> done;
+  std::priority_queue<pair<double, Vec2>, vector<pair<double, Vec2>>, std::greater<pair<double, Vec2>>> queue;
+};
+
+#endif
@@ -150,10 +150,10 @@ class Corpse : public Item {
       viewObject = object2;
       corpseInfo.isSkeleton = true;
     } else if (getWeight() > 10 && !corpseInfo.isSkeleton && 
-        !level->getSquare(position)->isCovered() && Random.roll(35)) {
-      for (Vec2 v : position.neighbors8(true))
+        !level->getSquare(position)->isCovered() && level->getRandom().roll(35)) {
+      for (Vec2 v : position.neighbors8(level->getRandom()))
         if (level->inBounds(v)) {
-          PCreature vulture = CreatureFactory::fromId(
+          PCreature vulture = CreatureFactory::fromId(level->getRandom(),
               CreatureId::VULTURE, Tribe::pest, MonsterAIFactory::scavengerBird(v));
           if (level->getSquare(v)->canEnter(vulture.get())) {
             level->addCreature(v, std::move(vulture));
@@ -178,8 +178,8 @@ class Corpse : public Item {
   CorpseInfo corpseInfo;
 };
 
-PItem ItemFactory::corpse(CreatureId id, ItemType type, Item::CorpseInfo corpseInfo) {
-  PCreature c = CreatureFactory::fromId(id, Tribe::monster);
+PItem ItemFactory::corpse(RandomGen& random, CreatureId id, ItemType type, Item::CorpseInfo corpseInfo) {
+  PCreature c = CreatureFactory::fromId(random, id, Tribe::monster);
   return corpse(c->getName() + " corpse", c->getName() + " skeleton", c->getWeight(), type, corpseInfo);
 }
 
@@ -277,11 +277,11 @@ ItemFactory& ItemFactory::addUniqueItem(ItemId id) {
   return *this;
 }
 
-vector<PItem> ItemFactory::random(Optional<int> seed) {
+vector<PItem> ItemFactory::random(RandomGen& random, Optional<int> seed) {
   if (unique.size() > 0) {
     ItemId id = unique.back();
     unique.pop_back();
-    return fromId(id, 1);
+    return fromId(random, id, 1);
   }
   int index;
   if (seed) {
@@ -289,16 +289,16 @@ vector<PItem> ItemFactory::random(Optional<int> seed) {
     gen.init(*seed);
     index = gen.getRandom(weights);
   } else
-    index = Random.getRandom(weights);
-  return fromId(items[index], Random.getRandom(minCount[index], maxCount[index]));
+    index = random.getRandom(weights);
+  return fromId(random, items[index], random.getRandom(minCount[index], maxCount[index]));
 }
 
-vector<PItem> ItemFactory::getAll() {
+vector<PItem> ItemFactory::getAll(RandomGen& random) {
   vector<PItem> ret;
   for (ItemId id : unique)
-    ret.push_back(fromId(id));
+    ret.push_back(fromId(random, id));
   for (ItemId id : items)
-    ret.push_back(fromId(id));
+    ret.push_back(fromId(random, id));
   return ret;
 }
 
@@ -468,11 +468,11 @@ ItemFactory ItemFactory::singleType(ItemId id) {
   return ItemFactory({{id, 1}});
 }
 
-void ItemFactory::init() {
+void ItemFactory::init(RandomGen& random) {
   for (int i : Range(100))
     scroll_looks.push_back(toUpper(NameGenerator::scrolls.getNext()));
-  random_shuffle(potion_looks.begin(), potion_looks.end(),[](int a) { return Random.getRandom(a);});
-  random_shuffle(amulet_looks.begin(), amulet_looks.end(),[](int a) { return Random.getRandom(a);});
+  potion_looks = random.permutation(potion_looks);
+  amulet_looks = random.permutation(amulet_looks);
 }
 
 PItem getPotion(int numLooks, string name, EffectType effect, int price, string description) {
@@ -526,9 +526,9 @@ PItem getMushroom(string name, EffectType effect, string description) {
             i.uses = 1;)));
 }
 
-static int maybePlusMinusOne(int prob) {
-  if (Random.roll(prob))
-    return Random.getRandom(2) * 2 - 1;
+static int maybePlusMinusOne(RandomGen& random, int prob) {
+  if (random.roll(prob))
+    return random.getRandom(2) * 2 - 1;
   return 0;
 }
 
@@ -537,7 +537,7 @@ vector<pair<string, vector<string>>> badArtifactNames {
   {"battle axe", {"crush", "tooth", "razor", "fist", "bite", "bolt", "sword"}},
   {"war hammer", {"blade", "tooth", "bite", "bolt", "sword", "steel"}}};
 
-void makeArtifact(ItemAttributes& i) {
+void makeArtifact(RandomGen& random, ItemAttributes& i) {
   bool good;
   do {
     good = true;
@@ -550,13 +550,13 @@ void makeArtifact(ItemAttributes& i) {
         }
   } while (!good);
   Debug() << "Making artifact " << *i.name << " " << *i.artifactName;
-  i.damage += Random.getRandom(1, 4);
-  i.toHit += Random.getRandom(1, 4);
+  i.damage += random.getRandom(1, 4);
+  i.toHit += random.getRandom(1, 4);
   i.name = "antique " + *i.name;
   i.price *= 15;
 }
 
-PItem ItemFactory::fromId(ItemId id) {
+PItem ItemFactory::fromId(RandomGen& random, ItemId id) {
   bool artifact = false;
   switch (id) {
     case ItemId::KNIFE: return PItem(new Item(
@@ -565,8 +565,8 @@ PItem ItemFactory::fromId(ItemId id) {
             i.plural = "knives";
             i.type = ItemType::WEAPON;
             i.weight = 0.3;
-            i.damage = 5 + maybePlusMinusOne(4);
-            i.toHit = maybePlusMinusOne(4);
+            i.damage = 5 + maybePlusMinusOne(random, 4);
+            i.toHit = maybePlusMinusOne(random, 4);
             i.attackTime = 0.7;
             i.thrownDamage = 3;
             i.thrownToHit = 3;
@@ -578,11 +578,11 @@ PItem ItemFactory::fromId(ItemId id) {
             i.name = "sword";
             i.type = ItemType::WEAPON;
             i.weight = 1.5;
-            i.damage = 8 + maybePlusMinusOne(4);
-            i.toHit = 3 + maybePlusMinusOne(4);
+            i.damage = 8 + maybePlusMinusOne(random, 4);
+            i.toHit = 3 + maybePlusMinusOne(random, 4);
             i.price = 20;
             if (artifact) {
-              makeArtifact(i);
+              makeArtifact(random, i);
             }
             i.attackType = AttackType::CUT;)));
     case ItemId::SPECIAL_ELVEN_SWORD: artifact = true;
@@ -591,11 +591,11 @@ PItem ItemFactory::fromId(ItemId id) {
             i.name = "elven sword";
             i.type = ItemType::WEAPON;
             i.weight = 1;
-            i.damage = 9 + maybePlusMinusOne(4);
-            i.toHit = 5 + maybePlusMinusOne(4);
+            i.damage = 9 + maybePlusMinusOne(random, 4);
+            i.toHit = 5 + maybePlusMinusOne(random, 4);
             i.price = 120;
             if (artifact) {
-              makeArtifact(i);
+              makeArtifact(random, i);
             }
             i.attackType = AttackType::CUT;)));
     case ItemId::SPECIAL_BATTLE_AXE: artifact = true;
@@ -604,13 +604,13 @@ PItem ItemFactory::fromId(ItemId id) {
             i.name = "battle axe";
             i.type = ItemType::WEAPON;
             i.weight = 8;
-            i.damage = 14 + maybePlusMinusOne(4);
-            i.toHit = 0 + maybePlusMinusOne(4);
+            i.damage = 14 + maybePlusMinusOne(random, 4);
+            i.toHit = 0 + maybePlusMinusOne(random, 4);
             i.attackTime = 1.2;
             i.twoHanded = true;
             i.price = 140;
             if (artifact) {
-              makeArtifact(i);
+              makeArtifact(random, i);
             }
             i.attackType = AttackType::CUT;)));
     case ItemId::SPECIAL_WAR_HAMMER: artifact = true;
@@ -619,13 +619,13 @@ PItem ItemFactory::fromId(ItemId id) {
             i.name = "war hammer";
             i.type = ItemType::WEAPON;
             i.weight = 8;
-            i.damage = 12 + maybePlusMinusOne(4);
-            i.toHit = 0 + maybePlusMinusOne(4);
+            i.damage = 12 + maybePlusMinusOne(random, 4);
+            i.toHit = 0 + maybePlusMinusOne(random, 4);
             i.attackTime = 1.2;
             i.twoHanded = true;
             i.price = 100;
             if (artifact) {
-              makeArtifact(i);
+              makeArtifact(random, i);
             }
             i.attackType = AttackType::CRUSH;)));
     case ItemId::SCYTHE: return PItem(new Item(
@@ -633,8 +633,8 @@ PItem ItemFactory::fromId(ItemId id) {
             i.name = "scythe";
             i.type = ItemType::WEAPON;
             i.weight = 5;
-            i.damage = 12 + maybePlusMinusOne(4);
-            i.toHit = 0 + maybePlusMinusOne(4);
+            i.damage = 12 + maybePlusMinusOne(random, 4);
+            i.toHit = 0 + maybePlusMinusOne(random, 4);
             i.attackTime = 1;
             i.twoHanded = true;
             i.price = 100;
@@ -644,7 +644,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.name = "short bow";
             i.type = ItemType::RANGED_WEAPON;
             i.weight = 1;
-            i.rangedWeaponAccuracy = 10 + maybePlusMinusOne(4);
+            i.rangedWeaponAccuracy = 10 + maybePlusMinusOne(random, 4);
             i.price = 60;)));
     case ItemId::ARROW: return PItem(new Item(
         ViewObject(ViewId::ARROW, ViewLayer::ITEM, "Arrow"), ITATTR(
@@ -661,7 +661,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.weight = 7;
             i.armorType = ArmorType::BODY_ARMOR;
             i.price = 20;
-            i.defense = 3 + maybePlusMinusOne(4);)));
+            i.defense = 3 + maybePlusMinusOne(random, 4);)));
     case ItemId::LEATHER_HELM: return PItem(new Item(
         ViewObject(ViewId::LEATHER_HELM, ViewLayer::ITEM, "Helmet"), ITATTR(
             i.name = "leather helm";
@@ -669,7 +669,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.weight = 1.5;
             i.armorType = ArmorType::HELMET;
             i.price = 5;
-            i.defense = 1 + maybePlusMinusOne(4);)));
+            i.defense = 1 + maybePlusMinusOne(random, 4);)));
     case ItemId::CHAIN_ARMOR: return PItem(new Item(
         ViewObject(ViewId::CHAIN_ARMOR, ViewLayer::ITEM, "Armor"), ITATTR(
             i.name = "chain armor";
@@ -677,7 +677,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.weight = 15;
             i.armorType = ArmorType::BODY_ARMOR;
             i.price = 130;
-            i.defense = 5 + maybePlusMinusOne(4);)));
+            i.defense = 5 + maybePlusMinusOne(random, 4);)));
     case ItemId::IRON_HELM: return PItem(new Item(
         ViewObject(ViewId::IRON_HELM, ViewLayer::ITEM, "Helmet"), ITATTR(
             i.name = "iron helm";
@@ -685,7 +685,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.weight = 4;
             i.armorType = ArmorType::HELMET;
             i.price = 40;
-            i.defense= 2 + maybePlusMinusOne(4);)));
+            i.defense= 2 + maybePlusMinusOne(random, 4);)));
     case ItemId::TELEPATHY_HELM: return PItem(new ItemOfCreatureVision(
         ViewObject(ViewId::TELEPATHY_HELM, ViewLayer::ITEM, "Helmet"), ITATTR(
             i.name = "helm of telepathy";
@@ -693,7 +693,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.weight = 1.5;
             i.armorType = ArmorType::HELMET;
             i.price = 340;
-            i.defense= 1 + maybePlusMinusOne(4);),
+            i.defense= 1 + maybePlusMinusOne(random, 4);),
                 [](const Creature* c1, const Creature* c2) {
                   return c1->getPosition().dist8(c2->getPosition()) < 5;
                 }));
@@ -704,7 +704,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.weight = 2;
             i.armorType = ArmorType::BOOTS;
             i.price = 10;
-            i.defense = 1 + maybePlusMinusOne(4);)));
+            i.defense = 1 + maybePlusMinusOne(random, 4);)));
     case ItemId::IRON_BOOTS: return PItem(new Item(
         ViewObject(ViewId::IRON_BOOTS, ViewLayer::ITEM, "Boots"), ITATTR(
             i.name = "iron boots";
@@ -712,7 +712,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.weight = 4;
             i.armorType = ArmorType::BOOTS;
             i.price = 40;
-            i.defense = 2 + maybePlusMinusOne(4);)));
+            i.defense = 2 + maybePlusMinusOne(random, 4);)));
     case ItemId::SPEED_BOOTS: return PItem(new Item(
         ViewObject(ViewId::SPEED_BOOTS, ViewLayer::ITEM, "Boots"), ITATTR(
             i.name = "boots of speed";
@@ -721,7 +721,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.armorType = ArmorType::BOOTS;
             i.price = 360;
             i.speed = 30;
-            i.defense = 1 + maybePlusMinusOne(4);)));
+            i.defense = 1 + maybePlusMinusOne(random, 4);)));
     case ItemId::WARNING_AMULET: return PItem(
         new AmuletOfWarning(ViewObject(amulet_ids[0], ViewLayer::ITEM, "Amulet"), 
           ITATTR(
@@ -751,7 +751,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.type = ItemType::AMULET;
             i.price = 300;
             i.identifiable = true;
-            i.defense = 5 + maybePlusMinusOne(4); 
+            i.defense = 5 + maybePlusMinusOne(random, 4); 
             i.weight = 0.3;)));
     case ItemId::FRIENDLY_ANIMALS_AMULET: return PItem(
         new AmuletOfEnemyCheck(ViewObject(amulet_ids[3], ViewLayer::ITEM, "Amulet"), 
@@ -769,7 +769,7 @@ PItem ItemFactory::fromId(ItemId id) {
             i.weight = 0.5;
             i.type = ItemType::TOOL;
             i.applyTime = 3;
-            i.uses = Random.getRandom(3, 6);
+            i.uses = random.getRandom(3, 6);
             i.usedUpMsg = true;
             i.displayUses = true;
             i.price = 10;
@@ -825,7 +825,7 @@ PItem ItemFactory::fromId(ItemId id) {
                                     return getScroll("rium propositum", EffectType::IDENTIFY, 15,
                                         "Identifies a hidden or magical use of a chosen item.");
                                   else
-                                    return fromId(chooseRandom({ItemId::ENHANCE_W_SCROLL, ItemId::ENHANCE_A_SCROLL}));
+                                    return fromId(random, random.choose({ItemId::ENHANCE_W_SCROLL, ItemId::ENHANCE_A_SCROLL}));
     case ItemId::BOULDER_SCROLL: return getScroll("rolling boulder", EffectType::ROLLING_BOULDER, 100, "");
     case ItemId::POISON_GAS_SCROLL: return getScroll("poison gas", EffectType::EMIT_POISON_GAS, 100, "");
     case ItemId::DESTROY_EQ_SCROLL: return getScroll("destruction", EffectType::DESTROY_EQUIPMENT, 100,
@@ -904,9 +904,9 @@ PItem ItemFactory::fromId(ItemId id) {
   return PItem(nullptr);
 }
   
-vector<PItem> ItemFactory::fromId(ItemId id, int num) {
+vector<PItem> ItemFactory::fromId(RandomGen& random, ItemId id, int num) {
   vector<PItem> ret;
   for (int i : Range(num))
-    ret.push_back(fromId(id));
+    ret.push_back(fromId(random, id));
   return ret;
 }
@@ -14,8 +14,8 @@ class Item;
 
 class ItemFactory {
   public:
-  vector<PItem> random(Optional<int> seed = Nothing());
-  vector<PItem> getAll();
+  vector<PItem> random(RandomGen&, Optional<int> seed = Nothing());
+  vector<PItem> getAll(RandomGen&);
 
   static ItemFactory dungeon();
   static ItemFactory chest();
@@ -30,15 +30,15 @@ class ItemFactory {
   static ItemFactory workshop();
   static ItemFactory singleType(ItemId);
 
-  static PItem fromId(ItemId);
-  static vector<PItem> fromId(ItemId, int num);
+  static PItem fromId(RandomGen&, ItemId);
+  static vector<PItem> fromId(RandomGen&, ItemId, int num);
   static PItem corpse(const string& name, const string& rottenName, double weight, ItemType = ItemType::CORPSE,
       Item::CorpseInfo corpseInfo = {false, false, false});
-  static PItem corpse(CreatureId, ItemType type = ItemType::CORPSE,
+  static PItem corpse(RandomGen&, CreatureId, ItemType type = ItemType::CORPSE,
       Item::CorpseInfo corpseInfo = {false, false, false});
   static PItem trapItem(PTrigger trigger, string trapName);
 
-  static void init();
+  static void init(RandomGen&);
 
   private:
   struct ItemInfo {
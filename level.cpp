@@ -2,16 +2,20 @@
 
 #include "level.h"
 #include "location.h"
+#include "quest.h"
 #include "model.h"
 
 using namespace std;
 
 
-Level::Level(Table<PSquare> s, Model* m, vector<Location*> l, const string& message, const string& n) 
-    : squares(std::move(s)), locations(l), model(m), fieldOfView(squares), entryMessage(message), 
-    name(n), player(nullptr) {
+Level::Level(Table<PSquare> s, Model* m, vector<Location*> l, const string& message, const string& n,
+    RandomGen r) : squares(std::move(s)), locations(l), model(m), fieldOfView(squares),
+    destructibleSquares(squares.getBounds()), occupiedSquares(squares.getBounds()),
+    lastChanges(squares.getBounds(), 0), entryMessage(message), 
+    name(n), player(nullptr), random(r) {
   for (Vec2 pos : squares.getBounds()) {
     squares[pos]->setLevel(this);
+    destructibleSquares.set(pos, squares[pos]->canDestroy());
     Optional<pair<StairDirection, StairKey>> link = squares[pos]->getLandingLink();
     if (link)
       landingSquares[*link].push_back(pos);
@@ -27,8 +31,10 @@ void Level::addCreature(Vec2 position, PCreature c) {
 }
 
 void Level::putCreature(Vec2 position, Creature* c) {
+  ++occupancyChanges;
   creatures.push_back(c);
   CHECK(getSquare(position)->getCreature() == nullptr);
+  occupiedSquares.set(position, true);
   c->setLevel(this);
   c->setPosition(position);
   //getSquare(position)->putCreatureSilently(c);
@@ -58,6 +64,108 @@ void Level::replaceSquare(Vec2 pos, PSquare square) {
     squares[pos]->putCreatureSilently(c);
   }
   updateVisibility(pos);
+  markChanged(pos);
+  {
+    lock_guard<mutex> lock(flowFieldMutex);
+    flowFields.clear();
+  }
+  destructibleSquares.set(pos, squares[pos]->canDestroy());
+  {
+    lock_guard<mutex> lock(passableSquaresMutex);
+    for (auto& elem : passableSquares)
+      elem.second.set(pos, squares[pos]->canEnterEmpty(elem.first));
+  }
+  {
+    lock_guard<mutex> lock(regionMapMutex);
+    for (auto& elem : regionMaps)
+      elem.second->squareChanged(pos);
+  }
+  lock_guard<mutex> lock(clusterGraphMutex);
+  for (auto& elem : clusterGraphs)
+    elem.second->squareChanged(pos);
+}
+
+const BitTable& Level::getPassableSquares(const MovementType& forcedMovement) const {
+  MovementType movement = forcedMovement.getUnforced();
+  lock_guard<mutex> lock(passableSquaresMutex);
+  auto elem = passableSquares.find(movement);
+  if (elem == passableSquares.end()) {
+    elem = passableSquares.insert(make_pair(movement, BitTable(getBounds()))).first;
+    for (Vec2 pos : getBounds())
+      elem->second.set(pos, getSquare(pos)->canEnterEmpty(movement));
+  }
+  return elem->second;
+}
+
+const BitTable& Level::getDestructibleSquares() const {
+  return destructibleSquares;
+}
+
+const BitTable& Level::getOccupiedSquares() const {
+  return occupiedSquares;
+}
+
+Optional<vector<Vec2>> Level::getClusterWaypoints(const MovementType& movement, Vec2 from, Vec2 to,
+    long long* numExpanded) const {
+  lock_guard<mutex> lock(clusterGraphMutex);
+  unique_ptr<ClusterGraph>& graph = clusterGraphs[movement.getUnforced()];
+  if (!graph) {
+    const BitTable* passable = &getPassableSquares(movement);
+    graph.reset(new ClusterGraph(getBounds(), [this, passable](Vec2 pos) {
+          if ((*passable)[pos])
+            return 1.0;
+          if (destructibleSquares[pos])
+            return 5.0;
+          return ShortestPath::infinity;}));
+  }
+  long long expandedBefore = graph->getNumExpanded();
+  Optional<vector<Vec2>> ret = graph->getWaypoints(from, to);
+  if (numExpanded)
+    *numExpanded += graph->getNumExpanded() - expandedBefore;
+  return ret;
+}
+
+bool Level::canReach(const MovementType& movement, Vec2 from, Vec2 to) const {
+  lock_guard<mutex> lock(regionMapMutex);
+  unique_ptr<RegionMap>& regions = regionMaps[movement.getUnforced()];
+  if (!regions) {
+    const BitTable* passable = &getPassableSquares(movement);
+    regions.reset(new RegionMap(getBounds(), [this, passable](Vec2 pos) {
+          return (*passable)[pos] || destructibleSquares[pos];}));
+  }
+  return regions->canReach(from, to);
+}
+
+// After creatures move, a flow field is still used for this long. Creatures step around the ones that are in
+// their way, so the field doesn't need to follow every move.
+const double flowFieldRefresh = 5;
+
+// Flow fields older than this are dropped.
+const double flowFieldLifetime = 10;
+
+std::shared_ptr<FlowField> Level::getFlowField(const MovementType& movement, Vec2 target, double time) const {
+  auto key = make_pair(movement.getUnforced(), target);
+  lock_guard<mutex> lock(flowFieldMutex);
+  auto cached = flowFields.find(key);
+  if (cached != flowFields.end()
+      && (cached->second.occupancyChanges == occupancyChanges || time < cached->second.time + flowFieldRefresh))
+    return cached->second.field;
+  for (auto it = flowFields.begin(); it != flowFields.end();)
+    if (it->second.time + flowFieldLifetime < time)
+      it = flowFields.erase(it);
+    else
+      ++it;
+  CachedFlowField& field = flowFields[key];
+  const BitTable* passable = &getPassableSquares(movement);
+  field.field.reset(new FlowField(getBounds(), [this, passable](Vec2 pos) {
+        if ((*passable)[pos] && !occupiedSquares[pos])
+          return 1.0;
+        if ((*passable)[pos] || destructibleSquares[pos])
+          return 5.0;
+        return ShortestPath::infinity;}, target));
+  field.time = time;
+  field.occupancyChanges = occupancyChanges;
+  return field.field;
 }
 
 const Creature* Level::getPlayer() const {
@@ -106,7 +214,7 @@ Vec2 Level::landCreature(vector<Vec2> landing, Creature* creature) {
     entryMessage = "";
   }
   queue<pair<Vec2, Vec2>> q;
-  for (Vec2 pos : randomPermutation(landing))
+  for (Vec2 pos : random.permutation(landing))
     q.push(make_pair(pos, pos));
   while (!q.empty()) {
     pair<Vec2, Vec2> v = q.front();
@@ -115,7 +223,7 @@ Vec2 Level::landCreature(vector<Vec2> landing, Creature* creature) {
       putCreature(v.first, creature);
       return v.second;
     } else
-      for (Vec2 next : v.first.neighbors8(true))
+      for (Vec2 next : v.first.neighbors8(random))
         if (squares[next]->canEnterEmpty(creature))
           q.push(make_pair(next, v.second));
   }
@@ -145,8 +253,10 @@ void Level::throwItem(PItem item, const Attack& attack, int maxDist, Vec2 positi
 }
 
 void Level::killCreature(Creature* creature) {
+  ++occupancyChanges;
   removeElement(creatures, creature);
   getSquare(creature->getPosition())->removeCreature();
+  occupiedSquares.set(creature->getPosition(), false);
   model->removeCreature(creature);
   if (creature->isPlayer())
     setPlayer(nullptr);
@@ -154,6 +264,19 @@ void Level::killCreature(Creature* creature) {
 
 void Level::updateVisibility(Vec2 changedSquare) {
   fieldOfView.squareChanged(changedSquare);
+  markChanged(changedSquare);
+}
+
+void Level::markChanged(Vec2 pos) {
+  lastChanges[pos] = ++numChanges;
+}
+
+int Level::getNumChanges() const {
+  return numChanges;
+}
+
+int Level::getLastChange(Vec2 pos) const {
+  return lastChanges[pos];
 }
 
 void Level::globalMessage(Vec2 position, const string& ifPlayerCanSee, const string& cannot) const {
@@ -166,17 +289,21 @@ void Level::globalMessage(Vec2 position, const string& ifPlayerCanSee, const str
 }
 
 void Level::changeLevel(StairDirection dir, StairKey key, Creature* c) {
+  ++occupancyChanges;
   Vec2 fromPosition = c->getPosition();
   removeElement(creatures, c);
   getSquare(c->getPosition())->removeCreature();
+  occupiedSquares.set(c->getPosition(), false);
   Vec2 toPosition = model->changeLevel(dir, key, c);
   EventListener::addChangeLevelEvent(c, this, fromPosition, c->getLevel(), toPosition);
 }
 
 void Level::changeLevel(Level* destination, Vec2 landing, Creature* c) {
+  ++occupancyChanges;
   Vec2 fromPosition = c->getPosition();
   removeElement(creatures, c);
   getSquare(c->getPosition())->removeCreature();
+  occupiedSquares.set(c->getPosition(), false);
   model->changeLevel(destination, landing, c);
   EventListener::addChangeLevelEvent(c, this, fromPosition, destination, landing);
 }
@@ -215,10 +342,13 @@ bool Level::canMoveCreature(const Creature* creature, Vec2 direction) const {
 
 void Level::moveCreature(Creature* creature, Vec2 direction) {
   CHECK(canMoveCreature(creature, direction));
+  ++occupancyChanges;
   Vec2 position = creature->getPosition();
   Square* nextSquare = getSquare(position + direction);
   Square* thisSquare = getSquare(position);
   thisSquare->removeCreature();
+  occupiedSquares.set(position, false);
+  occupiedSquares.set(position + direction, true);
   creature->setPosition(position + direction);
   nextSquare->putCreature(creature);
   notifyLocations(creature);
@@ -278,21 +408,35 @@ vector<Square*> Level::getTickingSquares() const {
   return tickingSquares;
 }
 
-Level::Builder::Builder(int width, int height, const string& n) : squares(width, height), heightMap(width, height),
-    fog(width, height, 0), attrib(width, height), type(width, height, SquareType(0)), name(n) {
+Level::Builder::Builder(int width, int height, const string& n, RandomGen r) : squares(width, height),
+    heightMap(width, height, 0), fog(width, height, 0), covered(Rectangle(width, height)), attrib(width, height, 0),
+    type(width, height, SquareType(0)), name(n), random(r) {
+}
+
+Level::Builder::AttribSet Level::Builder::attribBit(SquareAttrib attr) {
+  static_assert(int(SquareAttrib::FOG) < 8 * sizeof(AttribSet), "Too many square attributes for AttribSet");
+  return AttribSet(1) << int(attr);
+}
+
+RandomGen& Level::Builder::getRandom() {
+  return random;
+}
+
+void Level::Builder::setCancelFlag(const std::atomic<bool>* flag) {
+  cancelled = flag;
 }
 
 bool Level::Builder::hasAttrib(Vec2 pos, SquareAttrib attr) {
   CHECK(squares[pos] != nullptr);
-  return attrib[pos].count(attr);
+  return attrib[pos] & attribBit(attr);
 }
 
 void Level::Builder::addAttrib(Vec2 pos, SquareAttrib attr) {
-  attrib[pos].insert(attr);
+  attrib[pos] |= attribBit(attr);
 }
 
 void Level::Builder::removeAttrib(Vec2 pos, SquareAttrib attr) {
-  attrib[pos].erase(attr);
+  attrib[pos] &= ~attribBit(attr);
 }
 
 Square* Level::Builder::getSquare(Vec2 pos) {
@@ -304,30 +448,44 @@ SquareType Level::Builder::getType(Vec2 pos) {
 }
 
 void Level::Builder::putSquare(Vec2 pos, SquareType t, Optional<SquareAttrib> at) {
-  putSquare(pos, SquareFactory::get(t), t, at);
+  putSquare(pos, SquareFactory::get(random, t), t, at);
 }
 
 void Level::Builder::putSquare(Vec2 pos, SquareType t, vector<SquareAttrib> at) {
-  putSquare(pos, SquareFactory::get(t), t, at);
+  putSquare(pos, SquareFactory::get(random, t), t, at);
 }
 
 void Level::Builder::putSquare(Vec2 pos, Square* square, SquareType t, Optional<SquareAttrib> attr) {
-  putSquare(pos, square, t, attr ? vector<SquareAttrib>({*attr}) : vector<SquareAttrib>());
+  putSquare(pos, square, t, attr ? attribBit(*attr) : AttribSet(0));
 }
 
 void Level::Builder::putSquare(Vec2 pos, Square* square, SquareType t, vector<SquareAttrib> attr) {
+  AttribSet attribs = 0;
+  for (SquareAttrib at : attr)
+    attribs |= attribBit(at);
+  putSquare(pos, square, t, attribs);
+}
+
+void Level::Builder::putSquare(Vec2 pos, Square* square, SquareType t, AttribSet attribs) {
+  if (cancelled && *cancelled) {
+    delete square;
+    throw CancelledException();
+  }
   CHECK(!contains({SquareType::UP_STAIRS, SquareType::DOWN_STAIRS}, type[pos])) << "Attempted to overwrite stairs";
   square->setPosition(pos);
   if (squares[pos])
     square->setBackground(squares[pos].get());
   squares[pos].reset(std::move(square));
-  for (SquareAttrib at : attr)
-    attrib[pos].insert(at);
+  attrib[pos] |= attribs;
   type[pos] = t;
 }
 
-void Level::Builder::addLocation(Location* l) {
-  locations.push_back(l);
+void Level::Builder::addLocation(Location* l, Rectangle bounds) {
+  locations.push_back({l, bounds});
+}
+
+void Level::Builder::setQuestLocation(Quest* quest, Location* l) {
+  questLocations.push_back({quest, l});
 }
 
 void Level::Builder::setHeightMap(Vec2 pos, double h) {
@@ -343,7 +501,7 @@ double Level::Builder::getHeightMap(Vec2 pos) {
 }
 
 void Level::Builder::setCovered(Vec2 pos) {
-  covered.insert(pos);
+  covered.set(pos, true);
 }
 
 void Level::Builder::putCreature(Vec2 pos, PCreature creature) {
@@ -368,13 +526,20 @@ void Level::Builder::setMessage(const string& message) {
 PLevel Level::Builder::build(Model* m, bool surface) {
   for (Vec2 v : heightMap.getBounds()) {
     squares[v]->setHeight(heightMap[v]);
-    if (covered.count(v) || !surface) {
+    if (covered[v] || !surface) {
       Debug() << "Covered " << v;
       squares[v]->setCovered(true);
     } else
       squares[v]->setFog(fog[v]);
   }
-  PLevel l(new Level(std::move(squares), m, locations, entryMessage, name));
+  vector<Location*> allLocations;
+  for (auto& elem : locations) {
+    elem.first->setBounds(elem.second);
+    allLocations.push_back(elem.first);
+  }
+  for (auto& elem : questLocations)
+    elem.first->setLocation(elem.second);
+  PLevel l(new Level(std::move(squares), m, allLocations, entryMessage, name, random.split()));
   for (PCreature& c : creatures) {
     Vec2 pos = c->getPosition();
     l->addCreature(pos, std::move(c));
@@ -409,3 +574,7 @@ int Level::getHeight() const {
 const string& Level::getName() const {
   return name;
 }
+
+RandomGen& Level::getRandom() const {
+  return random;
+}
@@ -10,11 +10,16 @@
 #include "view.h"
 #include "field_of_view.h"
 #include "square_factory.h"
+#include "cluster_graph.h"
+#include "flow_field.h"
+#include "region_map.h"
+#include "movement_type.h"
 
 class Model;
 class Square;
 class View;
 class Player;
+class Quest;
 
 
 /** A class representing a single level of the dungeon or the overworld. All events occuring on the level are performed by this class.*/
@@ -75,6 +80,9 @@ class Level {
   /** Returns the name of the level. */
   const string& getName() const;
 
+  /** Returns the random stream of things happening on the level that don't belong to a creature.*/
+  RandomGen& getRandom() const;
+
   //@{
   /** Returns the given square. \paramname{pos} must lie within the boundaries. */
   const Square* getSquare(Vec2 pos) const;
@@ -83,6 +91,42 @@ class Level {
 
   void replaceSquare(Vec2 pos, PSquare square);
 
+  /** Returns the squares that a creature with the movement type can enter if they're empty. The bitmap is kept
+      up to date with the squares, so it may be held on to. Like all the pathfinding data of the level, it ignores
+      the forced flag of the movement type, see MovementType::getUnforced.*/
+  const BitTable& getPassableSquares(const MovementType&) const;
+
+  /** Returns the squares that can be destroyed, kept up to date like getPassableSquares.*/
+  const BitTable& getDestructibleSquares() const;
+
+  /** Returns the squares that have a creature on them, kept up to date like getPassableSquares.*/
+  const BitTable& getOccupiedSquares() const;
+
+  /** Records that something that changes how the square looks happened on it: the square was replaced, a
+      creature came or left, items were dropped or picked up, fire or gas changed, or it was opened up.*/
+  void markChanged(Vec2 pos);
+
+  /** Returns the number of changes recorded on the level so far. Views keep it to refresh only the squares
+      that changed since, see getLastChange.*/
+  int getNumChanges() const;
+
+  /** Returns the value of getNumChanges() right after the last change of the square.*/
+  int getLastChange(Vec2 pos) const;
+
+  /** Plans a path on the level's ClusterGraph for the movement type, see ClusterGraph::getWaypoints. The number
+      of squares and nodes that the search expanded is added to numExpanded if it's given.*/
+  Optional<vector<Vec2>> getClusterWaypoints(const MovementType&, Vec2 from, Vec2 to,
+      long long* numExpanded = nullptr) const;
+
+  /** Tells if a creature with the movement type could walk from one square to the other if no creatures were in
+      the way, see RegionMap::canReach.*/
+  bool canReach(const MovementType&, Vec2 from, Vec2 to) const;
+
+  /** Returns a flow field towards the target for the movement type. Fields are shared by all creatures. They
+      are recomputed after the terrain changes, and every few turns while creatures move. The returned field
+      stays valid after it's dropped from the cache.*/
+  std::shared_ptr<FlowField> getFlowField(const MovementType&, Vec2 target, double time) const;
+
   /** The given square's method Square::tick() will be called every turn. */
   void addTickingSquare(Vec2 pos);
 
@@ -136,8 +180,8 @@ class Level {
   /** Class used to initialize a level object.*/
   class Builder {
     public:
-    /** Constructs a builder with given size and name. */
-    Builder(int width, int height, const string& name);
+    /** Constructs a builder with given size and name, that makes the level from the given random stream.*/
+    Builder(int width, int height, const string& name, RandomGen);
     
     /** Move constructor.*/
     Builder(Builder&&) = default;
@@ -193,23 +237,45 @@ class Level {
     /** Adds fog to given square. The fog value is between 0 and 1.*/
     void setFog(Vec2 pos, double value);
 
-    /** Sets the location name for the given square. The name will remain if the square is changed.*/
-    void addLocation(Location*);
+    /** Adds a location with the given bounds. The bounds are set on the location when the level is built, so
+        that an attempt that is thrown away doesn't change it.*/
+    void addLocation(Location*, Rectangle bounds);
+
+    /** Gives the quest the location when the level is built, for the same reason as addLocation.*/
+    void setQuestLocation(Quest*, Location*);
 
     /** Marks given square as covered. The value will remain if square is changed.*/
     void setCovered(Vec2);
+
+    /** Returns the random stream used to make the level.*/
+    RandomGen& getRandom();
+
+    /** Thrown by putSquare when the level is no longer needed, see setCancelFlag.*/
+    struct CancelledException {};
+
+    /** Makes putSquare throw CancelledException once the flag is set. Used to stop attempts to make a level
+        that were started speculatively, see Model::buildLevels.*/
+    void setCancelFlag(const std::atomic<bool>*);
     
     private:
+    /** Attributes of a square packed into bits, one per SquareAttrib.*/
+    typedef uint16_t AttribSet;
+    static AttribSet attribBit(SquareAttrib);
+    void putSquare(Vec2, Square*, SquareType, AttribSet);
+
     Table<PSquare> squares;
-    Table<double> heightMap;
-    Table<double> fog;
-    vector<Location*> locations;
-    unordered_set<Vec2> covered;
-    Table<unordered_set<SquareAttrib>> attrib;
+    Table<float> heightMap;
+    Table<float> fog;
+    vector<pair<Location*, Rectangle>> locations;
+    vector<pair<Quest*, Location*>> questLocations;
+    BitTable covered;
+    Table<AttribSet> attrib;
     Table<SquareType> type;
     vector<PCreature> creatures;
     string entryMessage;
     string name;
+    RandomGen random;
+    const std::atomic<bool>* cancelled = nullptr;
   };
 
   typedef unique_ptr<Builder> PBuilder;
@@ -222,6 +288,24 @@ class Level {
   vector<Creature*> creatures;
   Model* model;
   mutable FieldOfView fieldOfView;
+  mutable map<MovementType, unique_ptr<ClusterGraph>> clusterGraphs;
+  mutable std::mutex clusterGraphMutex;
+  mutable map<MovementType, unique_ptr<RegionMap>> regionMaps;
+  mutable std::mutex regionMapMutex;
+  struct CachedFlowField {
+    std::shared_ptr<FlowField> field;
+    double time;
+    int occupancyChanges;
+  };
+  mutable map<pair<MovementType, Vec2>, CachedFlowField> flowFields;
+  mutable std::mutex flowFieldMutex;
+  int occupancyChanges = 0;
+  mutable map<MovementType, BitTable> passableSquares;
+  mutable std::mutex passableSquaresMutex;
+  BitTable destructibleSquares;
+  BitTable occupiedSquares;
+  Table<int> lastChanges;
+  int numChanges = 0;
   string entryMessage;
   string name;
   Creature* player;
@@ -229,7 +313,9 @@ class Level {
   Vec2 backgroundOffset;
   View* view;
   
-  Level(Table<PSquare> s, Model*, vector<Location*>, const string& message, const string& name);
+  mutable RandomGen random;
+  
+  Level(Table<PSquare> s, Model*, vector<Location*>, const string& message, const string& name, RandomGen);
 
   /** Notify relevant locations about creature position. */
   void notifyLocations(Creature*);
@@ -87,16 +87,16 @@ class RoomMaker : public LevelMaker {
     Table<int> taken(area.getKX(), area.getKY());
     for (Vec2 v : area)
       taken[v] = squareType && squareType != builder->getType(v);
-    int rooms = Random.getRandom(minRooms, maxRooms);
-    int numShop = shopMaker ? Random.getRandom(rooms) : -1;
+    int rooms = builder->getRandom().getRandom(minRooms, maxRooms);
+    int numShop = shopMaker ? builder->getRandom().getRandom(rooms) : -1;
     for (int i : Range(rooms)) {
       Vec2 p, k;
       bool good;
       int cnt = 100;
       do {
-        k = Vec2(Random.getRandom(minSize, maxSize), Random.getRandom(minSize, maxSize));
-        p = Vec2(area.getPX() + spaceBetween + Random.getRandom(area.getW() - k.x - 2 * spaceBetween),
-                 area.getPY() + spaceBetween + Random.getRandom(area.getH() - k.y - 2 * spaceBetween));
+        k = Vec2(builder->getRandom().getRandom(minSize, maxSize), builder->getRandom().getRandom(minSize, maxSize));
+        p = Vec2(area.getPX() + spaceBetween + builder->getRandom().getRandom(area.getW() - k.x - 2 * spaceBetween),
+                 area.getPY() + spaceBetween + builder->getRandom().getRandom(area.getH() - k.y - 2 * spaceBetween));
         good = true;
         for (Vec2 v : Rectangle(k.x + 2 * spaceBetween, k.y + 2 * spaceBetween))
           if (taken[p + v - Vec2(spaceBetween,spaceBetween)]) {
@@ -182,7 +182,7 @@ class Connector : public LevelMaker {
     ShortestPath path(area,
         [builder, this, &area](Vec2 pos) { return getValue(builder, pos, area); }, 
         [] (Vec2 v) { return v.length4(); },
-        Vec2::directions4(true), p1 ,p2);
+        Vec2::directions4(builder->getRandom()), p1 ,p2);
     Vec2 prev(-100, -100);
     for (Vec2 v = p2; v != p1; v = path.getNextMove(v)) {
       if (!builder->getSquare(v)->canEnter(Creature::getDefault())) {
@@ -190,7 +190,7 @@ class Connector : public LevelMaker {
         SquareType newType = SquareType(0);
         SquareType oldType = builder->getType(v);
         if (isWall(oldType) && oldType != SquareType::BLACK_WALL)
-          newType = chooseRandom({
+          newType = builder->getRandom().choose<SquareType>({
               SquareType::PATH,
               SquareType::DOOR,
               SquareType::SECRET_PASS}, doorProb);
@@ -228,11 +228,11 @@ class Connector : public LevelMaker {
     Vec2 p1, p2;
     for (int i : Range(30)) {
       do {
-        p1 = Vec2(Random.getRandom(area.getPX(), area.getKX()), Random.getRandom(area.getPY(), area.getKY()));
-      } while (!builder->getSquare(p1)->canEnter(Creature::getDefault()) && !Random.roll(dead_end));
+        p1 = area.randomVec2(builder->getRandom());
+      } while (!builder->getSquare(p1)->canEnter(Creature::getDefault()) && !builder->getRandom().roll(dead_end));
       do {
-        p2 = Vec2(Random.getRandom(area.getPX(), area.getKX()), Random.getRandom(area.getPY(), area.getKY()));
-      } while (!builder->getSquare(p2)->canEnter(Creature::getDefault()) && !Random.roll(dead_end));
+        p2 = area.randomVec2(builder->getRandom());
+      } while (!builder->getSquare(p2)->canEnter(Creature::getDefault()) && !builder->getRandom().roll(dead_end));
       connect(builder, p1, p2, area);
     }
     ShortestPath connections(area,
@@ -250,7 +250,7 @@ class Connector : public LevelMaker {
   }
   
   private:
-  initializer_list<double> doorProb;
+  vector<double> doorProb;
   double diggingCost;
 };
 
@@ -273,9 +273,9 @@ class DungeonFeatures : public LevelMaker {
     CHECK(maxTotal <= available.size()) << "Not enough available squares " << (int)available.size() 
         << " for " << maxTotal << " features.";
     for (auto iter : squareTypes) {
-      int num = Random.getRandom(iter.second.first, iter.second.second);
+      int num = builder->getRandom().getRandom(iter.second.first, iter.second.second);
       for (int i : Range(num)) {
-        int vInd = Random.getRandom(available.size());
+        int vInd = builder->getRandom().getRandom(available.size());
         builder->putSquare(available[vInd], iter.first);
         if (attr)
           builder->addAttrib(available[vInd], *attr);
@@ -296,13 +296,13 @@ class Creatures : public LevelMaker {
       cfactory(cf), minCreature(minc), maxCreature(maxc), actorFactory(actorF), squareType(type) {}
 
   virtual void make(Level::Builder* builder, Rectangle area) override {
-    int numCreature = Random.getRandom(minCreature, maxCreature);
+    int numCreature = builder->getRandom().getRandom(minCreature, maxCreature);
     Table<char> taken(area.getKX(), area.getKY());
     for (int i : Range(numCreature)) {
-      PCreature creature = cfactory.random(actorFactory);
+      PCreature creature = cfactory.random(builder->getRandom(), actorFactory);
       Vec2 pos;
       do {
-        pos = Vec2(Random.getRandom(area.getPX(), area.getKX()), Random.getRandom(area.getPY(), area.getKY()));
+        pos = area.randomVec2(builder->getRandom());
       } while (!builder->canPutCreature(pos, creature.get())
           || (squareType && builder->getType(pos) != *squareType));
       builder->putCreature(pos, std::move(creature));
@@ -324,13 +324,13 @@ class Items : public LevelMaker {
       factory(_factory), onType(_onType), minItem(minc), maxItem(maxc) {}
 
   virtual void make(Level::Builder* builder, Rectangle area) override {
-    int numItem = Random.getRandom(minItem, maxItem);
+    int numItem = builder->getRandom().getRandom(minItem, maxItem);
     for (int i : Range(numItem)) {
       Vec2 pos;
       do {
-        pos = Vec2(Random.getRandom(area.getPX(), area.getKX()), Random.getRandom(area.getPY(), area.getKY()));
+        pos = area.randomVec2(builder->getRandom());
       } while (builder->getType(pos) != onType);
-      builder->getSquare(pos)->dropItems(factory.random());
+      builder->getSquare(pos)->dropItems(factory.random(builder->getRandom()));
     }
   }
 
@@ -348,8 +348,8 @@ class River : public LevelMaker {
   virtual void make(Level::Builder* builder, Rectangle area) override {
     int wind = 5;
     int middle = (area.getPX() + area.getKX()) / 2;
-    int px = Random.getRandom(middle - wind, middle + width);
-    int kx = px + Random.getRandom(-wind, wind); // Random.getRandom(area.getPX(), area.getKX()) - width;
+    int px = builder->getRandom().getRandom(middle - wind, middle + width);
+    int kx = px + builder->getRandom().getRandom(-wind, wind); // builder->getRandom().getRandom(area.getPX(), area.getKX()) - width;
     if (kx < 0)
       kx = 0;
     if (kx >= area.getKX() - width)
@@ -363,7 +363,7 @@ class River : public LevelMaker {
         for (int i : Range(width))
           builder->putSquare(v + Vec2(i, 0), squareType, SquareAttrib::RIVER);
       px = kx;
-      kx = px + Random.getRandom(-wind, wind);
+      kx = px + builder->getRandom().getRandom(-wind, wind);
       if (kx < 0)
         kx = 0;
       if (kx >= area.getKX() - width)
@@ -408,14 +408,13 @@ class River : public LevelMaker {
   MountainRiver(int num, char w) : number(num), water(w) {}
   virtual void make(Level::Builder* builder, Rectangle area) override {
     for (int i : Range(number)) {
-      Vec2 pos(Random.getRandom(area.getPX(), area.getKX()),
-             Random.getRandom(area.getPY(), area.getKY()));
+      Vec2 pos = area.randomVec2(builder->getRandom());
       while (1) {
         builder->putSquare(pos, SquareFactory::fromSymbol(water), SquareType::RIVER);
         double h = builder->getHeightMap(pos);
         double lowest = 10000000;
         Vec2 dir;
-        for (Vec2 v : Vec2::neighbors8(true)) {
+        for (Vec2 v : Vec2::neighbors8(builder->getRandom())) {
           double d;
           if ((pos + v).inRectangle(area) && (d = builder->getHeightMap(pos + v)) < lowest && builder->getType(pos + v) != SquareType::RIVER) {
             lowest = d;
@@ -451,13 +450,13 @@ class Blob : public LevelMaker {
     int numSquares = 0;
     bool done = false;
     while (!done) {
-      Vec2 pos = squares[Random.getRandom(squares.size())];
-      for (Vec2 next : pos.neighbors4(true)) {
+      Vec2 pos = squares[builder->getRandom().getRandom(squares.size())];
+      for (Vec2 next : pos.neighbors4(builder->getRandom())) {
         if (next.inRectangle(area.minusMargin(1)) && !isInside[next]) {
           Vec2 proj = next - center;
           proj.y *= area.getW();
           proj.y /= area.getH();
-          if (Random.getDouble() <= 1. - proj.lengthD() / (area.getW() / 2)) {
+          if (builder->getRandom().getDouble() <= 1. - proj.lengthD() / (area.getW() / 2)) {
             isInside[next] = 1;
             squares.push_back(next);
             if (++numSquares >= maxSquares)
@@ -532,12 +531,12 @@ class Empty : public LevelMaker {
   Optional<SquareAttrib> attrib;
 };
 
-Vec2 LevelMaker::getRandomExit(Rectangle rect, int minCornerDist) {
+Vec2 LevelMaker::getRandomExit(RandomGen& random, Rectangle rect, int minCornerDist) {
   CHECK(rect.getW() > 2 * minCornerDist && rect.getH() > 2 * minCornerDist);
-  int w1 = Random.getRandom(2);
-  int w2 = Random.getRandom(2);
-  int d1 = Random.getRandom(minCornerDist, rect.getW() - minCornerDist);
-  int d2 = Random.getRandom(minCornerDist, rect.getH() - minCornerDist);
+  int w1 = random.getRandom(2);
+  int w2 = random.getRandom(2);
+  int d1 = random.getRandom(minCornerDist, rect.getW() - minCornerDist);
+  int d2 = random.getRandom(minCornerDist, rect.getH() - minCornerDist);
   return Vec2(
         rect.getPX() + d1 * w1 + (1 - w1) * w2 * (rect.getW() - 1),
         rect.getPY() + d2 * (1 - w1) + w1 * w2 * (rect.getH() - 1));
@@ -571,27 +570,27 @@ class Buildings : public LevelMaker {
     int spaceBetween = 1;
     int alignHeight = 0;
     if (align) {
-      alignHeight = height / 2 - 2 + Random.getRandom(5);
+      alignHeight = height / 2 - 2 + builder->getRandom().getRandom(5);
     }
     int nextw = -1;
-    int numBuildings = Random.getRandom(minBuildings, maxBuildings);
+    int numBuildings = builder->getRandom().getRandom(minBuildings, maxBuildings);
     for (int i = 0; i < numBuildings; ++i) {
       bool spaceOk = true;
       int w, h, px, py;
       int cnt = 10000;
       bool buildingRow;
       do {
-        buildingRow = Random.getRandom(2);
+        buildingRow = builder->getRandom().getRandom(2);
         spaceOk = true;
-        w = Random.getRandom(minSize, maxSize);
-        h = Random.getRandom(minSize, maxSize);
+        w = builder->getRandom().getRandom(minSize, maxSize);
+        h = builder->getRandom().getRandom(minSize, maxSize);
         if (nextw > -1 && nextw + w < area.getKX()) {
           px = nextw;
           nextw = -1;
         } else
-          px = area.getPX() + Random.getRandom(width - w - 2 * spaceBetween + 1) + spaceBetween;
+          px = area.getPX() + builder->getRandom().getRandom(width - w - 2 * spaceBetween + 1) + spaceBetween;
         if (!align)
-          py = area.getPY() + Random.getRandom(height - h - 2 * spaceBetween + 1) + spaceBetween;
+          py = area.getPY() + builder->getRandom().getRandom(height - h - 2 * spaceBetween + 1) + spaceBetween;
         else {
           py = area.getPY() + (buildingRow == 1 ? alignHeight - h - 1 : alignHeight + 2);
           if (py + h >= area.getKY() || py < area.getPY()) {
@@ -612,7 +611,7 @@ class Buildings : public LevelMaker {
         else
           break;
       }
-      if (Random.roll(1))
+      if (builder->getRandom().roll(1))
         nextw = px + w;
       for (Vec2 v : Rectangle(w + 1, h + 1)) {
         filled[Vec2(px, py) + v] = true;
@@ -623,9 +622,9 @@ class Buildings : public LevelMaker {
         builder->putSquare(Vec2(px + 1, py + 1) + v, floor, SquareAttrib::ROOM);
       }
       Vec2 doorLoc = align ? 
-          Vec2(px + Random.getRandom(1, w),
+          Vec2(px + builder->getRandom().getRandom(1, w),
                py + (buildingRow * h)) :
-          getRandomExit(Rectangle(px, py, px + w + 1, py + h + 1));
+          getRandomExit(builder->getRandom(), Rectangle(px, py, px + w + 1, py + h + 1));
       builder->putSquare(doorLoc, floor);
       builder->putSquare(doorLoc, door);
       Rectangle inside(px + 1, py + 1, px + w, py + h);
@@ -737,8 +736,8 @@ class RandomLocations : public LevelMaker {
       bool ok;
       do {
         ok = true;
-        px = area.getPX() + Random.getRandom(area.getW() - width);
-        py = area.getPY() + Random.getRandom(area.getH() - height);
+        px = area.getPX() + builder->getRandom().getRandom(area.getW() - width);
+        py = area.getPY() + builder->getRandom().getRandom(area.getH() - height);
         for (int j : Range(i))
           if ((maxDistance.count({insideMakers[j], insideMakers[i]}) && 
                 maxDistance[{insideMakers[j], insideMakers[i]}] <
@@ -815,7 +814,7 @@ class Shrine : public LevelMaker {
 
   virtual void make(Level::Builder* builder, Rectangle area) override {
     for (int i : Range(10009)) {
-      Vec2 pos = area.randomVec2();
+      Vec2 pos = area.randomVec2(builder->getRandom());
       if (!wallPredicate->apply(builder, pos))
         continue;
       int numFloor = 0;
@@ -858,7 +857,7 @@ void addAvg(int x, int y, const Table<double>& wys, double& avg, int& num) {
   } 
 }
 
-Table<double> genNoiseMap(Rectangle area, vector<int> cornerLevels, double varianceMult) {
+Table<double> genNoiseMap(RandomGen& random, Rectangle area, vector<int> cornerLevels, double varianceMult) {
   int width = 1;
   while (width < area.getW() - 1 || width < area.getH() - 1)
     width *= 2;
@@ -879,7 +878,7 @@ Table<double> genNoiseMap(Rectangle area, vector<int> cornerLevels, double varia
         Vec2 pos = pos1 * a;
         double avg = (wys[pos] + wys[pos.x + a][pos.y] + wys[pos.x][pos.y + a] + wys[pos.x + a][pos.y + a]) / 4;
         wys[pos.x + a / 2][pos.y + a / 2] =
-            avg + variance * (Random.getDouble() * 2 - 1);
+            avg + variance * (random.getDouble() * 2 - 1);
       }
     for (Vec2 pos1 : Rectangle((width - 1) / a, (width - 1) / a + 1)) {
       Vec2 pos = pos1 * a;
@@ -890,7 +889,7 @@ Table<double> genNoiseMap(Rectangle area, vector<int> cornerLevels, double varia
       addAvg(pos.x + a, pos.y, wys, avg, num);
       addAvg(pos.x + a / 2, pos.y + a / 2, wys, avg, num);
       wys[pos.x + a / 2][pos.y] =
-          avg / num + variance * (Random.getDouble() * 2 - 1);
+          avg / num + variance * (random.getDouble() * 2 - 1);
     }
     for (Vec2 pos1 : Rectangle((width - 1) / a + 1, (width - 1) / a)) {
       Vec2 pos = pos1 * a;
@@ -901,7 +900,7 @@ Table<double> genNoiseMap(Rectangle area, vector<int> cornerLevels, double varia
       addAvg(pos.x, pos.y + a , wys, avg, num);
       addAvg(pos.x + a / 2, pos.y + a / 2, wys, avg, num);
       wys[pos.x][pos.y + a / 2] =
-          avg / num + variance * (Random.getDouble() * 2 - 1);
+          avg / num + variance * (random.getDouble() * 2 - 1);
     }
     variance *= varianceMult;
   }
@@ -937,8 +936,8 @@ class Mountains : public LevelMaker {
 
 
   virtual void make(Level::Builder* builder, Rectangle area) override {
-    Table<double> wys = genNoiseMap(area, cornerLevels, varianceMult);
-    Table<double> fog = genNoiseMap(area, {0, 0, 0, 0, 0}, 0.5);
+    Table<double> wys = genNoiseMap(builder->getRandom(), area, cornerLevels, varianceMult);
+    Table<double> fog = genNoiseMap(builder->getRandom(), area, {0, 0, 0, 0, 0}, 0.5);
     for (Vec2 v : area)
       fog[v] += wys[v] / 2;
     vector<double> values = sortedValues(wys);
@@ -1014,7 +1013,7 @@ class Roads : public LevelMaker {
       ShortestPath path(area,
           [builder, this, &area](Vec2 pos) { return getValue(builder, pos); }, 
           [] (Vec2 v) { return v.length4(); },
-          Vec2::directions4(true), p1 ,p2);
+          Vec2::directions4(builder->getRandom()), p1 ,p2);
       Vec2 prev(-1, -1);
       for (Vec2 v = p2; v != p1; v = path.getNextMove(v)) {
         SquareType roadType = SquareType::ROAD;
@@ -1054,12 +1053,12 @@ class Vegetation : public LevelMaker {
       : ratio(_ratio), density(_density), types(_types), probs(_probs), onType(_onType) {}
 
   virtual void make(Level::Builder* builder, Rectangle area) override {
-    Table<double> wys = genNoiseMap(area, {0, 0, 0, 0, 0}, 0.9);
+    Table<double> wys = genNoiseMap(builder->getRandom(), area, {0, 0, 0, 0, 0}, 0.9);
     vector<double> values = sortedValues(wys);
     double cutoff = values[values.size() * ratio];
     for (Vec2 v : area)
-      if (builder->getType(v) == onType && wys[v] < cutoff && Random.getDouble() <= density)
-        builder->putSquare(v, chooseRandom(types, probs));
+      if (builder->getType(v) == onType && wys[v] < cutoff && builder->getRandom().getDouble() <= density)
+        builder->putSquare(v, builder->getRandom().choose(types, probs));
   }
 
   private:
@@ -1075,14 +1074,26 @@ class LocationMaker : public LevelMaker {
   LocationMaker(Location* l) : location(l) {}
 
   virtual void make(Level::Builder* builder, Rectangle area) override {
-    location->setBounds(area);
-    builder->addLocation(location);
+    builder->addLocation(location, area);
   }
   
   private:
   Location* location;
 };
 
+class QuestLocation : public LevelMaker {
+  public:
+  QuestLocation(Quest* q, Location* l) : quest(q), location(l) {}
+
+  virtual void make(Level::Builder* builder, Rectangle area) override {
+    builder->setQuestLocation(quest, location);
+  }
+
+  private:
+  Quest* quest;
+  Location* location;
+};
+
 class ForEachSquare : public LevelMaker {
   public:
   ForEachSquare(function<void(Level::Builder*, Vec2 pos)> f,
@@ -1125,15 +1136,15 @@ class FlockAndLeader : public LevelMaker {
   }
 
   virtual void make(Level::Builder* builder, Rectangle area) override {
-    int num = Random.getRandom(minFlock, maxFlock);
-    PCreature leader = CreatureFactory::fromId(leaderId, tribe);
-    vector<PCreature> creatures = CreatureFactory::getFlock(num, flockId, leader.get());
+    int num = builder->getRandom().getRandom(minFlock, maxFlock);
+    PCreature leader = CreatureFactory::fromId(builder->getRandom(), leaderId, tribe);
+    vector<PCreature> creatures = CreatureFactory::getFlock(builder->getRandom(), num, flockId, leader.get());
     creatures.push_back(std::move(leader));
     for (PCreature& creature : creatures) {
       Vec2 pos;
       int cnt = 100;
       do {
-        pos = area.randomVec2();
+        pos = area.randomVec2(builder->getRandom());
       } while (!builder->canPutCreature(pos, creature.get()) && --cnt > 0);
       CHECK(cnt > 0) << "Can't find square for flock";
       builder->putCreature(pos, std::move(creature));
@@ -1159,8 +1170,8 @@ class Stairs : public LevelMaker {
         pos.push_back(v);
     CHECK(pos.size() > 0) << "Couldn't find position for stairs " << area;
     SquareType type = direction == StairDirection::DOWN ? SquareType::DOWN_STAIRS : SquareType::UP_STAIRS;
-    builder->putSquare(pos[Random.getRandom(pos.size())], SquareFactory::getStairs(direction, key, stairLook),
-        type, setAttr);
+    builder->putSquare(pos[builder->getRandom().getRandom(pos.size())],
+        SquareFactory::getStairs(direction, key, stairLook), type, setAttr);
   }
 
   private:
@@ -1178,17 +1189,16 @@ class ShopMaker : public LevelMaker {
 
   virtual void make(Level::Builder* builder, Rectangle area) override {
     Location *loc = new Location();
-    builder->addLocation(loc);
-    loc->setBounds(area);
-    PCreature shopkeeper = CreatureFactory::getShopkeeper(loc, tribe);
+    builder->addLocation(loc, area);
+    PCreature shopkeeper = CreatureFactory::getShopkeeper(builder->getRandom(), loc, tribe);
     vector<Vec2> pos;
     for (Vec2 v : area)
       if (builder->getSquare(v)->canEnter(shopkeeper.get()) && builder->getType(v) == SquareType::FLOOR)
         pos.push_back(v);
-    builder->putCreature(pos[Random.getRandom(pos.size())], std::move(shopkeeper));
+    builder->putCreature(pos[builder->getRandom().getRandom(pos.size())], std::move(shopkeeper));
     for (int i : Range(numItems)) {
-      Vec2 v = pos[Random.getRandom(pos.size())];
-      builder->getSquare(v)->dropItems(factory.random());
+      Vec2 v = pos[builder->getRandom().getRandom(pos.size())];
+      builder->getSquare(v)->dropItems(factory.random(builder->getRandom()));
     }
   }
 
@@ -1204,7 +1214,7 @@ class LevelExit : public LevelMaker {
       : exitType(_exitType), attrib(_attrib), minCornerDist(_minCornerDist) {}
   
   virtual void make(Level::Builder* builder, Rectangle area) override {
-    builder->putSquare(getRandomExit(area, minCornerDist), exitType, attrib);
+    builder->putSquare(getRandomExit(builder->getRandom(), area, minCornerDist), exitType, attrib);
   }
 
   private:
@@ -1294,10 +1304,10 @@ class Circle : public LevelMaker {
     Vec2 center = area.middle();
     double r = min(area.getH(), area.getW()) / 2 - 1;
     Vec2 lastPos;
-    for (double a = 0; a < 3.1415 * 2; a += Random.getDouble() * r / 10) {
+    for (double a = 0; a < 3.1415 * 2; a += builder->getRandom().getDouble() * r / 10) {
       Vec2 pos = center + Vec2(sin(a) * r, cos(a) * r);
       if (pos != lastPos) {
-        builder->getSquare(pos)->dropItem(ItemFactory::fromId(item));
+        builder->getSquare(pos)->dropItem(ItemFactory::fromId(builder->getRandom(), item));
         lastPos = pos;
       }
     }
@@ -1341,9 +1351,8 @@ class CastleExit : public LevelMaker {
     vector<Vec2> guardPos { Vec2(1, 1), Vec2(1, -1) };
     for (Vec2 pos : guardPos) {
       Location* guard = new Location();
-      guard->setBounds(Rectangle(loc + pos, loc + pos + Vec2(1, 1)));
-      builder->addLocation(guard);
-      builder->putCreature(loc + pos, CreatureFactory::fromId(CreatureId::CASTLE_GUARD, guardTribe,
+      builder->addLocation(guard, Rectangle(loc + pos, loc + pos + Vec2(1, 1)));
+      builder->putCreature(loc + pos, CreatureFactory::fromId(builder->getRandom(), CreatureId::CASTLE_GUARD, guardTribe,
             MonsterAIFactory::stayInLocation(guard, false)));
     }
   }
@@ -1352,34 +1361,34 @@ class CastleExit : public LevelMaker {
   Tribe* guardTribe;
 };
 
-static LevelMaker* underground(bool monsters) {
+static LevelMaker* underground(RandomGen& random, bool monsters) {
   MakerQueue* queue = new MakerQueue();
-  if (Random.roll(1)) {
+  if (random.roll(1)) {
     LevelMaker* cavern = new UniformBlob(SquareType::PATH);
     vector<LevelMaker*> vCavern;
     vector<pair<int, int>> sizes;
-    int minSize = Random.getRandom(5, 15);
-    int maxSize = minSize + Random.getRandom(3, 10);
-    for (int i : Range(sqrt(Random.getRandom(4, 100)))) {
-      int size = Random.getRandom(minSize, maxSize);
+    int minSize = random.getRandom(5, 15);
+    int maxSize = minSize + random.getRandom(3, 10);
+    for (int i : Range(sqrt(random.getRandom(4, 100)))) {
+      int size = random.getRandom(minSize, maxSize);
       sizes.push_back(make_pair(size, size));
       MakerQueue* queue = new MakerQueue();
       queue->addMaker(cavern);
-   /*   if (Random.roll(4))
+   /*   if (random.roll(4))
         queue->addMaker(new Items(ItemFactory::mushrooms(), SquareType::PATH, 2, 5));*/
       vCavern.push_back(queue);
     }
     queue->addMaker(new RandomLocations(vCavern, sizes, new AlwaysTrue(), false));
   }
-  switch (Random.getRandom(3)) {
-    case 1: queue->addMaker(new River(3, chooseRandom({SquareType::WATER, SquareType::MAGMA})));
+  switch (random.getRandom(3)) {
+    case 1: queue->addMaker(new River(3, random.choose({SquareType::WATER, SquareType::MAGMA})));
             break;
     case 2:{
-          int numLakes = sqrt(Random.getRandom(1, 100));
-          SquareType lakeType = chooseRandom({SquareType::WATER, SquareType::MAGMA}, {1, 1});
+          int numLakes = sqrt(random.getRandom(1, 100));
+          SquareType lakeType = random.choose({SquareType::WATER, SquareType::MAGMA}, {1, 1});
           vector<pair<int, int>> sizes;
           for (int i : Range(numLakes)) {
-            int size = Random.getRandom(6, 20);
+            int size = random.getRandom(6, 20);
             sizes.emplace_back(size, size);
           }
           queue->addMaker(new RandomLocations(
@@ -1407,26 +1416,26 @@ static LevelMaker* underground(bool monsters) {
   return queue;
 }
 
-LevelMaker* LevelMaker::roomLevel(CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down) {
+LevelMaker* LevelMaker::roomLevel(RandomGen& random, CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down) {
   map<SquareType, pair<int, int> > featureCount { 
       { SquareType::FOUNTAIN, make_pair(0, 3) },
       { SquareType::CHEST, make_pair(3, 7)},
       { SquareType::TORTURE_TABLE, make_pair(2, 3)}};
   MakerQueue* queue = new MakerQueue();
   queue->addMaker(new Empty(SquareType::BLACK_WALL));
-  queue->addMaker(underground(true));
+  queue->addMaker(underground(random, true));
   LevelMaker* shopMaker = nullptr;
-  if (Random.roll(3)) {
-      shopMaker = new ShopMaker(chooseRandom({
+  if (random.roll(3)) {
+      shopMaker = new ShopMaker(random.choose({
             ItemFactory::villageShop(),
             ItemFactory::dwarfShop(),
             ItemFactory::goblinShop()}),
-          Tribe::human, Random.getRandom(8, 16));
+          Tribe::human, random.getRandom(8, 16));
   }
   queue->addMaker(new RoomMaker(8, 15, 4, 7, SquareType::ROCK_WALL, SquareType::BLACK_WALL, shopMaker));
   queue->addMaker(new Connector({5, 3, 0}));
-  if (Random.roll(3)) {
-    Deity* deity = Deity::getDeity(chooseRandom({DeityHabitat::STONE, DeityHabitat::EARTH}));
+  if (random.roll(3)) {
+    Deity* deity = Deity::getDeity(random.choose({DeityHabitat::STONE, DeityHabitat::EARTH}));
     queue->addMaker(new Shrine(deity, SquareType::FLOOR,
         new TypePredicate({SquareType::ROCK_WALL, SquareType::BLACK_WALL}), SquareType::ROCK_WALL, nullptr));
   }
@@ -1467,7 +1476,7 @@ LevelMaker* hatchery(CreatureFactory factory, int minC, int maxC) {
   return queue;
 }
 
-MakerQueue* village(CreatureFactory factory, Optional<CreatureId> elder, Location* loc, Tribe* tribe) {
+MakerQueue* village(RandomGen& random, CreatureFactory factory, Optional<CreatureId> elder, Location* loc, Tribe* tribe) {
   MakerQueue* queue = new MakerQueue();
   map<SquareType, pair<int, int> > featureCount { 
       { SquareType::CHEST, make_pair(0, 3) },
@@ -1475,7 +1484,7 @@ MakerQueue* village(CreatureFactory factory, Optional<CreatureId> elder, Locatio
   queue->addMaker(new LocationMaker(loc));
   queue->addMaker(new Empty(SquareType::GRASS));
   vector<LevelMaker*> insideMakers {
-      new ShopMaker(ItemFactory::villageShop(), tribe, Random.getRandom(8, 16)),
+      new ShopMaker(ItemFactory::villageShop(), tribe, random.getRandom(8, 16)),
       hatchery(CreatureFactory::singleType(Tribe::elven, CreatureId::PIG), 3, 5),
       new DungeonFeatures(new TypePredicate(SquareType::FLOOR), featureCount)};
   if (elder)
@@ -1505,12 +1514,12 @@ MakerQueue* cottage(CreatureFactory factory, Tribe* tribe, Location* loc) {
   return queue;
 }
 
-MakerQueue* castle(CreatureFactory factory, Optional<CreatureId> elder, Location* loc, Tribe* tribe,
+MakerQueue* castle(RandomGen& random, CreatureFactory factory, Optional<CreatureId> elder, Location* loc, Tribe* tribe,
       vector<StairKey> downStairs) {
   LevelMaker* castleRoom = new BorderGuard(new Empty(SquareType::FLOOR, SquareAttrib::EMPTY_ROOM),
       SquareType::CASTLE_WALL);
   MakerQueue* leftSide = new MakerQueue();
-  leftSide->addMaker(new Division(true, Random.getDouble(0.5, 0.5),
+  leftSide->addMaker(new Division(true, random.getDouble(0.5, 0.5),
       new Margin(1, -1, -1, 1, castleRoom), new Margin(1, 1, -1, -1, castleRoom)));
   map<SquareType, pair<int, int> > featureCount { 
       { SquareType::CHEST, make_pair(3, 8) },
@@ -1525,8 +1534,8 @@ MakerQueue* castle(CreatureFactory factory, Optional<CreatureId> elder, Location
   MakerQueue* inside = new MakerQueue();
   inside->addMaker(new Empty(SquareType::MUD));
   vector<LevelMaker*> insideMakers {
-      new ShopMaker(ItemFactory::villageShop(), tribe, Random.getRandom(8, 16))};
-  inside->addMaker(new Division(Random.getDouble(0.25, 0.4), leftSide,
+      new ShopMaker(ItemFactory::villageShop(), tribe, random.getRandom(8, 16))};
+  inside->addMaker(new Division(random.getDouble(0.25, 0.4), leftSide,
         new Buildings(1, 6, 3, 6, SquareType::CASTLE_WALL, SquareType::FLOOR, SquareType::DOOR, false, insideMakers, false),
         SquareType::CASTLE_WALL));
   MakerQueue* insidePlusWall = new MakerQueue();
@@ -1597,25 +1606,25 @@ LevelMaker* LevelMaker::towerLevel(Optional<StairKey> down, Optional<StairKey> u
 LevelMaker* makeDragonSwamp(StairKey down, Quest* dragonQuest) {
   MakerQueue* queue = new MakerQueue();
   Location* loc = new Location();
-  dragonQuest->setLocation(loc);
   queue->addMaker(new LocationMaker(loc));
+  queue->addMaker(new QuestLocation(dragonQuest, loc));
   queue->addMaker(new UniformBlob(SquareType::MUD));
   queue->addMaker(new Margin(3, new Stairs(StairDirection::DOWN, down, new TypePredicate(SquareType::MUD), Nothing(),
       StairLook::DUNGEON_ENTRANCE_MUD)));
   return queue;
 }
 
-LevelMaker* LevelMaker::topLevel(CreatureFactory forrestCreatures, vector<SettlementInfo> settlements) {
+LevelMaker* LevelMaker::topLevel(RandomGen& random, CreatureFactory forrestCreatures, vector<SettlementInfo> settlements) {
   MakerQueue* queue = new MakerQueue();
   vector<SquareType> vegetationLow { SquareType::CANIF_TREE, SquareType::BUSH };
   vector<SquareType> vegetationHigh { SquareType::DECID_TREE, SquareType::BUSH };
   vector<double> probs { 2, 1 };
   LevelMaker* lake = makeLake();
-  int numLakes = 1;//Random.getRandom(1, 2);
+  int numLakes = 1;//random.getRandom(1, 2);
   vector<pair<int, int>> subSizes;
   vector<LevelMaker*> subMakers;
   for (int i : Range(numLakes)) {
-    subSizes.emplace_back(Random.getRandom(60, 120), Random.getRandom(60, 120));
+    subSizes.emplace_back(random.getRandom(60, 120), random.getRandom(60, 120));
     subMakers.push_back(lake);
   }
   LevelMaker* castleMaker = nullptr;
@@ -1626,9 +1635,9 @@ LevelMaker* LevelMaker::topLevel(CreatureFactory forrestCreatures, vector<Settle
     MakerQueue* queue = nullptr;
     switch (settlement.type) {
       case SettlementType::VILLAGE:
-          queue = village(settlement.factory, settlement.elder, settlement.location, settlement.tribe); break;
+          queue = village(random, settlement.factory, settlement.elder, settlement.location, settlement.tribe); break;
       case SettlementType::CASTLE:
-          queue = castle(settlement.factory, settlement.elder, settlement.location, settlement.tribe,
+          queue = castle(random, settlement.factory, settlement.elder, settlement.location, settlement.tribe,
               settlement.downStairs);
           queue->addMaker(new StartingPos(new TypePredicate(SquareType::MUD)));
           castleMaker = queue;
@@ -1642,9 +1651,9 @@ LevelMaker* LevelMaker::topLevel(CreatureFactory forrestCreatures, vector<Settle
     subMakers.push_back(queue);
     subSizes.push_back(settlement.size);
   }
-  for (int i : Range(Random.getRandom(2, 5))) {
+  for (int i : Range(random.getRandom(2, 5))) {
     subMakers.push_back(new Empty(SquareType::CROPS));
-    subSizes.emplace_back(Random.getRandom(5, 15), Random.getRandom(5, 15));
+    subSizes.emplace_back(random.getRandom(5, 15), random.getRandom(5, 15));
     maxDistances[{elvenVillage, subMakers.back()}] = 18;
   }
   LevelMaker* swamp = makeDragonSwamp(StairKey::DRAGON, Quest::dragon);
@@ -1652,7 +1661,7 @@ LevelMaker* LevelMaker::topLevel(CreatureFactory forrestCreatures, vector<Settle
   subSizes.emplace_back(10, 10);
   maxDistances[{castleMaker, swamp}] = 50;
   Location* banditLocation = new Location("bandit hideout", "The bandits have robbed many travelers and townsfolk.");
-  Quest::bandits->setLocation(banditLocation);
+  queue->addMaker(new QuestLocation(Quest::bandits, banditLocation));
   LevelMaker* bandits = cottage(CreatureFactory::singleType(Tribe::bandit, CreatureId::BANDIT), Tribe::bandit,
       banditLocation);
   subMakers.push_back(bandits);
@@ -1675,10 +1684,10 @@ LevelMaker* LevelMaker::topLevel(CreatureFactory forrestCreatures, vector<Settle
     subMakers.push_back(new FlockAndLeader(CreatureId::ELF, CreatureId::SHEEP, Tribe::elven, 5, 10));
     subSizes.emplace_back(15, 15);
   }
-  int numStoneCircles = Random.getRandom(2, 7);
+  int numStoneCircles = random.getRandom(2, 7);
  /* for (int i : Range(numStoneCircles)) {
     subMakers.push_back(new Circle(ItemId::BOULDER));
-    int size = Random.getRandom(14, 32);
+    int size = random.getRandom(14, 32);
     subSizes.emplace_back(size, size);
   }*/
   MakerQueue* pyramid = new MakerQueue();
@@ -1703,7 +1712,7 @@ LevelMaker* LevelMaker::topLevel(CreatureFactory forrestCreatures, vector<Settle
   queue->addMaker(new Margin(100, dungeonEntrance(StairKey::DWARF, SquareType::MOUNTAIN, "Our enemies the dwarves are living there.")));
  // queue->addMaker(new Margin(100, dungeonEntrance(StairKey::GOBLIN, SquareType::MOUNTAIN, "Our enemies the goblins are living there.")));
   queue->addMaker(new Roads(SquareType::PATH));
-  /*Deity* deity = Deity::getDeity(chooseRandom({DeityHabitat::STARS, DeityHabitat::TREES}));
+  /*Deity* deity = Deity::getDeity(random.choose({DeityHabitat::STARS, DeityHabitat::TREES}));
   queue->addMaker(new Shrine(deity, SquareType::PATH,
         new TypePredicate({SquareType::GRASS, SquareType::DECID_TREE, SquareType::BUSH}), SquareType::WOOD_WALL, new LocationMaker(new Location("shrine", "It is dedicated to the god " + deity->getName()))));*/
   queue->addMaker(new Creatures(forrestCreatures, 30, 50, MonsterAIFactory::wildlifeNonPredator()));
@@ -1711,7 +1720,7 @@ LevelMaker* LevelMaker::topLevel(CreatureFactory forrestCreatures, vector<Settle
   return new BorderGuard(queue);
 }
 
-LevelMaker* LevelMaker::topLevel2(CreatureFactory forrestCreatures, vector<SettlementInfo> settlements) {
+LevelMaker* LevelMaker::topLevel2(RandomGen& random, CreatureFactory forrestCreatures, vector<SettlementInfo> settlements) {
   MakerQueue* queue = new MakerQueue();
   vector<SquareType> vegetationLow { SquareType::CANIF_TREE, SquareType::BUSH };
   vector<SquareType> vegetationHigh { SquareType::DECID_TREE, SquareType::BUSH };
@@ -1730,8 +1739,8 @@ LevelMaker* LevelMaker::topLevel2(CreatureFactory forrestCreatures, vector<Settl
     MakerQueue* queue = nullptr;
     switch (settlement.type) {
       case SettlementType::VILLAGE:
-          queue = village(settlement.factory, settlement.elder, settlement.location, settlement.tribe); break;
-      case SettlementType::CASTLE: queue = castle(settlement.factory, settlement.elder, settlement.location,
+          queue = village(random, settlement.factory, settlement.elder, settlement.location, settlement.tribe); break;
+      case SettlementType::CASTLE: queue = castle(random, settlement.factory, settlement.elder, settlement.location,
                                        settlement.tribe, settlement.downStairs);
                                    break;
       case SettlementType::COTTAGE: queue = cottage(settlement.factory, settlement.tribe, settlement.location);
@@ -1745,9 +1754,9 @@ LevelMaker* LevelMaker::topLevel2(CreatureFactory forrestCreatures, vector<Settl
     subSizes.emplace_back(settlement.size);
   }
   for (LevelMaker* cottage : cottages)
-    for (int i : Range(Random.getRandom(1, 3))) {
+    for (int i : Range(random.getRandom(1, 3))) {
       subMakers.push_back(new Empty(SquareType::CROPS));
-      subSizes.emplace_back(Random.getRandom(5, 15), Random.getRandom(5, 15));
+      subSizes.emplace_back(random.getRandom(5, 15), random.getRandom(5, 15));
       maxDistances[{cottage, subMakers.back()}] = 13;
       predicates.push_back(new AttribPredicate(SquareAttrib::LOWLAND));
     }
@@ -1761,23 +1770,23 @@ LevelMaker* LevelMaker::topLevel2(CreatureFactory forrestCreatures, vector<Settl
   int maxStone = 6;
   int minIron = 5;
   int maxIron = 10;
-  for (int i : Range(Random.getRandom(minGold, maxGold))) {
+  for (int i : Range(random.getRandom(minGold, maxGold))) {
     subMakers.push_back(new UniformBlob(SquareType::GOLD_ORE));
-    subSizes.emplace_back(Random.getRandom(5, 6), Random.getRandom(5, 6)); 
+    subSizes.emplace_back(random.getRandom(5, 6), random.getRandom(5, 6)); 
     predicates.push_back(new TypePredicate(SquareType::MOUNTAIN2));
     if (i < minGold)
       maxDistances[{startingPos, subMakers.back()}] = maxResourceDist;
   }
-  for (int i : Range(Random.getRandom(minStone, maxStone))) {
+  for (int i : Range(random.getRandom(minStone, maxStone))) {
     subMakers.push_back(new UniformBlob(SquareType::STONE));
-    subSizes.emplace_back(Random.getRandom(5, 10), Random.getRandom(5, 10)); 
+    subSizes.emplace_back(random.getRandom(5, 10), random.getRandom(5, 10)); 
     predicates.push_back(new TypePredicate(SquareType::MOUNTAIN2));
     if (i < minStone)
       maxDistances[{startingPos, subMakers.back()}] = maxResourceDist;
   }
-  for (int i : Range(Random.getRandom(minIron, maxIron))) {
+  for (int i : Range(random.getRandom(minIron, maxIron))) {
     subMakers.push_back(new UniformBlob(SquareType::IRON_ORE));
-    subSizes.emplace_back(Random.getRandom(5, 10), Random.getRandom(5, 10)); 
+    subSizes.emplace_back(random.getRandom(5, 10), random.getRandom(5, 10)); 
     predicates.push_back(new TypePredicate(SquareType::MOUNTAIN2));
     if (i < minIron)
       maxDistances[{startingPos, subMakers.back()}] = maxResourceDist;
@@ -1796,7 +1805,7 @@ LevelMaker* LevelMaker::topLevel2(CreatureFactory forrestCreatures, vector<Settl
   return new BorderGuard(queue);
 }
 
-static LevelMaker* townLevel(CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down,
+static LevelMaker* townLevel(RandomGen& random, CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down,
     SquareType furniture, int numCavern, int maxCavernSize, int minRooms, int maxRooms, ItemFactory shopFactory,
     Tribe* shopTribe) {
   MakerQueue* queue = new MakerQueue();
@@ -1808,12 +1817,12 @@ static LevelMaker* townLevel(CreatureFactory cfactory, vector<StairKey> up, vect
   vector<LevelMaker*> vCavern;
   vector<pair<int, int>> sizes;
   for (int i : Range(numCavern)) {
-    sizes.push_back(make_pair(Random.getRandom(5, maxCavernSize), Random.getRandom(5, maxCavernSize)));
+    sizes.push_back(make_pair(random.getRandom(5, maxCavernSize), random.getRandom(5, maxCavernSize)));
     vCavern.push_back(cavern);
   }
   queue->addMaker(new RandomLocations(vCavern, sizes, new AlwaysTrue(), false));
   queue->addMaker(new RoomMaker(minRooms, maxRooms, 4, 7, SquareType::ROCK_WALL, Nothing(),
-        new ShopMaker(shopFactory, shopTribe, Random.getRandom(8, 16)), false));
+        new ShopMaker(shopFactory, shopTribe, random.getRandom(8, 16)), false));
   queue->addMaker(new Connector({1, 0, 0}));
   SquarePredicate* featurePred = new AndPredicates(new AttribPredicate(SquareAttrib::EMPTY_ROOM),
       new TypePredicate(SquareType::FLOOR));
@@ -1827,13 +1836,15 @@ static LevelMaker* townLevel(CreatureFactory cfactory, vector<StairKey> up, vect
 }
 
 
-LevelMaker* LevelMaker::goblinTownLevel(CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down) {
-  return townLevel(cfactory, up, down, SquareType::TORTURE_TABLE, 40, 10, 5, 8, ItemFactory::goblinShop(),
+LevelMaker* LevelMaker::goblinTownLevel(RandomGen& random, CreatureFactory cfactory, vector<StairKey> up,
+    vector<StairKey> down) {
+  return townLevel(random, cfactory, up, down, SquareType::TORTURE_TABLE, 40, 10, 5, 8, ItemFactory::goblinShop(),
       Tribe::goblin);
 }
 
-LevelMaker* LevelMaker::mineTownLevel(CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down) {
-  return townLevel(cfactory, up, down, SquareType::BED, 20, 25, 6, 12, ItemFactory::dwarfShop(), Tribe::dwarven);
+LevelMaker* LevelMaker::mineTownLevel(RandomGen& random, CreatureFactory cfactory, vector<StairKey> up,
+    vector<StairKey> down) {
+  return townLevel(random, cfactory, up, down, SquareType::BED, 20, 25, 6, 12, ItemFactory::dwarfShop(), Tribe::dwarven);
 }
 
 LevelMaker* LevelMaker::pyramidLevel(Optional<CreatureFactory> cfactory, vector<StairKey> up, vector<StairKey> down) {
@@ -1854,11 +1865,11 @@ LevelMaker* LevelMaker::pyramidLevel(Optional<CreatureFactory> cfactory, vector<
   return queue;
 }
 
-LevelMaker* getSurprise(Collective* col, Optional<StairKey> hellDown = Nothing()) {
+LevelMaker* getSurprise(RandomGen& random, Collective* col, Optional<StairKey> hellDown = Nothing()) {
   MakerQueue* queue = new MakerQueue();
   queue->addMaker(new UniformBlob(SquareType::PATH, SquareType::ROCK_WALL));
   queue->addMaker(new LocationMaker(new Location(true)));
-  int numSurprise = Random.getRandom(8);
+  int numSurprise = random.getRandom(8);
   if (hellDown)
     numSurprise = 8;
   switch (numSurprise) {
@@ -1869,7 +1880,7 @@ LevelMaker* getSurprise(Collective* col, Optional<StairKey> hellDown = Nothing()
     case 2: queue->addMaker(new Creatures(CreatureFactory::collectiveSurpriseEnemies(), 1, 2,
                   MonsterAIFactory::collective(col)));
             break;
-    case 3: {Deity* deity = Deity::getDeity(chooseRandom({DeityHabitat::STONE, DeityHabitat::EARTH}));
+    case 3: {Deity* deity = Deity::getDeity(random.choose({DeityHabitat::STONE, DeityHabitat::EARTH}));
             queue->addMaker(new Shrine(deity, SquareType::PATH,
                 new TypePredicate({SquareType::ROCK_WALL, SquareType::BLACK_WALL}), SquareType::ROCK_WALL, nullptr));
             break;
@@ -1894,11 +1905,11 @@ LevelMaker* getSurprise(Collective* col, Optional<StairKey> hellDown = Nothing()
   return queue;
 }
   
-LevelMaker* LevelMaker::collectiveLevel(vector<StairKey> up, vector<StairKey> down, StairKey hellDown,
+LevelMaker* LevelMaker::collectiveLevel(RandomGen& random, vector<StairKey> up, vector<StairKey> down, StairKey hellDown,
     Collective* col) {
   MakerQueue* queue = new MakerQueue();
   queue->addMaker(new Empty(SquareType::ROCK_WALL));
-  queue->addMaker(underground(false));
+  queue->addMaker(underground(random, false));
   vector<LevelMaker*> makers;
   vector<pair<int, int>> sizes;
   MakerQueue* area = new MakerQueue();
@@ -1914,13 +1925,13 @@ LevelMaker* LevelMaker::collectiveLevel(vector<StairKey> up, vector<StairKey> do
   startPos->addMaker(new Margin(2, new StartingPos(new AttribPredicate(SquareAttrib::COLLECTIVE_START))));
   makers.push_back(startPos);
   sizes.emplace_back(5, 5);
-  for (int i : Range(Random.getRandom(2, 5))) {
-    makers.push_back(i == 0 ? getSurprise(col, hellDown) : getSurprise(col));
+  for (int i : Range(random.getRandom(2, 5))) {
+    makers.push_back(i == 0 ? getSurprise(random, col, hellDown) : getSurprise(random, col));
     sizes.emplace_back(5, 5);
   }
-  for (int i : Range(Random.getRandom(4, 7))) {
+  for (int i : Range(random.getRandom(4, 7))) {
     makers.push_back(new UniformBlob(SquareType::GOLD_ORE));
-    sizes.emplace_back(Random.getRandom(5, 10), Random.getRandom(5, 10));
+    sizes.emplace_back(random.getRandom(5, 10), random.getRandom(5, 10));
   }
   queue->addMaker(new RandomLocations(makers, sizes, new AlwaysTrue(), true, {{{area, startPos}, 20}}));
   return new BorderGuard(queue, SquareType::BLACK_WALL);
@@ -20,22 +20,25 @@ class LevelMaker {
   public:
   virtual void make(Level::Builder* builder, Rectangle area) = 0;
 
-  static LevelMaker* roomLevel(CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down);
+  static LevelMaker* roomLevel(RandomGen&, CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down);
   static LevelMaker* cryptLevel(CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down);
   static LevelMaker* cellarLevel(CreatureFactory cfactory, SquareType wallType, StairLook stairLook,
       vector<StairKey> up, vector<StairKey> down);
   static LevelMaker* cavernLevel(CreatureFactory cfactory, SquareType wallType, SquareType floorType,
       StairLook stairLook, vector<StairKey> up, vector<StairKey> down);
-  static LevelMaker* topLevel(CreatureFactory forrest, vector<SettlementInfo> village);
-  static LevelMaker* topLevel2(CreatureFactory forrest, vector<SettlementInfo> village);
-  static LevelMaker* mineTownLevel(CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down);
-  static LevelMaker* goblinTownLevel(CreatureFactory cfactory, vector<StairKey> up, vector<StairKey> down);
+  static LevelMaker* topLevel(RandomGen&, CreatureFactory forrest, vector<SettlementInfo> village);
+  static LevelMaker* topLevel2(RandomGen&, CreatureFactory forrest, vector<SettlementInfo> village);
+  static LevelMaker* mineTownLevel(RandomGen&, CreatureFactory cfactory, vector<StairKey> up,
+      vector<StairKey> down);
+  static LevelMaker* goblinTownLevel(RandomGen&, CreatureFactory cfactory, vector<StairKey> up,
+      vector<StairKey> down);
 
   static LevelMaker* pyramidLevel(Optional<CreatureFactory>, vector<StairKey> up, vector<StairKey> down);
   static LevelMaker* towerLevel(Optional<StairKey> down, Optional<StairKey> up);
-  static Vec2 getRandomExit(Rectangle rect, int minCornerDist = 1);
+  static Vec2 getRandomExit(RandomGen&, Rectangle rect, int minCornerDist = 1);
 
-  static LevelMaker* collectiveLevel(vector<StairKey> up, vector<StairKey> down, StairKey hellDown, Collective* col);
+  static LevelMaker* collectiveLevel(RandomGen&, vector<StairKey> up, vector<StairKey> down, StairKey hellDown,
+      Collective* col);
 };
 
 #endif
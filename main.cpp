@@ -34,7 +34,7 @@ int main(int argc, char* argv[]) {
     argc = 1;
   }
   if (argc == 1 || forceMode > -1) {
-    Random.init(seed);
+    RandomGen::setGameSeed(seed);
     string fname(lognamePref);
     fname += convertToString(seed);
     output.open(fname);
@@ -45,21 +45,24 @@ int main(int argc, char* argv[]) {
     string fname = argv[1];
     Debug() << "Reading from " << fname;
     seed = convertFromString<int>(fname.substr(lognamePref.size()));
-    Random.init(seed);
+    RandomGen::setGameSeed(seed);
     input.open(fname);
     CHECK(input.is_open());
     view = View::createReplayView(input);
   }
   int lastIndex = 0;
+  RandomGen gameRandom = RandomGen::getStream(RandomStream::GAME);
   while (1) {
+    // Every game of the session gets a stream of its own.
+    RandomGen random = gameRandom.split();
     Tribe::init();
     Item::identifyEverything();
     EventListener::initialize();
     Statistics::init();
     Options::init("options.txt");
-    NameGenerator::init("first_names.txt", "aztec_names.txt", "creatures.txt",
+    NameGenerator::init(random, "first_names.txt", "aztec_names.txt", "creatures.txt",
         "artifacts.txt", "world.txt", "town_names.txt", "dwarfs.txt", "gods.txt", "demons.txt", "dogs.txt");
-    ItemFactory::init();
+    ItemFactory::init(random);
     bool modelReady = false;
     messageBuffer.initialize(view);
     view->initialize();
@@ -82,14 +85,16 @@ int main(int argc, char* argv[]) {
     }
     unique_ptr<Model> model;
     string ex;
+    // The world is generated from a stream split off the game stream, so that the game doesn't depend on
+    // whatever the view draws in the meantime.
+    RandomGen worldRandom = random.split();
     thread t = (thread([&] {
-      for (int i : Range(5)) {
-        try {
-          model.reset(choice == 1 ? Model::heroModel(view) : Model::collectiveModel(view));
-          break;
-        } catch (string s) {
-          ex = s;
-        }
+      // Levels that fail to generate are made again by Model::buildLevels, so there is no point in retrying here.
+      try {
+        model.reset(choice == 1 ? Model::heroModel(view, worldRandom)
+            : Model::collectiveModel(view, worldRandom));
+      } catch (string s) {
+        ex = s;
       }
       modelReady = true;
     }));
@@ -3,12 +3,37 @@
 #include "map_memory.h"
 
 void MapMemory::addObject(Vec2 pos, const ViewObject& obj) {
-  table[pos].insert(obj);
-  table[pos].setHighlight(HighlightType::MEMORY);
+  auto it = table.find(pos);
+  ViewIndex index = it == table.end() ? ViewIndex() : it->second;
+  index.insert(obj);
+  index.setHighlight(HighlightType::MEMORY);
+  update(pos, index);
 }
 
 void MapMemory::clearSquare(Vec2 pos) {
-  table.erase(pos);
+  if (table.erase(pos))
+    markChanged(pos);
+}
+
+void MapMemory::update(Vec2 pos, const ViewIndex& index) {
+  auto it = table.find(pos);
+  if (it != table.end() && it->second == index)
+    return;
+  table[pos] = index;
+  markChanged(pos);
+}
+
+void MapMemory::markChanged(Vec2 pos) {
+  lastChanges[pos] = ++numChanges;
+}
+
+int MapMemory::getNumChanges() const {
+  return numChanges;
+}
+
+int MapMemory::getLastChange(Vec2 pos) const {
+  auto it = lastChanges.find(pos);
+  return it == lastChanges.end() ? 0 : it->second;
 }
 
 bool MapMemory::hasViewIndex(Vec2 pos) const {
@@ -9,12 +9,26 @@ class MapMemory {
   public:
   void addObject(Vec2 pos, const ViewObject& obj);
   void clearSquare(Vec2 pos);
+
+  /** Remembers the index for the square. The square only counts as changed if the index is different from the
+      remembered one.*/
+  void update(Vec2 pos, const ViewIndex&);
   bool hasViewIndex(Vec2 pos) const;
   ViewIndex getViewIndex(Vec2 pos) const;
   static const MapMemory& empty();
 
+  /** Returns the number of changes made to the memory so far, like Level::getNumChanges.*/
+  int getNumChanges() const;
+
+  /** Returns the value of getNumChanges() right after the square was last changed, or 0 if it never was.*/
+  int getLastChange(Vec2 pos) const;
+
   private:
+  void markChanged(Vec2 pos);
+
   unordered_map<Vec2, ViewIndex> table;
+  unordered_map<Vec2, int> lastChanges;
+  int numChanges = 0;
 };
 
 #endif
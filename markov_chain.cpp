@@ -30,16 +30,16 @@ void MarkovChain<T>::setState(T s) {
 }
 
 template<class T>
-void MarkovChain<T>::update() {
-  state = chooseRandom(transitions.at(state));
+void MarkovChain<T>::update(RandomGen& random) {
+  state = random.choose(transitions.at(state));
 }
 
 template<class T>
-bool MarkovChain<T>::updateToNext() {
+bool MarkovChain<T>::updateToNext(RandomGen& random) {
   const vector<pair<T, double>> t = transitions.at(state);
   if (t.size() == 1)
     return false;
-  state = chooseRandom(getPrefix(t, 0, t.size() - 1));
+  state = random.choose(getPrefix(t, 0, t.size() - 1));
   return true;
 }
 
@@ -1,6 +1,8 @@
 #ifndef _MARKOV_CHAIN
 #define _MARKOV_CHAIN
 
+#include "util.h"
+
 
 template<class T>
 class MarkovChain {
@@ -9,8 +11,8 @@ class MarkovChain {
 
   T getState() const;
   void setState(T);
-  void update();
-  bool updateToNext();
+  void update(RandomGen&);
+  bool updateToNext(RandomGen&);
 
   private:
   T state;
@@ -8,6 +8,11 @@
 #include "message_buffer.h"
 #include "statistics.h"
 #include "options.h"
+#include "benchmark.h"
+#include "path_service.h"
+#include "shortest_path.h"
+#include "name_generator.h"
+#include "pantheon.h"
 
 using namespace std;
 
@@ -16,13 +21,18 @@ bool Model::isTurnBased() {
 }
 
 void Model::update(double totalTime) {
+  ShortestPath::startTurn();
+  if (PathService::isEnabled())
+    BENCHMARK(PathService::processQueries(), BenchPhase::PATH_QUERIES);
   if (collective)
-    collective->render(view);
+    BENCHMARK(collective->render(view), BenchPhase::COLLECTIVE);
   do {
     if (collective && !collective->isTurnBased()) {
       // process a few times so events don't stack up when game is paused
-      for (int i : Range(5))
-        collective->processInput(view);
+      BENCHMARK(
+          for (int i : Range(5))
+            collective->processInput(view);,
+          BenchPhase::COLLECTIVE);
     }
     Creature* creature = timeQueue.getNextCreature();
     CHECK(creature) << "No more creatures";
@@ -31,7 +41,8 @@ void Model::update(double totalTime) {
     if (time > totalTime)
       return;
     if (time >= lastTick + 1) {
-      MEASURE({
+      Benchmark::add(BenchCounter::TURNS);
+      BENCHMARK({
           Debug() << "Turn " << time;
           for (Creature* c : timeQueue.getAllCreatures()) {
             c->tick(time);
@@ -42,17 +53,18 @@ void Model::update(double totalTime) {
           lastTick = time;
           if (collective)
             collective->tick();
-          }, "ticking time");
+          }, BenchPhase::TICKING);
     }
     bool unpossessed = false;
     if (!creature->isDead()) {
       bool wasPlayer = creature->isPlayer();
-      creature->makeMove();
+      Benchmark::add(BenchCounter::CREATURE_MOVES);
+      BENCHMARK(creature->makeMove(), BenchPhase::CREATURE_MOVE);
       if (wasPlayer && !creature->isPlayer())
         unpossessed = true;
     }
     if (collective)
-      collective->update(creature);
+      BENCHMARK(collective->update(creature), BenchPhase::COLLECTIVE);
     if (!creature->isDead()) {
       Level* level = creature->getLevel();
       CHECK(level->getSquare(creature->getPosition())->getCreature() == creature);
@@ -71,65 +83,189 @@ void Model::removeCreature(Creature* c) {
   deadCreatures.push_back(timeQueue.removeCreature(c));
 }
 
-Level* Model::buildLevel(Level::Builder&& b, LevelMaker* maker, bool surface) {
-  Level::Builder builder(std::move(b));
-  maker->make(&builder, Rectangle(builder.getWidth(), builder.getHeight()));
-  levels.push_back(builder.build(this, surface));
-  return levels.back().get();
+vector<Level*> Model::buildLevels(vector<LevelInfo> info) {
+  struct Attempt {
+    Level::PBuilder builder;
+    vector<Creature*> creatures;
+    vector<EventListener*> listeners;
+    std::exception_ptr exception;
+    std::atomic<bool> cancelled {false};
+    bool wasCancelled = false;
+    bool started = false;
+  };
+  struct LevelState {
+    int numStarted = 0;
+    int numRunning = 0;
+    int winner = -1;
+  };
+  vector<Attempt> attempts(info.size() * maxLevelAttempts);
+  vector<LevelState> state(info.size());
+  vector<RandomGen> levelRandom;
+  for (int i : All(info))
+    levelRandom.push_back(random.split());
+  // Things made on first use shouldn't be made in one of the attempts.
+  Creature::getDefault();
+  Deity::getDeities();
+  NameGenerator::startStreams(attempts.size());
+  std::mutex mutex;
+  std::condition_variable attemptDone;
+  int numRunning = 0;
+  // First attempts in the given order, then attempts of levels whose attempts all failed, and then speculative
+  // attempts of the unfinished level that has the fewest.
+  auto getNextAttempt = [&] () -> Optional<int> {
+    for (int i : All(info))
+      if (state[i].numStarted == 0)
+        return i;
+    for (int i : All(info))
+      if (state[i].winner == -1 && state[i].numRunning == 0 && state[i].numStarted < maxLevelAttempts)
+        return i;
+    Optional<int> ret;
+    for (int i : All(info))
+      if (state[i].winner == -1 && state[i].numStarted < maxLevelAttempts
+          && (!ret || state[i].numStarted < state[*ret].numStarted))
+        ret = i;
+    return ret;
+  };
+  auto makeLevel = [&] (int level, int index) {
+    Attempt& attempt = attempts[level * maxLevelAttempts + index];
+    NameGenerator::setStream(level * maxLevelAttempts + index);
+    Creature::deferRegistration(&attempt.creatures);
+    EventListener::deferListeners(&attempt.listeners);
+    LevelInfo& elem = info[level];
+    attempt.builder.reset(new Level::Builder(elem.width, elem.height, elem.name, levelRandom[level].split(index)));
+    attempt.builder->setCancelFlag(&attempt.cancelled);
+    bool success = false;
+    try {
+      elem.maker(attempt.builder->getRandom())->make(attempt.builder.get(), Rectangle(elem.width, elem.height));
+      success = true;
+    } catch (Level::Builder::CancelledException) {
+      attempt.wasCancelled = true;
+    } catch (...) {
+      attempt.exception = std::current_exception();
+    }
+    bool keep;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      LevelState& levelState = state[level];
+      keep = success && (levelState.winner == -1 || index < levelState.winner);
+      if (keep) {
+        levelState.winner = index;
+        for (int i = index + 1; i < maxLevelAttempts; ++i)
+          attempts[level * maxLevelAttempts + i].cancelled = true;
+      }
+    }
+    // The creatures of a discarded attempt are destroyed here, where they are still on its list.
+    if (!keep)
+      attempt.builder.reset();
+    Creature::deferRegistration(nullptr);
+    EventListener::deferListeners(nullptr);
+    NameGenerator::setStream(-1);
+  };
+  auto work = [&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (1) {
+      if (Optional<int> level = getNextAttempt()) {
+        int index = state[*level].numStarted++;
+        ++state[*level].numRunning;
+        ++numRunning;
+        attempts[*level * maxLevelAttempts + index].started = true;
+        lock.unlock();
+        makeLevel(*level, index);
+        lock.lock();
+        --state[*level].numRunning;
+        --numRunning;
+        attemptDone.notify_all();
+      } else if (numRunning > 0)
+        attemptDone.wait(lock);
+      else
+        break;
+    }
+  };
+  int numThreads = generationThreads > 0 ? generationThreads : max<int>(1, thread::hardware_concurrency());
+  vector<thread> threads;
+  for (int i : Range(numThreads))
+    threads.emplace_back(work);
+  for (thread& t : threads)
+    t.join();
+  vector<int> kept;
+  for (int i : All(info))
+    if (state[i].winner > -1)
+      kept.push_back(i * maxLevelAttempts + state[i].winner);
+  NameGenerator::endStreams(kept);
+  auto discard = [] (Attempt& attempt) {
+    Creature::deferRegistration(&attempt.creatures);
+    EventListener::deferListeners(&attempt.listeners);
+    attempt.builder.reset();
+    Creature::deferRegistration(nullptr);
+    EventListener::deferListeners(nullptr);
+  };
+  for (int i : All(attempts)) {
+    Attempt& attempt = attempts[i];
+    if (attempt.started) {
+      Benchmark::add(BenchCounter::GENERATION_ATTEMPTS);
+      if (attempt.exception)
+        Benchmark::add(BenchCounter::GENERATION_FAILURES);
+      if (attempt.wasCancelled)
+        Benchmark::add(BenchCounter::GENERATION_CANCELLATIONS);
+    }
+    // Successful attempts that finished before an earlier one.
+    if (attempt.builder && !contains(kept, i))
+      discard(attempt);
+  }
+  for (int i : All(info))
+    if (state[i].winner == -1) {
+      for (int j : kept)
+        discard(attempts[j]);
+      std::rethrow_exception(attempts[(i + 1) * maxLevelAttempts - 1].exception);
+    }
+  for (int i : kept) {
+    for (Creature* c : attempts[i].creatures)
+      c->registerCreature();
+    for (EventListener* l : attempts[i].listeners)
+      EventListener::addListener(l);
+  }
+  vector<Level*> ret;
+  for (int i : All(info)) {
+    levels.push_back(attempts[kept[i]].builder->build(this, info[i].surface));
+    ret.push_back(levels.back().get());
+  }
+  return ret;
 }
 
-Model::Model(View* v) : view(v) {
+int Model::generationThreads = 0;
+
+void Model::setGenerationThreads(int num) {
+  generationThreads = num;
 }
 
-Level* Model::prepareTopLevel2(vector<SettlementInfo> settlements) {
-  Level* top = buildLevel(
-      Level::Builder(180, 120, "Wilderness"),
-      LevelMaker::topLevel2(CreatureFactory::forrest(), settlements),
-      true);
-  return top;
+size_t Model::getWorldHash() {
+  size_t ret = 0;
+  auto add = [&ret](const string& s) { ret = ret * 1000003 + std::hash<string>()(s); };
+  for (PLevel& level : levels) {
+    add(level->getName());
+    for (Vec2 v : level->getBounds()) {
+      Square* square = level->getSquare(v);
+      add(square->getName());
+      for (Item* item : square->getItems())
+        add(item->getName());
+    }
+    for (Creature* c : level->getAllCreatures())
+      add(c->getName() + (c->getFirstName() ? *c->getFirstName() : "") + convertToString(c->getPosition())
+          + convertToString(c->getUniqueId()));
+  }
+  return ret;
 }
 
-Level* Model::prepareTopLevel(vector<SettlementInfo> settlements) {
-  pair<CreatureId, string> castleNem1 = chooseRandom<pair<CreatureId, string>>(
-      {{CreatureId::GHOST, "The castle cellar is haunted. Go and kill the evil that is lurking there."},
-      {CreatureId::SPIDER, "The castle cellar is infested by vermin. Go and clean it up."}}, {1, 1});
-  pair<CreatureId, string> castleNem2 = chooseRandom<pair<CreatureId, string>>(
-      {{CreatureId::DRAGON, "dragon"}, {CreatureId::CYCLOPS, "cyclops"}});
-  Quest::dragon = Quest::killTribeQuest(Tribe::dragon, "A " + castleNem2.second + 
-      " is harrasing our village. Kill it. It lives in a cave not far from here.");
-  Quest::castleCellar = Quest::killTribeQuest(Tribe::castleCellar, castleNem1.second);
-  Quest::bandits = Quest::killTribeQuest(Tribe::bandit, "There is a bandit camp nearby. Kill them all.");
-  Quest::dwarves = Quest::killTribeQuest(Tribe::dwarven, "Slay our enemy, the dwarf baron. I will reward you.", true);
-  Quest::goblins = Quest::killTribeQuest(Tribe::goblin, "The goblin den is located deep under the earth. "
-      "Slay the great goblin. I will reward you.", true);
-  Level* top = buildLevel(
-      Level::Builder(600, 600, "Wilderness"),
-      LevelMaker::topLevel(CreatureFactory::forrest(), settlements),
-      true);
-  Level* c1 = buildLevel(
-      Level::Builder(30, 20, "Crypt"),
-      LevelMaker::cryptLevel(CreatureFactory::crypt(),{StairKey::CRYPT}, {}));
-  Level* p1 = buildLevel(
-      Level::Builder(13, 13, "Pyramid Level 2"),
-      LevelMaker::pyramidLevel(CreatureFactory::pyramid(1), {StairKey::PYRAMID},  {StairKey::PYRAMID}));
-  Level* p2 = buildLevel(
-      Level::Builder(11, 11, "Pyramid Level 3"),
-      LevelMaker::pyramidLevel(CreatureFactory::pyramid(2), {}, {StairKey::PYRAMID}));
-  Level* cellar = buildLevel(
-      Level::Builder(30, 20, "Cellar"),
-      LevelMaker::cellarLevel(CreatureFactory::singleType(Tribe::castleCellar, castleNem1.first),
-          SquareType::LOW_ROCK_WALL, StairLook::CELLAR, {StairKey::CASTLE_CELLAR}, {}));
-  Level* dragon = buildLevel(
-      Level::Builder(40, 30, capitalFirst(castleNem2.second) + "'s Cave"),
-      LevelMaker::cavernLevel(CreatureFactory::singleType(Tribe::dragon, castleNem2.first),
-          SquareType::MUD_WALL, SquareType::MUD, StairLook::NORMAL, {StairKey::DRAGON}, {}));
-  addLink(StairDirection::DOWN, StairKey::CRYPT, top, c1);
-  addLink(StairDirection::UP, StairKey::PYRAMID, top, p1);
-  addLink(StairDirection::UP, StairKey::PYRAMID, p1, p2);
-  addLink(StairDirection::DOWN, StairKey::CASTLE_CELLAR, top, cellar);
-  addLink(StairDirection::DOWN, StairKey::DRAGON, top, dragon); 
+Model::Model(View* v) : view(v) {
+}
+
+Model::Model(View* v, RandomGen r) : view(v), random(r) {
+}
 
-  return top;
+Level* Model::prepareTopLevel2(vector<SettlementInfo> settlements) {
+  return buildLevels({{180, 120, "Wilderness",
+      [=] (RandomGen& random) {
+          return LevelMaker::topLevel2(random, CreatureFactory::forrest(), settlements); }, true}})[0];
 }
 
 vector<Location*> getVillageLocations(int numVillages) {
@@ -139,35 +275,76 @@ vector<Location*> getVillageLocations(int numVillages) {
   return ret;
 }
 
-Model* Model::heroModel(View* view) {
+Model* Model::heroModel(View* view, RandomGen random) {
   Creature::noExperienceLevels();
-  Model* m = new Model(view);
+  Model* m = new Model(view, random);
   vector<Location*> locations = getVillageLocations(3);
-  Level* top = m->prepareTopLevel({
+  pair<CreatureId, string> castleNem1 = m->random.choose<pair<CreatureId, string>>(
+      {{CreatureId::GHOST, "The castle cellar is haunted. Go and kill the evil that is lurking there."},
+      {CreatureId::SPIDER, "The castle cellar is infested by vermin. Go and clean it up."}}, {1, 1});
+  pair<CreatureId, string> castleNem2 = m->random.choose<pair<CreatureId, string>>(
+      {{CreatureId::DRAGON, "dragon"}, {CreatureId::CYCLOPS, "cyclops"}});
+  Quest::dragon = Quest::killTribeQuest(Tribe::dragon, "A " + castleNem2.second + 
+      " is harrasing our village. Kill it. It lives in a cave not far from here.");
+  Quest::castleCellar = Quest::killTribeQuest(Tribe::castleCellar, castleNem1.second);
+  Quest::bandits = Quest::killTribeQuest(Tribe::bandit, "There is a bandit camp nearby. Kill them all.");
+  Quest::dwarves = Quest::killTribeQuest(Tribe::dwarven, "Slay our enemy, the dwarf baron. I will reward you.", true);
+  Quest::goblins = Quest::killTribeQuest(Tribe::goblin, "The goblin den is located deep under the earth. "
+      "Slay the great goblin. I will reward you.", true);
+  vector<SettlementInfo> settlements {
       {SettlementType::CASTLE, CreatureFactory::humanVillage(), CreatureId::AVATAR, locations[0], Tribe::human,
         {30, 20}, {StairKey::CASTLE_CELLAR}},
  //     {SettlementType::VILLAGE, CreatureFactory::humanVillagePeaceful(), locations[1], Tribe::human, {30, 20}, {}},
       {SettlementType::VILLAGE, CreatureFactory::elvenVillage(), CreatureId::ELF_LORD, locations[2], Tribe::elven,
-        {30, 20}, {}}});
-/*  Level* top = m->prepareTopLevel2({
-      {SettlementType::CASTLE, CreatureFactory::humanVillage(), locations[0], Tribe::human}});*/
-  Level* d1 = m->buildLevel(
-      Level::Builder(60, 35, "Dwarven Halls"),
-      LevelMaker::mineTownLevel(CreatureFactory::dwarfTown(1), {StairKey::DWARF}, {StairKey::DWARF}));
-  Level* g1 = m->buildLevel(
-      Level::Builder(60, 35, "Goblin Den"),
-      LevelMaker::goblinTownLevel(CreatureFactory::goblinTown(1), {StairKey::DWARF}, {}));
-  vector<Level*> gnomish;
+        {30, 20}, {}}};
+  vector<LevelInfo> levelInfo;
+  levelInfo.push_back({600, 600, "Wilderness",
+      [=] (RandomGen& random) {
+          return LevelMaker::topLevel(random, CreatureFactory::forrest(), settlements); }, true});
+  levelInfo.push_back({30, 20, "Crypt",
+      [] (RandomGen&) { return LevelMaker::cryptLevel(CreatureFactory::crypt(),{StairKey::CRYPT}, {}); }, false});
+  levelInfo.push_back({13, 13, "Pyramid Level 2",
+      [] (RandomGen&) { return LevelMaker::pyramidLevel(CreatureFactory::pyramid(1), {StairKey::PYRAMID}, {StairKey::PYRAMID}); },
+      false});
+  levelInfo.push_back({11, 11, "Pyramid Level 3",
+      [] (RandomGen&) { return LevelMaker::pyramidLevel(CreatureFactory::pyramid(2), {}, {StairKey::PYRAMID}); }, false});
+  levelInfo.push_back({30, 20, "Cellar",
+      [=] (RandomGen&) { return LevelMaker::cellarLevel(CreatureFactory::singleType(Tribe::castleCellar, castleNem1.first),
+          SquareType::LOW_ROCK_WALL, StairLook::CELLAR, {StairKey::CASTLE_CELLAR}, {}); }, false});
+  levelInfo.push_back({40, 30, capitalFirst(castleNem2.second) + "'s Cave",
+      [=] (RandomGen&) { return LevelMaker::cavernLevel(CreatureFactory::singleType(Tribe::dragon, castleNem2.first),
+          SquareType::MUD_WALL, SquareType::MUD, StairLook::NORMAL, {StairKey::DRAGON}, {}); }, false});
+  levelInfo.push_back({60, 35, "Dwarven Halls",
+      [] (RandomGen& random) {
+          return LevelMaker::mineTownLevel(random, CreatureFactory::dwarfTown(1), {StairKey::DWARF},
+              {StairKey::DWARF}); }, false});
+  levelInfo.push_back({60, 35, "Goblin Den",
+      [] (RandomGen& random) {
+          return LevelMaker::goblinTownLevel(random, CreatureFactory::goblinTown(1), {StairKey::DWARF}, {}); },
+      false});
   int numGnomLevels = 8;
- // int towerLinkIndex = Random.getRandom(1, numGnomLevels - 1);
+ // int towerLinkIndex = m->random.getRandom(1, numGnomLevels - 1);
   for (int i = 0; i < numGnomLevels; ++i) {
     vector<StairKey> upKeys {StairKey::DWARF};
  /*   if (i == towerLinkIndex)
       upKeys.push_back(StairKey::TOWER);*/
-    gnomish.push_back(m->buildLevel(
-          Level::Builder(60, 35, "Gnomish Mines Level " + convertToString(i + 1)),
-          LevelMaker::roomLevel(CreatureFactory::level(i + 1), upKeys, {StairKey::DWARF})));
+    levelInfo.push_back({60, 35, "Gnomish Mines Level " + convertToString(i + 1),
+        [=] (RandomGen& random) {
+            return LevelMaker::roomLevel(random, CreatureFactory::level(random, i + 1), upKeys, {StairKey::DWARF}); },
+        false});
   }
+  vector<Level*> levels = m->buildLevels(std::move(levelInfo));
+  Level* top = levels[0];
+  Level* c1 = levels[1];
+  Level* p1 = levels[2];
+  Level* p2 = levels[3];
+  Level* cellar = levels[4];
+  Level* dragon = levels[5];
+  Level* d1 = levels[6];
+  Level* g1 = levels[7];
+  vector<Level*> gnomish(levels.begin() + 8, levels.end());
+/*  Level* top = m->prepareTopLevel2({
+      {SettlementType::CASTLE, CreatureFactory::humanVillage(), locations[0], Tribe::human}});*/
  /* vector<Level*> tower;
   int numTowerLevels = 5;
   for (int i = 0; i < numTowerLevels; ++i)
@@ -181,6 +358,12 @@ Model* Model::heroModel(View* view) {
  // m->addLink(StairDirection::DOWN, StairKey::TOWER, tower[0], gnomish[towerLinkIndex]);
  // m->addLink(StairDirection::DOWN, StairKey::TOWER, top, tower.back());
 
+  m->addLink(StairDirection::DOWN, StairKey::CRYPT, top, c1);
+  m->addLink(StairDirection::UP, StairKey::PYRAMID, top, p1);
+  m->addLink(StairDirection::UP, StairKey::PYRAMID, p1, p2);
+  m->addLink(StairDirection::DOWN, StairKey::CASTLE_CELLAR, top, cellar);
+  m->addLink(StairDirection::DOWN, StairKey::DRAGON, top, dragon); 
+
   for (int i = 0; i < numGnomLevels - 1; ++i)
     m->addLink(StairDirection::DOWN, StairKey::DWARF, gnomish[i], gnomish[i + 1]);
 
@@ -188,7 +371,7 @@ Model* Model::heroModel(View* view) {
   m->addLink(StairDirection::DOWN, StairKey::DWARF, d1, gnomish[0]);
   m->addLink(StairDirection::UP, StairKey::DWARF, g1, gnomish.back());
   map<const Level*, MapMemory>* levelMemory = new map<const Level*, MapMemory>();
-  PCreature player = CreatureFactory::addInventory(
+  PCreature player = CreatureFactory::addInventory(m->random,
       PCreature(new Creature(ViewObject(ViewId::PLAYER, ViewLayer::CREATURE, "Player"), Tribe::player,
       CATTR(
           c.speed = 100;
@@ -206,8 +389,8 @@ Model* Model::heroModel(View* view) {
       ItemId::SWORD,
       ItemId::KNIFE,
       ItemId::LEATHER_ARMOR, ItemId::LEATHER_HELM});
-  for (int i : Range(Random.getRandom(70, 131)))
-    player->take(ItemFactory::fromId(ItemId::GOLD_PIECE));
+  for (int i : Range(m->random.getRandom(70, 131)))
+    player->take(ItemFactory::fromId(m->random, ItemId::GOLD_PIECE));
   Tribe::goblin->makeSlightEnemy(player.get());
   Level* start = top;
   start->setPlayer(player.get());
@@ -215,8 +398,8 @@ Model* Model::heroModel(View* view) {
   return m;
 }
 
-Model* Model::collectiveModel(View* view) {
-  Model* m = new Model(view);
+Model* Model::collectiveModel(View* view, RandomGen random) {
+  Model* m = new Model(view, random);
   CreatureFactory factory = CreatureFactory::collectiveStart();
   vector<Location*> villageLocations = getVillageLocations(2);
   vector<SettlementInfo> settlements{
@@ -235,11 +418,11 @@ Model* Model::collectiveModel(View* view) {
        {SettlementType::COTTAGE, cottageF[i % 2], Nothing(), new Location(), cottageT[i % 2],
        {10, 10}, {}});
   Level* top = m->prepareTopLevel2(settlements);
-  m->collective = new Collective(m);
+  m->collective = new Collective(m, m->random.split());
   m->collective->setLevel(top);
   Tribe::human->addEnemy(Tribe::player);
   Tribe::elven->addEnemy(Tribe::player);
-  PCreature c = CreatureFactory::fromId(CreatureId::KEEPER, Tribe::player,
+  PCreature c = CreatureFactory::fromId(m->random, CreatureId::KEEPER, Tribe::player,
       MonsterAIFactory::collective(m->collective));
   Creature* ref = c.get();
   top->landCreature(StairDirection::UP, StairKey::PLAYER_SPAWN, c.get());
@@ -247,7 +430,7 @@ Model* Model::collectiveModel(View* view) {
   m->collective->addCreature(ref);
  // m->collective->possess(ref, view);
   for (int i : Range(4)) {
-    PCreature c = factory.random(MonsterAIFactory::collective(m->collective));
+    PCreature c = factory.random(m->random, MonsterAIFactory::collective(m->collective));
     top->landCreature(StairDirection::UP, StairKey::PLAYER_SPAWN, c.get());
     m->collective->addCreature(c.get(), MinionType::IMP);
     m->addCreature(std::move(c));
@@ -275,10 +458,10 @@ Model* Model::collectiveModel(View* view) {
     CreatureFactory lastAttack = villageFactories[cnt].second;
     for (int j : All(heroAttackTime[i])) {
       int attackTime = get<0>(heroAttackTime[i][j]);
-      int heroCount = Random.getRandom(get<1>(heroAttackTime[i][j]), get<2>(heroAttackTime[i][j]));
+      int heroCount = m->random.getRandom(get<1>(heroAttackTime[i][j]), get<2>(heroAttackTime[i][j]));
       CreatureFactory& factory = (j == heroAttackTime[i].size() - 1 ? lastAttack : firstAttack);
       for (int k : Range(heroCount)) {
-        PCreature c = factory.random(MonsterAIFactory::villageControl(control, loc));
+        PCreature c = factory.random(m->random, MonsterAIFactory::villageControl(control, loc));
         control->addCreature(c.get(), attackTime);
         top->landCreature(loc->getBounds().getAllSquares(), std::move(c));
       }
@@ -291,10 +474,10 @@ Model* Model::collectiveModel(View* view) {
   CreatureFactory lastAttack = CreatureFactory::dwarfTown(1);
   for (int i : All(heroAttackTime)) {
     CreatureFactory& factory = (i == heroAttackTime.size() - 1 ? lastAttack : firstAttack);
-    int attackTime = get<0>(heroAttackTime[i]) + Random.getRandom(-200, 200);
-    int heroCount = Random.getRandom(get<1>(heroAttackTime[i]), get<2>(heroAttackTime[i]));
+    int attackTime = get<0>(heroAttackTime[i]) + m->random.getRandom(-200, 200);
+    int heroCount = m->random.getRandom(get<1>(heroAttackTime[i]), get<2>(heroAttackTime[i]));
     for (int k : Range(heroCount)) {
-      PCreature c = factory.random(MonsterAIFactory::villageControl(dwarfControl, nullptr));
+      PCreature c = factory.random(m->random, MonsterAIFactory::villageControl(dwarfControl, nullptr));
       dwarfControl->addCreature(c.get(), attackTime);
       dwarf->landCreature(StairDirection::UP, StairKey::DWARF, std::move(c));
     }
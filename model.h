@@ -20,11 +20,11 @@ class Model {
   public:
   Model(View* view);
 
-  /** Generates levels and all game entities for a single player game. */
-  static Model* heroModel(View* view);
+  /** Generates levels and all game entities for a single player game from the given random stream. */
+  static Model* heroModel(View* view, RandomGen);
  
-  /** Generates levels and all game entities for a collective game. */
-  static Model* collectiveModel(View* view);
+  /** Generates levels and all game entities for a collective game from the given random stream. */
+  static Model* collectiveModel(View* view, RandomGen);
 
   /** Makes an update to the game. This method is repeatedly called to make the game run.
     Returns the total logical time elapsed.*/
@@ -44,16 +44,42 @@ class Model {
 
   bool isTurnBased();
 
+  /** Sets the number of threads that generate the levels of a new model. 0 means the number of cores.*/
+  static void setGenerationThreads(int);
+
+  /** Returns a hash of the levels, with their squares, creatures and items. A given seed should always produce
+      the same hash.*/
+  size_t getWorldHash();
+
   void gameOver(const Creature* player, int numKills, const string& enemiesString, int points);
   void conquered(const string& title, const string& land, vector<const Creature*> kills, int points);
   void showHighscore(bool highlightLast = false);
 
   private:
-  Level* buildLevel(Level::Builder&& b, LevelMaker*, bool surface = false);
+  Model(View* view, RandomGen);
+
+  struct LevelInfo {
+    int width;
+    int height;
+    string name;
+    /** Called on the thread of every attempt to make the level, so that the attempts don't share makers.
+        It's given the random stream of the attempt.*/
+    function<LevelMaker*(RandomGen&)> maker;
+    bool surface;
+  };
+
+  /** Builds independent levels on several threads. A level whose maker fails is made again from another random
+      stream, up to maxLevelAttempts times. Threads that have nothing else to do start further attempts of
+      unfinished levels ahead of time. The successful attempt with the lowest number is kept and the later ones
+      are cancelled, and the levels are added to the model in the given order when all are done, so the result
+      doesn't depend on the number of threads.*/
+  vector<Level*> buildLevels(vector<LevelInfo>);
+  static const int maxLevelAttempts = 5;
   void addLink(StairDirection, StairKey, Level*, Level*);
-  Level* prepareTopLevel(vector<SettlementInfo> settlements);
   Level* prepareTopLevel2(vector<SettlementInfo> settlements);
 
+  static int generationThreads;
+
   vector<PLevel> levels;
   View* view;
   TimeQueue timeQueue;
@@ -61,6 +87,8 @@ class Model {
   double lastTick = -1000;
   map<tuple<StairDirection, StairKey, Level*>, Level*> levelLinks;
   Collective* collective = nullptr;
+  /** Stream of the things in the world that don't have one of their own.*/
+  RandomGen random;
 };
 
 #endif
@@ -125,13 +125,13 @@ class MoveRandomly : public Behaviour {
     Vec2 direction(0, 0);
     double val = 0.0001;
     Vec2 pos = creature->getPosition();
-    for (Vec2 dir : Vec2::directions8(true))
+    for (Vec2 dir : Vec2::directions8(creature->getRandom()))
       if (!visited(pos + dir) && creature->canMove(dir)) {
         direction = dir;
         break;
       }
     if (direction == Vec2(0, 0))
-      for (Vec2 dir : Vec2::directions8(true))
+      for (Vec2 dir : Vec2::directions8(creature->getRandom()))
         if (creature->canMove(dir)) {
           direction = dir;
           break;
@@ -165,7 +165,7 @@ class AttackPest : public Behaviour {
     if (creature->getTribe() == Tribe::pest)
       return NoMove;
     const Creature* other = nullptr;
-    for (Vec2 v : Vec2::directions8(true))
+    for (Vec2 v : Vec2::directions8(creature->getRandom()))
       if (const Creature* c = creature->getConstSquare(v)->getCreature())
         if (c->getTribe() == Tribe::pest) {
           other = c;
@@ -188,7 +188,7 @@ class BirdFlyAway : public Behaviour {
 
   virtual MoveInfo getMove() override {
     const Creature* enemy = getClosestEnemy();
-    bool fly = Random.roll(15) || ( enemy && (enemy->getPosition() - creature->getPosition()).lengthD() < maxDist);
+    bool fly = creature->getRandom().roll(15) || ( enemy && (enemy->getPosition() - creature->getPosition()).lengthD() < maxDist);
     if (creature->canFlyAway() && fly)
       return {1.0, [this] () {
         creature->flyAway();
@@ -239,7 +239,7 @@ class Fighter : public Behaviour, public EventListener {
     if (contains(trajectory, creature->getPosition())
           && item->getName().size() > name.size() && item->getName().substr(0, name.size()) == name) {
       creature->globalMessage(creature->getTheName() + " screams in terror!", "You hear a scream of terror.");
-      if (Random.roll(2))
+      if (creature->getRandom().roll(2))
         creature->rage(30);
       else
         courage -= 0.5;
@@ -493,11 +493,13 @@ class GuardTarget : public Behaviour {
 
 class GuardArea : public Behaviour {
   public:
-  GuardArea(Creature* c, const Location* l) : Behaviour(c), location(l), area(l->getBounds()) {}
+  GuardArea(Creature* c, const Location* l) : Behaviour(c), location(l) {}
 
   virtual MoveInfo getMove() override {
     if (creature->getLevel() != location->getLevel())
       return NoMove;
+    // The bounds are read here, because they are set only when the level is built.
+    Rectangle area = location->getBounds();
     if (!creature->getPosition().inRectangle(area)) {
       for (Vec2 v : Vec2::directions8())
         if ((creature->getPosition() + v).inRectangle(area) && creature->canMove(v))
@@ -516,7 +518,6 @@ class GuardArea : public Behaviour {
 
   private:
   const Location* location;
-  Rectangle area;
 };
 
 class GuardSquare : public GuardTarget {
@@ -599,7 +600,7 @@ class Thief : public Behaviour {
         }};
       }
     }
-    for (Vec2 dir : Vec2::directions8(true)) {
+    for (Vec2 dir : Vec2::directions8(creature->getRandom())) {
       const Creature* other = creature->getConstSquare(dir)->getCreature();
       if (other && !contains(robbed, other)) {
         vector<Item*> allGold;
@@ -638,7 +639,7 @@ class ChooseRandom : public Behaviour {
   ChooseRandom(Creature* c, vector<Behaviour*> beh, vector<double> w) : Behaviour(c), behaviours(beh), weights(w) {}
 
   virtual MoveInfo getMove() override {
-    return chooseRandom(behaviours, weights)->getMove();
+    return creature->getRandom().choose(behaviours, weights)->getMove();
   }
 
   private:
@@ -651,7 +652,7 @@ class GoToHeart : public Behaviour {
   GoToHeart(Creature* c, Vec2 _heartPos) : Behaviour(c), heartPos(_heartPos) {}
 
   virtual MoveInfo getMove() override {
-    if (Optional<Vec2> move = creature->getMoveTowards(heartPos)) 
+    if (Optional<Vec2> move = creature->getSharedMoveTowards(heartPos)) 
       return {1.0, [this, move] () {
         creature->move(*move);
       }};
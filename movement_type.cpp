@@ -0,0 +1,53 @@
+#include "stdafx.h"
+
+#include "movement_type.h"
+
+using namespace std;
+
+MovementType::MovementType(bool w, bool fl, bool sw, CreatureSize s, bool fo, bool p, bool fa)
+    : walker(w), flyer(fl), swimmer(sw), size(s), forced(fo), playerTribe(p), farmAnimal(fa) {
+}
+
+bool MovementType::canWalk() const {
+  return walker;
+}
+
+bool MovementType::canFly() const {
+  return flyer;
+}
+
+bool MovementType::canSwim() const {
+  return swimmer;
+}
+
+CreatureSize MovementType::getSize() const {
+  return size;
+}
+
+bool MovementType::isForced() const {
+  return forced;
+}
+
+MovementType MovementType::getUnforced() const {
+  MovementType ret(*this);
+  ret.forced = false;
+  return ret;
+}
+
+bool MovementType::isPlayerTribe() const {
+  return playerTribe;
+}
+
+bool MovementType::isFarmAnimal() const {
+  return farmAnimal;
+}
+
+bool MovementType::operator == (const MovementType& o) const {
+  return walker == o.walker && flyer == o.flyer && swimmer == o.swimmer && size == o.size && forced == o.forced
+      && playerTribe == o.playerTribe && farmAnimal == o.farmAnimal;
+}
+
+bool MovementType::operator < (const MovementType& o) const {
+  return make_tuple(walker, flyer, swimmer, size, forced, playerTribe, farmAnimal)
+      < make_tuple(o.walker, o.flyer, o.swimmer, o.size, o.forced, o.playerTribe, o.farmAnimal);
+}
@@ -0,0 +1,44 @@
+#ifndef _MOVEMENT_TYPE_H
+#define _MOVEMENT_TYPE_H
+
+#include "creature_attributes.h"
+
+/** The properties of a creature that decide which squares it can enter. Creatures with equal movement types
+    can share pathfinding data.*/
+class MovementType {
+  public:
+  MovementType(bool walker, bool flyer, bool swimmer, CreatureSize, bool forced, bool playerTribe,
+      bool farmAnimal);
+
+  bool canWalk() const;
+  bool canFly() const;
+  bool canSwim() const;
+  CreatureSize getSize() const;
+
+  /** Blind and held creatures can end up on squares that they would never enter by themselves.*/
+  bool isForced() const;
+
+  /** Returns the same movement type without the forced flag. Pathfinding data is kept for these, so that
+      creatures that are blind or held for a while don't get their own copies.*/
+  MovementType getUnforced() const;
+
+  /** Tribe doors only let the player's tribe through.*/
+  bool isPlayerTribe() const;
+
+  /** Chickens and pigs can move inside hatcheries.*/
+  bool isFarmAnimal() const;
+
+  bool operator == (const MovementType&) const;
+  bool operator < (const MovementType&) const;
+
+  private:
+  bool walker;
+  bool flyer;
+  bool swimmer;
+  CreatureSize size;
+  bool forced;
+  bool playerTribe;
+  bool farmAnimal;
+};
+
+#endif
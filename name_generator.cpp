@@ -15,23 +15,26 @@ NameGenerator NameGenerator::deityNames;
 NameGenerator NameGenerator::demonNames;
 NameGenerator NameGenerator::dogNames;
 
-string getSyllable() {
+int NameGenerator::numStreams = 0;
+thread_local int NameGenerator::stream = -1;
+
+string getSyllable(RandomGen& random) {
   string vowels = "aeyuio";
   string consonants = "qwrtplkjhgfdszxcvbnm";
   string ret;
-  if (Random.roll(3))
-    ret += consonants[Random.getRandom(consonants.size())];
-  ret += vowels[Random.getRandom(vowels.size())];
-  if (Random.roll(3))
-    ret += consonants[Random.getRandom(consonants.size())];
+  if (random.roll(3))
+    ret += consonants[random.getRandom(consonants.size())];
+  ret += vowels[random.getRandom(vowels.size())];
+  if (random.roll(3))
+    ret += consonants[random.getRandom(consonants.size())];
   return ret;
 }
 
-string getWord() {
-  int syllables = chooseRandom({1, 2, 3, 4}, {1, 4, 3, 1});
+string getWord(RandomGen& random) {
+  int syllables = random.choose({1, 2, 3, 4}, {1, 4, 3, 1});
   string ret;
   for (int i : Range(syllables))
-    ret += getSyllable();
+    ret += getSyllable(random);
   return ret;
 }
 
@@ -45,44 +48,81 @@ vector<string> readLines(const string& path) {
   return input;
 }
 
-void NameGenerator::init(const string& firstNamesPath, const string& aztecNamesPath,
+void NameGenerator::init(RandomGen& random, const string& firstNamesPath, const string& aztecNamesPath,
       const string& creatureNamesPath, const string& weaponNamesPath, const string& worldsPath,
       const string& townsPath, const string& dwarfsPath, const string& deitiesPath, const string& demonsPath,
       const string& dogsPath) {
   vector<string> input;
   for (int i : Range(1000)) {
     string ret;
-    int parts = chooseRandom({1, 2}, {3, 1});
+    int parts = random.choose({1, 2}, {3, 1});
     for (int k : Range(parts))
-      ret += getWord() + " ";
+      ret += getWord(random) + " ";
     trim(ret);
     input.push_back(ret);
   }
-  scrolls = NameGenerator(input);
+  scrolls = NameGenerator(random, input);
 
-  firstNames = NameGenerator(readLines(firstNamesPath));
-  aztecNames = NameGenerator(readLines(aztecNamesPath));
-  creatureNames = NameGenerator(readLines(creatureNamesPath));
-  weaponNames = NameGenerator(readLines(weaponNamesPath));
-  worldNames = NameGenerator(readLines(worldsPath), true);
-  townNames = NameGenerator(readLines(townsPath));
-  deityNames = NameGenerator(readLines(deitiesPath));
-  dwarfNames = NameGenerator(readLines(dwarfsPath));
-  demonNames = NameGenerator(readLines(demonsPath));
-  dogNames = NameGenerator(readLines(dogsPath));
+  firstNames = NameGenerator(random, readLines(firstNamesPath));
+  aztecNames = NameGenerator(random, readLines(aztecNamesPath));
+  creatureNames = NameGenerator(random, readLines(creatureNamesPath));
+  weaponNames = NameGenerator(random, readLines(weaponNamesPath));
+  worldNames = NameGenerator(random, readLines(worldsPath), true);
+  townNames = NameGenerator(random, readLines(townsPath));
+  deityNames = NameGenerator(random, readLines(deitiesPath));
+  dwarfNames = NameGenerator(random, readLines(dwarfsPath));
+  demonNames = NameGenerator(random, readLines(demonsPath));
+  dogNames = NameGenerator(random, readLines(dogsPath));
 }
 
 
 string NameGenerator::getNext() {
   CHECK(!names.empty()) << "Out of names!";
+  if (stream >= 0 && !oneName) {
+    // A stream that runs out reuses the names of the others rather than failing.
+    int index = (stream + numStreams * numTaken[stream]++) % names.size();
+    return names[index];
+  }
   string ret = names.front();
   if (!oneName)
-    names.pop();
+    names.pop_front();
   return ret;
 }
 
+vector<NameGenerator*> NameGenerator::getAll() {
+  return {&scrolls, &firstNames, &aztecNames, &creatureNames, &weaponNames, &worldNames, &townNames, &dwarfNames,
+      &deityNames, &demonNames, &dogNames};
+}
+
+void NameGenerator::startStreams(int num) {
+  numStreams = num;
+  for (NameGenerator* generator : getAll())
+    generator->numTaken.assign(num, 0);
+}
+
+void NameGenerator::setStream(int index) {
+  CHECK(index < numStreams);
+  stream = index;
+}
+
+void NameGenerator::endStreams(const vector<int>& kept) {
+  for (NameGenerator* generator : getAll()) {
+    vector<bool> taken(generator->names.size(), false);
+    for (int i : kept)
+      for (int j = i; j < i + numStreams * generator->numTaken[i] && j < taken.size(); j += numStreams)
+        taken[j] = true;
+    deque<string> left;
+    for (int i : All(generator->names))
+      if (!taken[i])
+        left.push_back(generator->names[i]);
+    if (!generator->oneName)
+      generator->names = left;
+    generator->numTaken.clear();
+  }
+  numStreams = 0;
+}
   
-NameGenerator::NameGenerator(vector<string> list, bool oneN) : oneName(oneN) {
-  for (string name : randomPermutation(list))
-    names.push(name);
+NameGenerator::NameGenerator(RandomGen& random, vector<string> list, bool oneN) : oneName(oneN) {
+  for (string name : random.permutation(list))
+    names.push_back(name);
 }
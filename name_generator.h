@@ -1,6 +1,8 @@
 #ifndef _NAME_GENERATOR
 #define _NAME_GENERATOR
 
+#include "util.h"
+
 class NameGenerator {
   public:
   NameGenerator() = default;
@@ -18,7 +20,8 @@ class NameGenerator {
   static NameGenerator demonNames;
   static NameGenerator dogNames;
 
-  static void init(
+  /** Reads the names and shuffles them with the given stream.*/
+  static void init(RandomGen&,
       const string& firstNamesPath,
       const string& aztecNamesPath,
       const string& specialCreaturesPath,
@@ -29,10 +32,26 @@ class NameGenerator {
       const string& deitiesPath,
       const string& demonsPath,
       const string& dogsPath);
+
+  /** While levels are generated on several threads, each takes its names from its own stream, so that they
+      don't depend on the order of the threads. Stream i gets every numStreams-th name, starting from the i-th.*/
+  static void startStreams(int numStreams);
+
+  /** Chooses the stream for names taken on this thread. -1 takes them from the front again.*/
+  static void setStream(int index);
+
+  /** Drops the names that were taken from the given streams. Names taken from the other streams can be given
+      out again.*/
+  static void endStreams(const vector<int>& kept);
+
   private:
-  NameGenerator(vector<string> names, bool oneName = false);
-  queue<string> names;
+  NameGenerator(RandomGen&, vector<string> names, bool oneName = false);
+  static vector<NameGenerator*> getAll();
+  deque<string> names;
   bool oneName;
+  vector<int> numTaken;
+  static int numStreams;
+  static thread_local int stream;
 };
 
 #endif
@@ -120,7 +120,7 @@ string Deity::getHabitatString() const {
 
 static void grantGift(Creature* c, ItemId id, string deity, int num = 1) {
   c->privateMessage(deity + " grants you a gift.");
-  c->takeItems(ItemFactory::fromId(id, num), nullptr);
+  c->takeItems(ItemFactory::fromId(c->getRandom(), id, num), nullptr);
 }
 
 static void applyEffect(Creature* c, EffectType effect, string msg) {
@@ -130,14 +130,14 @@ static void applyEffect(Creature* c, EffectType effect, string msg) {
 
 void Deity::onPrayer(Creature* c) {
   bool prayerAnswered = false;
-  for (Epithet epithet : randomPermutation(epithets)) {
+  for (Epithet epithet : c->getRandom().permutation(epithets)) {
     if (contains(usedEpithets, epithet))
       continue;
     bool noEffect = false;
     switch (epithet) {
       case Epithet::DEATH: {
-          PCreature death = CreatureFactory::fromId(CreatureId::DEATH, Tribe::killEveryone);
-          for (Vec2 v : c->getPosition().neighbors8(true))
+          PCreature death = CreatureFactory::fromId(c->getRandom(), CreatureId::DEATH, Tribe::killEveryone);
+          for (Vec2 v : c->getPosition().neighbors8(c->getRandom()))
             if (c->getLevel()->inBounds(v) && c->getLevel()->getSquare(v)->canEnter(death.get())) {
               c->privateMessage("Death appears before you.");
               c->getLevel()->addCreature(v, std::move(death));
@@ -147,10 +147,10 @@ void Deity::onPrayer(Creature* c) {
             noEffect = true;
           break; }
       case Epithet::WAR:
-          grantGift(c, chooseRandom(
+          grantGift(c, c->getRandom().choose(
           {ItemId::SPECIAL_SWORD, ItemId::SPECIAL_BATTLE_AXE, ItemId::SPECIAL_WAR_HAMMER}), name); break;
       case Epithet::WISDOM: grantGift(c, 
-          chooseRandom({ItemId::MUSHROOM_BOOK, ItemId::POTION_BOOK, ItemId::AMULET_BOOK}), name); break;
+          c->getRandom().choose({ItemId::MUSHROOM_BOOK, ItemId::POTION_BOOK, ItemId::AMULET_BOOK}), name); break;
       case Epithet::DESTRUCTION: applyEffect(c, EffectType::DESTROY_EQUIPMENT, ""); break;
       case Epithet::SECRETS: grantGift(c, ItemId::INVISIBLE_POTION, name); break;
       case Epithet::LIGHTNING:
@@ -159,15 +159,15 @@ void Deity::onPrayer(Creature* c) {
           break;
       case Epithet::FEAR: applyEffect(c, EffectType::PANIC, name + " puts fear in your heart"); break;
       case Epithet::MIND: 
-          if (Random.roll(2))
+          if (c->getRandom().roll(2))
             applyEffect(c, EffectType::RAGE, name + " fills your head with anger");
           else
             applyEffect(c, EffectType::HALLU, "");
           break;
       case Epithet::CHANGE:
-          if (Random.roll(2) && c->getEquipment().getItem(EquipmentSlot::WEAPON)) {
-            PCreature snake = CreatureFactory::fromId(CreatureId::SNAKE, Tribe::pest);
-            for (Vec2 v : c->getPosition().neighbors8(true))
+          if (c->getRandom().roll(2) && c->getEquipment().getItem(EquipmentSlot::WEAPON)) {
+            PCreature snake = CreatureFactory::fromId(c->getRandom(), CreatureId::SNAKE, Tribe::pest);
+            for (Vec2 v : c->getPosition().neighbors8(c->getRandom()))
               if (c->getLevel()->inBounds(v) && c->getLevel()->getSquare(v)->canEnter(snake.get())) {
                 c->getLevel()->addCreature(v, std::move(snake));
                 c->steal({c->getEquipment().getItem(EquipmentSlot::WEAPON)});
@@ -178,23 +178,23 @@ void Deity::onPrayer(Creature* c) {
             if (!snake)
               break;
           }
-          for (Item* it : randomPermutation(c->getEquipment().getItems())) {
+          for (Item* it : c->getRandom().permutation(c->getEquipment().getItems())) {
             if (it->getType() == ItemType::POTION) {
               c->privateMessage("Your " + it->getName() + " changes color!");
               c->steal({it});
-              c->take(ItemFactory::potions().random());
+              c->take(ItemFactory::potions().random(c->getRandom()));
               break;
             }
             if (it->getType() == ItemType::SCROLL) {
               c->privateMessage("Your " + it->getName() + " changes label!");
               c->steal({it});
-              c->take(ItemFactory::scrolls().random());
+              c->take(ItemFactory::scrolls().random(c->getRandom()));
               break;
             }
             if (it->getType() == ItemType::AMULET) {
               c->privateMessage("Your " + it->getName() + " changes shape!");
               c->steal({it});
-              c->take(ItemFactory::amulets().random());
+              c->take(ItemFactory::amulets().random(c->getRandom()));
               break;
             }
           }
@@ -203,19 +203,19 @@ void Deity::onPrayer(Creature* c) {
           if (c->getHealth() < 1 || c->lostLimbs())
             applyEffect(c, EffectType::HEAL, "You feel a healing power overcoming you");
           else {
-            if (Random.roll(4))
+            if (c->getRandom().roll(4))
               grantGift(c, ItemId::HEALING_AMULET, name);
             else
-              grantGift(c, ItemId::HEALING_POTION, name, Random.getRandom(1, 4));
+              grantGift(c, ItemId::HEALING_POTION, name, c->getRandom().getRandom(1, 4));
           }
           break;
       case Epithet::NATURE: grantGift(c, ItemId::FRIENDLY_ANIMALS_AMULET, name); break;
 //      case Epithet::LOVE: grantGift(c, ItemId::PANIC_MUSHROOM, name); break;
-      case Epithet::WEALTH: grantGift(c, ItemId::GOLD_PIECE, name, Random.getRandom(100, 200)); break;
+      case Epithet::WEALTH: grantGift(c, ItemId::GOLD_PIECE, name, c->getRandom().getRandom(100, 200)); break;
       case Epithet::DEFENSE: grantGift(c, ItemId::DEFENSE_AMULET, name); break;
       case Epithet::DARKNESS: applyEffect(c, EffectType::BLINDNESS, ""); break;
       case Epithet::CRAFTS: applyEffect(c,
-          chooseRandom({EffectType::ENHANCE_ARMOR, EffectType::ENHANCE_WEAPON}), ""); break;
+          c->getRandom().choose({EffectType::ENHANCE_ARMOR, EffectType::ENHANCE_WEAPON}), ""); break;
 //      case Epithet::HUNTING: grantGift(c, ItemId::PANIC_MUSHROOM, name); break;
       default: noEffect = true;
     }
@@ -229,20 +229,20 @@ void Deity::onPrayer(Creature* c) {
     c->privateMessage("Your prayer is not answered.");
 }
 
-vector<Deity*> generateDeities() {
+vector<Deity*> generateDeities(RandomGen& random) {
   set<Epithet> used;
   vector<Deity*> ret;
   for (auto elem : epithetsMap) {
     string deity = NameGenerator::deityNames.getNext();
     Gender gend = Gender::MALE;
-    if ((deity.back() == 'a' || deity.back() == 'i') && !Random.roll(4))
+    if ((deity.back() == 'a' || deity.back() == 'i') && !random.roll(4))
       gend = Gender::FEMALE;
     vector<Epithet> ep;
-    for (int i : Range(Random.getRandom(1, 4))) {
+    for (int i : Range(random.getRandom(1, 4))) {
       Epithet epithet;
       int cnt = 100;
       do {
-        epithet = chooseRandom(elem.second);
+        epithet = random.choose(elem.second);
       } while (used.count(epithet) && --cnt > 0);
       if (cnt == 0)
         break;
@@ -250,14 +250,15 @@ vector<Deity*> generateDeities() {
       ep.push_back(epithet);
     }
     if (ep.empty())
-      return generateDeities();
+      return generateDeities(random);
     ret.push_back(new Deity(deity, gend, ep, elem.first)); 
   }
   return ret;
 }
 
 vector<Deity*> Deity::getDeities() {
-  static vector<Deity*> deities = generateDeities();
+  static RandomGen random = RandomGen::getStream(RandomStream::PANTHEON);
+  static vector<Deity*> deities = generateDeities(random);
   return deities;
 }
 
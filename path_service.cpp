@@ -0,0 +1,125 @@
+#include "stdafx.h"
+
+#include "path_service.h"
+#include "creature.h"
+#include "level.h"
+
+using namespace std;
+
+PathQuery::PathQuery(const Creature* c, Vec2 t, bool a) : creature(c), target(t), away(a) {
+}
+
+Vec2 PathQuery::getTarget() const {
+  return target;
+}
+
+bool PathQuery::isAway() const {
+  return away;
+}
+
+bool PathQuery::isAnswered() const {
+  return answered;
+}
+
+Optional<ShortestPath>& PathQuery::getPath() {
+  return path;
+}
+
+void PathQuery::answer() {
+  if (!creature->isDead())
+    path = ShortestPath(creature->getLevel(), creature, target, creature->getPosition(), away ? -1.5 : 0);
+  answered = true;
+}
+
+bool PathService::enabled = false;
+vector<shared_ptr<PathQuery>> PathService::pending;
+vector<shared_ptr<PathQuery>> PathService::batch;
+atomic<int> PathService::nextInBatch(0);
+vector<thread> PathService::workers;
+mutex PathService::mut;
+condition_variable PathService::batchReady;
+condition_variable PathService::batchDone;
+int PathService::batchNum = 0;
+int PathService::numBusy = 0;
+bool PathService::stopping = false;
+
+void PathService::init(int numWorkers) {
+  stopWorkers();
+  enabled = true;
+  for (int i : Range(numWorkers))
+    workers.emplace_back(workerLoop);
+  static bool stopAtExit = false;
+  if (!stopAtExit) {
+    atexit(stopWorkers);
+    stopAtExit = true;
+  }
+}
+
+bool PathService::isEnabled() {
+  return enabled;
+}
+
+shared_ptr<PathQuery> PathService::submit(const Creature* c, Vec2 target, bool away) {
+  CHECK(enabled);
+  pending.push_back(make_shared<PathQuery>(c, target, away));
+  return pending.back();
+}
+
+void PathService::processQueries() {
+  // Queries no longer held by their creature aren't needed.
+  for (shared_ptr<PathQuery>& query : pending)
+    if (query.use_count() > 1)
+      batch.push_back(std::move(query));
+  pending.clear();
+  if (batch.empty())
+    return;
+  nextInBatch = 0;
+  {
+    lock_guard<mutex> lock(mut);
+    numBusy = workers.size();
+    ++batchNum;
+  }
+  batchReady.notify_all();
+  answerBatch();
+  {
+    unique_lock<mutex> lock(mut);
+    batchDone.wait(lock, [] { return numBusy == 0; });
+  }
+  batch.clear();
+}
+
+void PathService::answerBatch() {
+  for (int i = nextInBatch++; i < batch.size(); i = nextInBatch++)
+    batch[i]->answer();
+}
+
+void PathService::workerLoop() {
+  int lastBatch = 0;
+  while (1) {
+    {
+      unique_lock<mutex> lock(mut);
+      batchReady.wait(lock, [&] { return stopping || batchNum != lastBatch; });
+      if (stopping)
+        return;
+      lastBatch = batchNum;
+    }
+    answerBatch();
+    {
+      lock_guard<mutex> lock(mut);
+      if (--numBusy == 0)
+        batchDone.notify_one();
+    }
+  }
+}
+
+void PathService::stopWorkers() {
+  {
+    lock_guard<mutex> lock(mut);
+    stopping = true;
+  }
+  batchReady.notify_all();
+  for (thread& t : workers)
+    t.join();
+  workers.clear();
+  stopping = false;
+}
@@ -0,0 +1,64 @@
+#ifndef _PATH_SERVICE_H
+#define _PATH_SERVICE_H
+
+#include "util.h"
+#include "shortest_path.h"
+
+class Creature;
+
+/** A path search requested by a creature. It's answered from the position that the creature has when the
+    batch is processed.*/
+class PathQuery {
+  public:
+  PathQuery(const Creature* creature, Vec2 target, bool away);
+
+  Vec2 getTarget() const;
+  bool isAway() const;
+  bool isAnswered() const;
+
+  /** Returns the path, or Nothing if the creature died before the query was answered.*/
+  Optional<ShortestPath>& getPath();
+
+  void answer();
+
+  private:
+  const Creature* creature;
+  Vec2 target;
+  bool away;
+  bool answered = false;
+  Optional<ShortestPath> path;
+};
+
+/** Answers the path queries of creatures on a pool of worker threads. Queries submitted while creatures move
+    are answered together at the start of the next Model::update, when nothing in the world changes, so the
+    results don't depend on the number of threads.*/
+class PathService {
+  public:
+  /** Enables the service. With no workers the queries are answered on the calling thread.*/
+  static void init(int numWorkers);
+  static bool isEnabled();
+
+  static std::shared_ptr<PathQuery> submit(const Creature*, Vec2 target, bool away);
+
+  /** Answers all pending queries and waits for the workers to finish.*/
+  static void processQueries();
+
+  private:
+  static void workerLoop();
+  static void answerBatch();
+  static void stopWorkers();
+
+  static bool enabled;
+  static vector<std::shared_ptr<PathQuery>> pending;
+  static vector<std::shared_ptr<PathQuery>> batch;
+  static std::atomic<int> nextInBatch;
+  static vector<std::thread> workers;
+  static std::mutex mut;
+  static std::condition_variable batchReady;
+  static std::condition_variable batchDone;
+  static int batchNum;
+  static int numBusy;
+  static bool stopping;
+};
+
+#endif
@@ -16,7 +16,7 @@ void PoisonGas::tick(Level* level, Vec2 pos) {
     amount = 0;
     return;
   }
-  for (Vec2 v : Vec2::directions8(true)) {
+  for (Vec2 v : Vec2::directions8(level->getRandom())) {
     Square* square = level->getSquare(pos + v);
     if (square->canSeeThru() && amount > 0 && square->getPoisonGasAmount() < amount) {
       double transfer = v.isCardinal4() ? spread : spread / 2;
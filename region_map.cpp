@@ -0,0 +1,184 @@
+#include "stdafx.h"
+
+#include "region_map.h"
+
+using namespace std;
+
+static const vector<Vec2> directions = Vec2::directions8();
+
+RegionMap::RegionMap(Rectangle b, function<bool(Vec2)> fun) : bounds(b), isPassable(fun), regions(b, -1) {
+  for (Vec2 pos : bounds)
+    if (regions[pos] == -1 && isPassable(pos))
+      fill(pos, addRegion());
+}
+
+int RegionMap::getRegion(Vec2 pos) const {
+  return regions[pos];
+}
+
+int RegionMap::addRegion() {
+  sizes.push_back(0);
+  return sizes.size() - 1;
+}
+
+/** Labels the squares connected to start with the region, replacing their old label.*/
+void RegionMap::fill(Vec2 start, int region) {
+  int oldRegion = regions[start];
+  vector<Vec2> queue {start};
+  regions[start] = region;
+  while (!queue.empty()) {
+    Vec2 pos = queue.back();
+    queue.pop_back();
+    if (oldRegion > -1)
+      --sizes[oldRegion];
+    ++sizes[region];
+    for (Vec2 dir : directions) {
+      Vec2 next = pos + dir;
+      if (next.inRectangle(bounds) && regions[next] == oldRegion && (oldRegion > -1 || isPassable(next))) {
+        regions[next] = region;
+        queue.push_back(next);
+      }
+    }
+  }
+}
+
+vector<int> RegionMap::getNeighbourRegions(Vec2 pos) const {
+  vector<int> ret;
+  for (Vec2 dir : directions)
+    if ((pos + dir).inRectangle(bounds) && regions[pos + dir] > -1 && !contains(ret, regions[pos + dir]))
+      ret.push_back(regions[pos + dir]);
+  return ret;
+}
+
+bool RegionMap::canReach(Vec2 from, Vec2 to) const {
+  if (from.dist8(to) <= 1)
+    return true;
+  // The square before the target and the one after the start are passable, so they share a region.
+  vector<int> fromRegions = getNeighbourRegions(from);
+  for (int region : getNeighbourRegions(to))
+    if (contains(fromRegions, region))
+      return true;
+  return false;
+}
+
+void RegionMap::squareChanged(Vec2 pos) {
+  bool passable = isPassable(pos);
+  if (passable == (regions[pos] > -1))
+    return;
+  if (passable)
+    merge(pos);
+  else {
+    int region = regions[pos];
+    regions[pos] = -1;
+    --sizes[region];
+    split(pos, region);
+  }
+}
+
+/** Joins the regions around a square that became passable. The smaller regions are relabelled.*/
+void RegionMap::merge(Vec2 pos) {
+  vector<int> neighbours = getNeighbourRegions(pos);
+  if (neighbours.empty()) {
+    regions[pos] = addRegion();
+    ++sizes[regions[pos]];
+    return;
+  }
+  int largest = neighbours[0];
+  for (int region : neighbours)
+    if (sizes[region] > sizes[largest])
+      largest = region;
+  regions[pos] = largest;
+  ++sizes[largest];
+  for (Vec2 dir : directions) {
+    Vec2 next = pos + dir;
+    if (next.inRectangle(bounds) && regions[next] > -1 && regions[next] != largest)
+      fill(next, largest);
+  }
+}
+
+/** Checks if the region of a square that became blocked fell apart. The squares around it that stay connected
+    without it are grouped, and a search is run from each group at the same pace. Groups whose searches meet
+    are connected. When a group's search runs out of squares, it's a new region. This stops as soon as a single
+    group is left searching, so the work is proportional to the smaller parts.*/
+void RegionMap::split(Vec2 pos, int region) {
+  vector<Vec2> around;
+  for (Vec2 dir : directions)
+    if ((pos + dir).inRectangle(bounds) && regions[pos + dir] == region)
+      around.push_back(pos + dir);
+  vector<int> group(around.size());
+  for (int i : All(around))
+    group[i] = i;
+  // Squares next to each other stay connected, and the sets are tiny, so relabelling is enough.
+  for (int i : All(around))
+    for (int j : All(around))
+      if (around[i].dist8(around[j]) == 1 && group[i] != group[j]) {
+        int old = group[j];
+        for (int& g : group)
+          if (g == old)
+            g = group[i];
+      }
+  vector<int> groups;
+  vector<vector<Vec2>> queues;
+  for (int i : All(around))
+    if (!contains(groups, group[i])) {
+      groups.push_back(group[i]);
+      queues.push_back({around[i]});
+    }
+  if (groups.size() < 2)
+    return;
+  // A search that met another continues as part of the same group.
+  vector<int> owner(groups.size());
+  for (int i : All(owner))
+    owner[i] = i;
+  auto getOwner = [&](int search) {
+    while (owner[search] != search)
+      search = owner[search];
+    return search;
+  };
+  unordered_map<Vec2, int> visited;
+  for (int i : All(queues))
+    visited[queues[i][0]] = i;
+  vector<int> finished;
+  int numSearching = groups.size();
+  while (numSearching > 1) {
+    for (int i : All(queues))
+      if (!queues[i].empty()) {
+        Vec2 v = queues[i].back();
+        queues[i].pop_back();
+        for (Vec2 dir : directions) {
+          Vec2 next = v + dir;
+          if (!next.inRectangle(bounds) || regions[next] != region)
+            continue;
+          auto elem = visited.find(next);
+          if (elem == visited.end()) {
+            visited[next] = i;
+            queues[i].push_back(next);
+          } else if (getOwner(elem->second) != getOwner(i)) {
+            owner[getOwner(elem->second)] = getOwner(i);
+            --numSearching;
+          }
+        }
+      }
+    for (int i : All(queues))
+      if (getOwner(i) == i && !contains(finished, i)) {
+        bool done = true;
+        for (int j : All(queues))
+          if (getOwner(j) == i && !queues[j].empty())
+            done = false;
+        if (done) {
+          finished.push_back(i);
+          --numSearching;
+        }
+      }
+  }
+  // The searches that ran out of squares have visited all of their new regions.
+  for (int search : finished) {
+    int newRegion = addRegion();
+    for (auto& elem : visited)
+      if (getOwner(elem.second) == search) {
+        regions[elem.first] = newRegion;
+        --sizes[region];
+        ++sizes[newRegion];
+      }
+  }
+}
@@ -0,0 +1,37 @@
+#ifndef _REGION_MAP_H
+#define _REGION_MAP_H
+
+#include "util.h"
+
+/** Labels the connected regions of the squares that a creature can move through. Two squares are connected if
+    there is a path between them, so a path query between different regions can fail without a search. The labels
+    are updated when a square changes: a new passable square merges the regions around it, and a new blocked
+    square may split its region.*/
+class RegionMap {
+  public:
+  /** The function tells if a creature can move through a square, possibly after destroying it.*/
+  RegionMap(Rectangle bounds, function<bool(Vec2)> isPassable);
+
+  /** Returns the region of the square, or -1 if it's blocked.*/
+  int getRegion(Vec2 pos) const;
+
+  /** Tells if a creature standing on from can reach to. Neither of the squares needs to be passable, like in
+      ShortestPath.*/
+  bool canReach(Vec2 from, Vec2 to) const;
+
+  void squareChanged(Vec2 pos);
+
+  private:
+  int addRegion();
+  void fill(Vec2 start, int region);
+  void merge(Vec2 pos);
+  void split(Vec2 pos, int region);
+  vector<int> getNeighbourRegions(Vec2 pos) const;
+
+  Rectangle bounds;
+  function<bool(Vec2)> isPassable;
+  Table<int> regions;
+  vector<int> sizes;
+};
+
+#endif
@@ -3,143 +3,146 @@
 #include "shortest_path.h"
 #include "level.h"
 #include "creature.h"
+#include "benchmark.h"
 
 using namespace std;
 
 const double ShortestPath::infinity = 1000000000;
 
-const int revShortestLimit = 15;
+const int ShortestPath::revShortestLimit;
 
-const int maxSize = 600;
+int ShortestPath::turnBudget = 30000;
+int ShortestPath::budgetLeft = 30000;
 
-Table<double> ddist(maxSize, maxSize);
-Table<int> dirty(maxSize, maxSize, 0);
-int counter = 1;
+const int maxSize = 600;
 
 int margin = 15;
 
-ShortestPath::ShortestPath(const Level* level, const Creature* creature, Vec2 to, Vec2 from, double mult,
-    bool avoidEnemies) : target(to), directions(Vec2::directions8()), bounds(level->getBounds()) {
-  CHECK(level->getBounds().getKX() <= maxSize && level->getBounds().getKY() <= maxSize);
-  auto entryFun = [=](Vec2 pos) { 
-      if (level->getSquare(pos)->canEnter(creature) || creature->getPosition() == pos) 
-        return 1.0;
-      if ((level->getSquare(pos)->canEnterEmpty(creature) || level->getSquare(pos)->canDestroy())
-          && (!avoidEnemies || !level->getSquare(pos)->getCreature() 
-              || !level->getSquare(pos)->getCreature()->isEnemy(creature)))
-        return 5.0;
-      return infinity;};
-  CHECK(to.inRectangle(level->getBounds()));
-  CHECK(from.inRectangle(level->getBounds()));
-  if (mult == 0) {
-    // Use a suboptimal, but faster pathfinding.
-    init(entryFun, [](Vec2 v)->double { return 2 * v.lengthD(); }, target, from);
-  } else {
-    auto lengthFun = [](Vec2 v)->double { return v.length8(); };
-    bounds = bounds.intersection(Rectangle(min(to.x, from.x) - margin, min(to.y, from.y) - margin,
-        max(to.x, from.x) + margin, max(to.y, from.y) + margin));
-    init(entryFun, lengthFun, target, Nothing(), revShortestLimit);
-    setDistance(target, infinity);
-    reverse(entryFun, lengthFun, mult, from, revShortestLimit);
-  }
+// Paths longer than this are planned on the level's cluster graph first.
+const int hierarchicalDistance = 2 * ClusterGraph::clusterSize;
+
+ShortestPath::Workspace::Workspace() : distance(maxSize, maxSize), dirty(maxSize, maxSize, 0) {
 }
 
-ShortestPath::ShortestPath(Rectangle a, function<double(Vec2)> entryFun, function<int(Vec2)> lengthFun,
-    vector<Vec2> dir, Vec2 to, Vec2 from, double mult) : target(to), directions(dir), bounds(a) {
-  CHECK(a.getKX() <= maxSize && a.getKY() <= maxSize && a.getPX() >= 0 && a.getPY() >= 0);
-  if (mult == 0)
-    init(entryFun, lengthFun, target, from);
-  else {
-    init(entryFun, lengthFun, target, Nothing(), revShortestLimit);
-    setDistance(target, infinity);
-    reverse(entryFun, lengthFun, mult, from, revShortestLimit);
-  }
+ShortestPath::Workspace& ShortestPath::getWorkspace() {
+  static thread_local Workspace workspace;
+  return workspace;
 }
 
-double ShortestPath::getDistance(Vec2 v) const {
-  return dirty[v] < counter ? infinity : ddist[v];
+void ShortestPath::startSearch() {
+  workspace = &getWorkspace();
+  ++workspace->counter;
 }
-void ShortestPath::setDistance(Vec2 v, double d) {
-  ddist[v] = d;
-  dirty[v] = counter;
+
+ShortestPath::ShortestPath(Rectangle a, vector<Vec2> dir, Vec2 to) : workspace(&getWorkspace()), target(to),
+    directions(dir), bounds(a) {
+  CHECK(a.getKX() <= maxSize && a.getKY() <= maxSize && a.getPX() >= 0 && a.getPY() >= 0);
 }
 
-void ShortestPath::init(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, Vec2 target,
-    Optional<Vec2> from, Optional<int> limit) {
+template <class EntryFun>
+bool ShortestPath::initFromWaypoints(EntryFun entryFun, const vector<Vec2>& waypoints) {
   reversed = false;
-  ++counter;
-  function<bool(Vec2, Vec2)> comparator;
-  if (from)
-    comparator = [=](Vec2 pos1, Vec2 pos2) {
-      return this->getDistance(pos1) + lengthFun(*from - pos1) > this->getDistance(pos2) + lengthFun(*from - pos2); };
-  else
-    comparator = [this](Vec2 pos1, Vec2 pos2) { return this->getDistance(pos1) > this->getDistance(pos2); };
-  priority_queue<Vec2, vector<Vec2>, decltype(comparator)> q(comparator) ;
-  setDistance(target, 0);
-  q.push(target);
-  int numPopped = 0;
-  while (!q.empty()) {
-    ++numPopped;
-    Vec2 pos = q.top();
-   // Debug() << "Popping " << pos << " " << distance[pos]  << " " << (from ? (*from - pos).length4() : 0);
-    if (from == pos || (limit && getDistance(pos) >= *limit)) {
-      Debug() << "Shortest path from " << (from ? *from : Vec2(-1, -1)) << " to " << target << " " << numPopped << " visited distance " << getDistance(pos);
-      constructPath(pos);
-      return;
+  vector<Vec2> route {waypoints[0]};
+  for (int i = 1; i < waypoints.size(); ++i) {
+    Vec2 from = waypoints[i - 1];
+    Vec2 to = waypoints[i];
+    if (from.dist8(to) == 1) {
+      route.push_back(to);
+      continue;
     }
-    q.pop();
-    for (Vec2 dir : directions) {
-      Vec2 next = pos + dir;
-      if (next.inRectangle(bounds)) {
-        double cdist = getDistance(pos);
-        double ndist = getDistance(next);
-        if (cdist < ndist) {
-          double dist = cdist + entryFun(next);
-          CHECK(dist > cdist) << "Entry fun non positive " << dist - cdist;
-          if (dist < ndist) {
-            setDistance(next, dist);
-            q.push(next);
-          }
-        }
-      }
+    // Waypoints that aren't adjacent are connected inside their cluster.
+    ShortestPath leg(ClusterGraph::getCluster(bounds, from), entryFun, [](Vec2 v) { return int(2 * v.lengthD()); },
+        directions, to, from);
+    if (!leg.isReachable(from)) {
+      Debug() << "Couldn't refine the cluster path from " << from << " to " << to;
+      return false;
     }
+    for (int j = leg.path.size() - 2; j >= 0; --j)
+      route.push_back(leg.path[j]);
   }
-  Debug() << "Shortest path exhausted, " << numPopped << " visited";
+  path = vector<Vec2>(route.rbegin(), route.rend());
+  return true;
 }
 
-void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, double mult, Vec2 from,
-    int limit) {
-  reversed = true;
-  function<bool(Vec2, Vec2)> comparator = [=](Vec2 pos1, Vec2 pos2) {
-    return this->getDistance(pos1) + lengthFun(from - pos1) > this->getDistance(pos2) + lengthFun(from - pos2); };
+/** The cost of entering a square of a level for a creature.*/
+class LevelEntryFun {
+  public:
+  LevelEntryFun(const Level* l, const Creature* c, bool avoid) : level(l), creature(c), avoidEnemies(avoid),
+      passable(&level->getPassableSquares(creature->getMovementType())),
+      destructible(&level->getDestructibleSquares()), occupied(&level->getOccupiedSquares()) {
+  }
 
-  priority_queue<Vec2, vector<Vec2>, decltype(comparator)> q(comparator) ;
-  for (Vec2 v : bounds) {
-    double dist = getDistance(v);
-    if (dist <= limit) {
-      setDistance(v, mult * dist);
-      q.push(v);
-    }
+  double operator() (Vec2 pos) const {
+    if (((*passable)[pos] && !(*occupied)[pos]) || creature->getPosition() == pos) 
+      return 1.0;
+    if (((*passable)[pos] || (*destructible)[pos])
+        && (!avoidEnemies || !(*occupied)[pos] || !level->getSquare(pos)->getCreature()->isEnemy(creature)))
+      return 5.0;
+    return ShortestPath::infinity;
   }
-  int numPopped = 0;
-  while (!q.empty()) {
-    ++numPopped;
-    Vec2 pos = q.top();
-    if (from == pos) {
-      Debug() << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
-      constructPath(pos, true);
+
+  private:
+  const Level* level;
+  const Creature* creature;
+  bool avoidEnemies;
+  const BitTable* passable;
+  const BitTable* destructible;
+  const BitTable* occupied;
+};
+
+static double levelLengthFun(Vec2 v) {
+  return 2 * v.lengthD();
+}
+
+ShortestPath::ShortestPath(const Level* level, const Creature* creature, Vec2 to, Vec2 from, double mult,
+    bool avoidEnemies, bool budgeted) : ShortestPath(level->getBounds(), Vec2::directions8(), to) {
+  MovementType movement = creature->getMovementType();
+  LevelEntryFun entryFun(level, creature, avoidEnemies);
+  CHECK(to.inRectangle(level->getBounds()));
+  CHECK(from.inRectangle(level->getBounds()));
+  if (mult == 0 && !level->canReach(movement, from, to)) {
+    Debug() << "No path from " << from << " to " << to << " in the level's regions";
+    reversed = false;
+    return;
+  }
+  if (mult == 0 && budgeted && turnBudget >= 0 && budgetLeft == 0) {
+    Debug() << "No budget left for the path from " << from << " to " << to;
+    reversed = false;
+    suspended.reset(new Suspended {level, avoidEnemies, {}, {}});
+    return;
+  }
+  if (mult == 0 && from.dist8(to) > hierarchicalDistance) {
+    // The search on the cluster graph and the legs between waypoints are charged to the budget, but they are
+    // never suspended.
+    long long numExpanded = -workspace->numExpanded;
+    Optional<vector<Vec2>> waypoints = level->getClusterWaypoints(movement, from, to, &numExpanded);
+    bool found = waypoints && initFromWaypoints(entryFun, *waypoints);
+    numExpanded += workspace->numExpanded;
+    if (budgeted)
+      chargeBudget(numExpanded);
+    if (!waypoints) {
+      Debug() << "No path from " << from << " to " << to << " on the cluster graph";
+      reversed = false;
       return;
     }
-    q.pop();
-    for (Vec2 dir : directions)
-      if ((pos + dir).inRectangle(bounds)) {
-        if (getDistance(pos + dir) > getDistance(pos) + entryFun(pos + dir) && getDistance(pos + dir) < 0) {
-          setDistance(pos + dir, getDistance(pos) + entryFun(pos + dir));
-          q.push(pos + dir);
-        }
-      }
+    if (found)
+      return;
+  }
+  if (mult == 0) {
+    // Use a suboptimal, but faster pathfinding.
+    init(entryFun, levelLengthFun, target, from, Nothing(), budgeted);
+    if (suspended) {
+      suspended->level = level;
+      suspended->avoidEnemies = avoidEnemies;
+    }
+  } else {
+    auto lengthFun = [](Vec2 v)->double { return v.length8(); };
+    bounds = bounds.intersection(Rectangle(min(to.x, from.x) - margin, min(to.y, from.y) - margin,
+        max(to.x, from.x) + margin, max(to.y, from.y) + margin));
+    init(entryFun, lengthFun, target, Nothing(), revShortestLimit);
+    setDistance(target, infinity);
+    reverse(entryFun, lengthFun, mult, from, revShortestLimit);
   }
-  Debug() << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
 }
 
 void ShortestPath::constructPath(Vec2 pos, bool reversed) {
@@ -169,6 +172,180 @@ void ShortestPath::constructPath(Vec2 pos, bool reversed) {
   path = vector<Vec2>(ret.rbegin(), ret.rend());
 }
 
+template <class EntryFun, class GoalFun>
+Optional<vector<Vec2>> ShortestPath::searchBack(EntryFun entryFun, Rectangle area, Vec2 start, GoalFun isGoal) {
+  startSearch();
+  Queue q;
+  setDistance(start, 0);
+  q.push({0, start});
+  while (!q.empty()) {
+    Vec2 pos = q.top().second;
+    double cdist = getDistance(pos);
+    if (q.top().first > cdist) {
+      q.pop();
+      continue;
+    }
+    if (isGoal(pos)) {
+      vector<Vec2> ret {pos};
+      while (ret.back() != start) {
+        Vec2 next = ret.back();
+        for (Vec2 dir : directions)
+          if ((ret.back() + dir).inRectangle(area) && getDistance(ret.back() + dir) < getDistance(next))
+            next = ret.back() + dir;
+        CHECK(next != ret.back()) << "can't track path";
+        ret.push_back(next);
+      }
+      return ret;
+    }
+    q.pop();
+    for (Vec2 dir : directions) {
+      Vec2 next = pos + dir;
+      if (next.inRectangle(area)) {
+        double dist = cdist + entryFun(next);
+        if (dist < infinity && dist < getDistance(next)) {
+          setDistance(next, dist);
+          q.push({dist, next});
+        }
+      }
+    }
+  }
+  return Nothing();
+}
+
+vector<Vec2> ShortestPath::getNearest(const Level* level, const MovementType& movement, Vec2 from,
+    const vector<Vec2>& goals, double margin) {
+  vector<Vec2> ret;
+  unordered_set<Vec2> reachable;
+  for (Vec2 v : goals)
+    if (level->canReach(movement, from, v))
+      reachable.insert(v);
+  if (reachable.empty())
+    return ret;
+  const BitTable& passable = level->getPassableSquares(movement);
+  const BitTable& destructible = level->getDestructibleSquares();
+  ShortestPath search(level->getBounds(), Vec2::directions8(), from);
+  search.startSearch();
+  Queue q;
+  search.setDistance(from, 0);
+  q.push({0, from});
+  double nearest = infinity;
+  while (!q.empty() && q.top().first <= nearest + margin && ret.size() < reachable.size()) {
+    pair<double, Vec2> elem = q.top();
+    q.pop();
+    Vec2 pos = elem.second;
+    if (elem.first > search.getDistance(pos))
+      continue;
+    if (reachable.count(pos)) {
+      nearest = min(nearest, elem.first);
+      ret.push_back(pos);
+    }
+    // A goal that can't be passed is only entered.
+    if (pos != from && !passable[pos] && !destructible[pos])
+      continue;
+    for (Vec2 dir : search.directions) {
+      Vec2 next = pos + dir;
+      if (!next.inRectangle(search.bounds))
+        continue;
+      double cost = passable[next] ? 1 : destructible[next] ? 5 : reachable.count(next) ? 1 : infinity;
+      if (cost < infinity && elem.first + cost < search.getDistance(next)) {
+        search.setDistance(next, elem.first + cost);
+        q.push({elem.first + cost, next});
+      }
+    }
+  }
+  return ret;
+}
+
+// The new target of a repaired path can be at most this far from the old one.
+const int maxTargetRepair = 5;
+
+bool ShortestPath::repairTarget(const Level* level, const Creature* creature, Vec2 pos, Vec2 newTarget) {
+  CHECK(isReachable(pos) && !reversed);
+  if (target.dist8(newTarget) > maxTargetRepair || !newTarget.inRectangle(bounds))
+    return false;
+  if (path.back() != pos)
+    path.pop_back();
+  unordered_map<Vec2, int> index;
+  for (int i : All(path))
+    index[path[i]] = i;
+  int radius = 2 * target.dist8(newTarget) + 2;
+  Rectangle area = bounds.intersection(Rectangle(newTarget.x - radius, newTarget.y - radius,
+        newTarget.x + radius + 1, newTarget.y + radius + 1));
+  Optional<vector<Vec2>> link = searchBack(LevelEntryFun(level, creature, false), area, newTarget,
+      [&](Vec2 v) { return index.count(v) > 0; });
+  if (!link)
+    return false;
+  // The link goes from a square of the path to the new target.
+  vector<Vec2> ret(link->rbegin(), link->rend());
+  ret.insert(ret.end(), path.begin() + index.at(link->front()) + 1, path.end());
+  path = ret;
+  target = newTarget;
+  return true;
+}
+
+// A detour can rejoin the path at most this many squares after the blocked square.
+const int maxDetour = 8;
+
+bool ShortestPath::repairBlocked(const Level* level, const Creature* creature, Vec2 pos) {
+  CHECK(isReachable(pos) && !reversed);
+  if (path.back() != pos)
+    path.pop_back();
+  if (path.size() < 3)
+    return false;
+  int blocked = path.size() - 2;
+  int last = max(0, blocked - maxDetour);
+  unordered_map<Vec2, int> index;
+  for (int i : Range(last, blocked))
+    index[path[i]] = i;
+  Rectangle area = bounds.intersection(Rectangle(min(pos.x, path[last].x) - 2, min(pos.y, path[last].y) - 2,
+        max(pos.x, path[last].x) + 3, max(pos.y, path[last].y) + 3));
+  LevelEntryFun entryFun(level, creature, false);
+  Vec2 blockedPos = path[blocked];
+  Optional<vector<Vec2>> detour = searchBack(
+      [&](Vec2 v) { return v == blockedPos ? infinity : entryFun(v); }, area, pos,
+      [&](Vec2 v) { return index.count(v) > 0; });
+  if (!detour)
+    return false;
+  path.resize(index.at(detour->front()));
+  path.insert(path.end(), detour->begin(), detour->end());
+  return true;
+}
+
+void ShortestPath::setTurnBudget(int expansions) {
+  turnBudget = budgetLeft = expansions;
+}
+
+int ShortestPath::getTurnBudget() {
+  return turnBudget;
+}
+
+void ShortestPath::startTurn() {
+  budgetLeft = turnBudget;
+}
+
+void ShortestPath::chargeBudget(int numExpanded) {
+  budgetLeft = max(0, budgetLeft - numExpanded);
+  Benchmark::add(BenchCounter::PATH_EXPANSIONS, numExpanded);
+}
+
+bool ShortestPath::isSuspended() const {
+  return !!suspended;
+}
+
+void ShortestPath::resume(const Level* level, const Creature* creature, Vec2 from) {
+  CHECK(suspended);
+  if (suspended->level != level || !level->canReach(creature->getMovementType(), from, target)) {
+    Debug() << "Dropping the suspended search to " << target;
+    suspended.reset();
+    return;
+  }
+  if (suspended->distance.empty()) {
+    *this = ShortestPath(level, creature, target, from, 0, suspended->avoidEnemies, true);
+    return;
+  }
+  resumeTowards(LevelEntryFun(level, creature, suspended->avoidEnemies), levelLengthFun, from);
+}
+
 bool ShortestPath::isReversed() const {
   return reversed;
 }
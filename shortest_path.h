@@ -7,19 +7,26 @@
 
 class Creature;
 class Level;
+class MovementType;
 
 class ShortestPath {
   public:
+  /** A budgeted search counts against the turn's budget, see setTurnBudget.*/
   ShortestPath(const Level* level, const Creature* creature, Vec2 target, Vec2 from, double mult = 0,
-      bool avoidEnemies = false);
+      bool avoidEnemies = false, bool budgeted = false);
+
+  /** The entry function returns the cost of entering a square and the length function estimates the cost of a
+      path of the given vector. Any callables can be passed, and each combination gets its own search.*/
+  template <class EntryFun, class LengthFun>
   ShortestPath(
       Rectangle area,
-      function<double(Vec2)> entryFun,
-      function<int(Vec2)> lengthFun,
+      EntryFun entryFun,
+      LengthFun lengthFun,
       vector<Vec2> directions,
       Vec2 target,
       Vec2 from,
-      double mult = 0);
+      double mult = 0,
+      bool budgeted = false);
   ShortestPath(ShortestPath&&) = default;
   ShortestPath& operator=(ShortestPath&&) = default;
   bool isReachable(Vec2 pos) const;
@@ -27,20 +34,258 @@ class ShortestPath {
   Vec2 getTarget() const;
   bool isReversed() const;
 
+  /** Moves the target of a path found on the level. The search goes from the new target back to the path, so
+      the rest of the path is kept. Returns false if the new target isn't close to the path.*/
+  bool repairTarget(const Level*, const Creature*, Vec2 pos, Vec2 target);
+
+  /** Finds a way around the blocked square after pos that rejoins the path a few squares later. Returns false
+      if there is none nearby.*/
+  bool repairBlocked(const Level*, const Creature*, Vec2 pos);
+
+  /** Returns the goals that are nearest to from by walking distance for the movement type, in a single search
+      that stops at the nearest one. Goals up to margin further than that are returned too, nearest first.
+      Creatures on the way are ignored, and the goals don't need to be passable.*/
+  static vector<Vec2> getNearest(const Level*, const MovementType&, Vec2 from, const vector<Vec2>& goals,
+      double margin = 0);
+
+  /** Limits the number of squares that budgeted searches may expand in one Model::update. A search that runs
+      out of the budget is suspended, and continued with resume on a later turn. A negative budget means no
+      limit. Budgeted searches may only run on the main thread.*/
+  static void setTurnBudget(int expansions);
+  static int getTurnBudget();
+
+  /** Gives budgeted searches the whole budget again. Called at the start of Model::update.*/
+  static void startTurn();
+
+  /** Returns true if the search ran out of the turn's budget before it found the path.*/
+  bool isSuspended() const;
+
+  /** Continues a suspended search on the level towards from, which may be different from where the search
+      started.*/
+  void resume(const Level*, const Creature*, Vec2 from);
+
+  /** Continues a suspended search with the given cost functions, see the constructor.*/
+  template <class EntryFun, class LengthFun>
+  void resumeTowards(EntryFun entryFun, LengthFun lengthFun, Vec2 from);
+
   static const double infinity;
 
   private:
-  void init(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, Vec2 target, Optional<Vec2> from,
-      Optional<int> limit = Nothing());
-  void reverse(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, double mult, Vec2 from, int limit);
-  void setDistance(Vec2, double);
-  double getDistance(Vec2 pos) const;
+  /** Search state reused by all searches of a thread, so searches may run on several threads at once.*/
+  struct Workspace {
+    Workspace();
+    Table<double> distance;
+    Table<int> dirty;
+    int counter = 1;
+    long long numExpanded = 0;
+  };
+  static Workspace& getWorkspace();
+
+  /** Called before every search. Binds the path to the workspace of the current thread and clears the
+      distances.*/
+  void startSearch();
+
+  /** Heap of squares ordered by their estimated path length, smallest on top. A square is pushed again when
+      its distance improves, and the outdated entries are skipped when popped.*/
+  typedef std::priority_queue<pair<double, Vec2>, vector<pair<double, Vec2>>, std::greater<pair<double, Vec2>>>
+      Queue;
+
+  /** What is needed to continue a suspended search. The distances are in the order they were set, so the
+      later ones for a square override the earlier. A search that had no budget to start with has none.*/
+  struct Suspended {
+    const Level* level;
+    bool avoidEnemies;
+    vector<pair<Vec2, double>> distance;
+    vector<Vec2> queue;
+  };
+
+  static void chargeBudget(int numExpanded);
+  static int turnBudget;
+  static int budgetLeft;
+
+  ShortestPath(Rectangle area, vector<Vec2> directions, Vec2 target);
+
+  template <class EntryFun, class LengthFun>
+  void init(EntryFun entryFun, LengthFun lengthFun, Vec2 target, Optional<Vec2> from,
+      Optional<int> limit = Nothing(), bool budgeted = false);
+  /** Expands the squares in the queue until the path is found, the queue is empty, or a budgeted search runs
+      out of the budget.*/
+  template <class EntryFun, class LengthFun>
+  void search(EntryFun entryFun, LengthFun lengthFun, Queue& q, Optional<Vec2> from, Optional<int> limit);
+  /** Builds the path by searching between consecutive waypoints of a cluster graph path.*/
+  template <class EntryFun>
+  bool initFromWaypoints(EntryFun entryFun, const vector<Vec2>& waypoints);
+  template <class EntryFun, class LengthFun>
+  void reverse(EntryFun entryFun, LengthFun lengthFun, double mult, Vec2 from, int limit);
+  /** Searches the area from start until it reaches a goal square, and returns the squares from the goal back
+      to start.*/
+  template <class EntryFun, class GoalFun>
+  Optional<vector<Vec2>> searchBack(EntryFun entryFun, Rectangle area, Vec2 start, GoalFun isGoal);
+
+  void setDistance(Vec2 v, double d) {
+    workspace->distance[v] = d;
+    workspace->dirty[v] = workspace->counter;
+    if (suspended)
+      suspended->distance.push_back({v, d});
+  }
+
+  double getDistance(Vec2 v) const {
+    return workspace->dirty[v] < workspace->counter ? infinity : workspace->distance[v];
+  }
+
   void constructPath(Vec2 start, bool reversed = false);
+
+  static const int revShortestLimit = 15;
+
+  // The workspace of the thread that runs the current search. Searches don't depend on the distances left by
+  // earlier ones, so a path may be continued or repaired on another thread than the one that found it.
+  Workspace* workspace;
   vector<Vec2> path;
   Vec2 target;
   vector<Vec2> directions;
   Rectangle bounds;
   bool reversed;
+  std::unique_ptr<Suspended> suspended;
 };
 
+template <class EntryFun, class LengthFun>
+ShortestPath::ShortestPath(Rectangle a, EntryFun entryFun, LengthFun lengthFun, vector<Vec2> dir, Vec2 to,
+    Vec2 from, double mult, bool budgeted) : ShortestPath(a, dir, to) {
+  if (mult == 0)
+    init(entryFun, lengthFun, target, from, Nothing(), budgeted);
+  else {
+    init(entryFun, lengthFun, target, Nothing(), revShortestLimit);
+    setDistance(target, infinity);
+    reverse(entryFun, lengthFun, mult, from, revShortestLimit);
+  }
+}
+
+template <class EntryFun, class LengthFun>
+void ShortestPath::init(EntryFun entryFun, LengthFun lengthFun, Vec2 target, Optional<Vec2> from,
+    Optional<int> limit, bool budgeted) {
+  reversed = false;
+  startSearch();
+  if (budgeted) {
+    CHECK(from && !limit);
+    suspended.reset(new Suspended {nullptr, false, {}, {}});
+  }
+  Queue q;
+  setDistance(target, 0);
+  q.push({from ? lengthFun(*from - target) : 0, target});
+  search(entryFun, lengthFun, q, from, limit);
+}
+
+template <class EntryFun, class LengthFun>
+void ShortestPath::resumeTowards(EntryFun entryFun, LengthFun lengthFun, Vec2 from) {
+  CHECK(suspended);
+  startSearch();
+  vector<pair<Vec2, double>> distance;
+  distance.swap(suspended->distance);
+  for (auto& elem : distance)
+    setDistance(elem.first, elem.second);
+  // The squares waiting in the queue are estimated again, because from may have changed.
+  Queue q;
+  for (Vec2 v : suspended->queue)
+    q.push({getDistance(v) + lengthFun(from - v), v});
+  suspended->queue.clear();
+  search(entryFun, lengthFun, q, from, Nothing());
+}
+
+template <class EntryFun, class LengthFun>
+void ShortestPath::search(EntryFun entryFun, LengthFun lengthFun, Queue& q, Optional<Vec2> from,
+    Optional<int> limit) {
+  auto estimate = [&](Vec2 pos, double dist) -> double {
+    return from ? dist + lengthFun(*from - pos) : dist; };
+  int numPopped = 0;
+  while (!q.empty()) {
+    Vec2 pos = q.top().second;
+    double cdist = getDistance(pos);
+    if (q.top().first > estimate(pos, cdist)) {
+      q.pop();
+      continue;
+    }
+    if (suspended && turnBudget >= 0 && numPopped >= budgetLeft) {
+      Debug() << "Shortest path from " << *from << " to " << target << " suspended after " << numPopped;
+      workspace->numExpanded += numPopped;
+      for (; !q.empty(); q.pop())
+        if (q.top().first <= estimate(q.top().second, getDistance(q.top().second)))
+          suspended->queue.push_back(q.top().second);
+      chargeBudget(numPopped);
+      return;
+    }
+    ++numPopped;
+    if (from == pos || (limit && cdist >= *limit)) {
+      Debug() << "Shortest path from " << (from ? *from : Vec2(-1, -1)) << " to " << target << " " << numPopped << " visited distance " << cdist;
+      workspace->numExpanded += numPopped;
+      if (suspended) {
+        chargeBudget(numPopped);
+        suspended.reset();
+      }
+      constructPath(pos);
+      return;
+    }
+    q.pop();
+    for (Vec2 dir : directions) {
+      Vec2 next = pos + dir;
+      if (next.inRectangle(bounds)) {
+        double ndist = getDistance(next);
+        if (cdist < ndist) {
+          double dist = cdist + entryFun(next);
+          CHECK(dist > cdist) << "Entry fun non positive " << dist - cdist;
+          if (dist < ndist) {
+            setDistance(next, dist);
+            q.push({estimate(next, dist), next});
+          }
+        }
+      }
+    }
+  }
+  Debug() << "Shortest path exhausted, " << numPopped << " visited";
+  workspace->numExpanded += numPopped;
+  if (suspended) {
+    chargeBudget(numPopped);
+    suspended.reset();
+  }
+}
+
+template <class EntryFun, class LengthFun>
+void ShortestPath::reverse(EntryFun entryFun, LengthFun lengthFun, double mult, Vec2 from, int limit) {
+  reversed = true;
+  auto estimate = [&](Vec2 pos, double dist) -> double { return dist + lengthFun(from - pos); };
+  Queue q;
+  for (Vec2 v : bounds) {
+    double dist = getDistance(v);
+    if (dist <= limit) {
+      setDistance(v, mult * dist);
+      q.push({estimate(v, mult * dist), v});
+    }
+  }
+  int numPopped = 0;
+  while (!q.empty()) {
+    Vec2 pos = q.top().second;
+    double cdist = getDistance(pos);
+    if (q.top().first > estimate(pos, cdist)) {
+      q.pop();
+      continue;
+    }
+    ++numPopped;
+    if (from == pos) {
+      Debug() << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
+      constructPath(pos, true);
+      return;
+    }
+    q.pop();
+    for (Vec2 dir : directions)
+      if ((pos + dir).inRectangle(bounds)) {
+        double ndist = getDistance(pos + dir);
+        double dist = cdist + entryFun(pos + dir);
+        if (ndist > dist && ndist < 0) {
+          setDistance(pos + dir, dist);
+          q.push({estimate(pos + dir, dist), pos + dir});
+        }
+      }
+  }
+  Debug() << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
+}
+
 #endif
@@ -2,6 +2,7 @@
 
 #include "skill.h"
 #include "item_factory.h"
+#include "creature.h"
 
 string Skill::getName() const {
   return name;
@@ -17,7 +18,7 @@ class IdentifySkill : public Skill {
 
   virtual void onTeach(Creature* c) override {
     string message;
-    for (PItem& it : factory.getAll()) {
+    for (PItem& it : factory.getAll(c->getRandom())) {
       Item::identify(it->getName());
       message.append(it->getName() + ": " + it->getDescription() + "\n");
     }
@@ -8,13 +8,35 @@ using namespace std;
 
 Square::Square(const ViewObject& vo, const string& n, bool see, bool canHide, int s, double f,
     map<SquareType, int> construct, bool tick) 
-    : name(n), viewObject(vo), seeThru(see), hide(canHide), strength(s), fire(strength, f),
-    constructions(construct), ticking(tick) {
+    : name(n), viewObject(vo), constructions(construct.begin(), construct.end()), strength(s), flamability(f),
+    seeThru(see), hide(canHide), ticking(tick) {
+}
+
+Square::Square(const Square& o) : name(o.name), position(o.position), viewObject(o.viewObject),
+    backgroundObject(o.backgroundObject), constructions(o.constructions), strength(o.strength),
+    flamability(o.flamability), fog(o.fog), seeThru(o.seeThru), hide(o.hide), covered(o.covered),
+    ticking(o.ticking) {
+  CHECK(!o.level && !o.creature && !o.contents) << "Only squares that aren't used yet can be copied";
+}
+
+Square* Square::clone() const {
+  CHECK(typeid(*this) == typeid(Square)) << "Square subclass without clone()";
+  return new Square(*this);
+}
+
+Square::Contents::Contents(int strength, double flamability) : fire(strength, flamability) {
+}
+
+Square::Contents& Square::getContents() {
+  if (!contents)
+    contents.reset(new Contents(strength, flamability));
+  return *contents;
 }
 
 void Square::putCreature(Creature* c) {
   CHECK(canEnter(c));
   creature = c;
+  markChanged();
   onEnter(c);
 }
 
@@ -35,15 +57,18 @@ void Square::setName(const string& s) {
 }
 
 void Square::setLandingLink(StairDirection direction, StairKey key) {
-  landingLink = make_pair(direction, key);
+  getContents().landingLink = make_pair(direction, key);
 }
 
 bool Square::isLandingSquare(StairDirection direction, StairKey key) {
-  return landingLink == make_pair(direction, key);
+  return contents && contents->landingLink == make_pair(direction, key);
 }
 
 Optional<pair<StairDirection, StairKey>> Square::getLandingLink() const {
-  return landingLink;
+  if (contents)
+    return contents->landingLink;
+  else
+    return Nothing();
 }
 
 void Square::setCovered(bool c) {
@@ -56,31 +81,42 @@ bool Square::isCovered() const {
 
 void Square::setHeight(double h) {
   viewObject.setHeight(h);
-  height = h;
 }
 
 void Square::addTravelDir(Vec2 dir) {
-  if (!findElement(travelDir, dir))
-    travelDir.push_back(dir);
+  if (!findElement(getContents().travelDir, dir))
+    contents->travelDir.push_back(dir);
 }
 
 bool Square::canConstruct(SquareType type) const {
-  return constructions.count(type);
+  for (auto& elem : constructions)
+    if (elem.first == type)
+      return true;
+  return false;
+}
+
+void Square::setConstructionAttempts(SquareType type, int attempts) {
+  CHECK(canConstruct(type));
+  for (auto& elem : constructions)
+    if (elem.first == type)
+      elem.second = attempts;
 }
 
 void Square::construct(SquareType type) {
   CHECK(canConstruct(type));
-  if (--constructions[type] == 0) {
-    PSquare newSquare = PSquare(SquareFactory::get(type));
-    level->replaceSquare(position, std::move(newSquare));
-  }
+  for (auto& elem : constructions)
+    if (elem.first == type && --elem.second == 0) {
+      PSquare newSquare = PSquare(SquareFactory::get(level->getRandom(), type));
+      level->replaceSquare(position, std::move(newSquare));
+      return;
+    }
 }
 
 void Square::destroy(int strength) {
   CHECK(canDestroy());
   getLevel()->globalMessage(getPosition(), "The " + getName() + " is destroyed.");
   EventListener::addSquareReplacedEvent(getLevel(), getPosition());
-  getLevel()->replaceSquare(getPosition(), PSquare(SquareFactory::get(SquareType::FLOOR)));
+  getLevel()->replaceSquare(getPosition(), PSquare(SquareFactory::get(getLevel()->getRandom(), SquareType::FLOOR)));
 }
 
 void Square::burnOut() {
@@ -89,17 +125,19 @@ void Square::burnOut() {
 }
 
 const vector<Vec2>& Square::getTravelDir() const {
-  return travelDir;
+  static const vector<Vec2> none;
+  return contents ? contents->travelDir : none;
 }
 
 void Square::putCreatureSilently(Creature* c) {
   CHECK(canEnter(c));
   creature = c;
+  markChanged();
 }
 
 void Square::setLevel(Level* l) {
   level = l;
-  if (ticking || !inventory.isEmpty())
+  if (ticking || (contents && !contents->inventory.isEmpty()))
     level->addTickingSquare(position);
 }
 
@@ -113,6 +151,12 @@ Level* Square::getLevel() {
 
 void Square::setViewObject(const ViewObject& o) {
   viewObject = o;
+  markChanged();
+}
+
+void Square::markChanged() {
+  if (level)
+    level->markChanged(position);
 }
 
 void Square::setFog(double val) {
@@ -120,35 +164,43 @@ void Square::setFog(double val) {
 }
 
 void Square::tick(double time) {
-  if (!inventory.isEmpty())
-    for (Item* item : inventory.getItems()) {
-      item->tick(time, level, position);
-      if (item->isDiscarded())
-        inventory.removeItem(item);
+  if (contents) {
+    Inventory& inventory = contents->inventory;
+    // Items may rot, and fire and gas change their size, so the square may look different after every tick.
+    if (!inventory.isEmpty() || contents->poisonGas.getAmount() > 0 || contents->fire.isBurning())
+      markChanged();
+    if (!inventory.isEmpty())
+      for (Item* item : inventory.getItems()) {
+        item->tick(time, level, position);
+        if (item->isDiscarded())
+          inventory.removeItem(item);
+      }
+    PoisonGas& poisonGas = contents->poisonGas;
+    poisonGas.tick(level, position);
+    if (creature && poisonGas.getAmount() > 0.2) {
+      creature->poisonWithGas(min(1.0, poisonGas.getAmount()));
     }
-  poisonGas.tick(level, position);
-  if (creature && poisonGas.getAmount() > 0.2) {
-    creature->poisonWithGas(min(1.0, poisonGas.getAmount()));
-  }
-  if (fire.isBurning()) {
-    viewObject.setBurning(fire.getSize());
-    Debug() << getName() << " burning " << fire.getSize();
-    for (Vec2 v : position.neighbors8(true))
-      if (fire.getSize() > Random.getDouble() * 40)
-        level->getSquare(v)->setOnFire(fire.getSize() / 20);
-    fire.tick(level, position);
-    if (fire.isBurntOut()) {
-      level->globalMessage(position, "The " + getName() + " burns out");
-      burnOut();
-      return;
+    Fire& fire = contents->fire;
+    if (fire.isBurning()) {
+      viewObject.setBurning(fire.getSize());
+      Debug() << getName() << " burning " << fire.getSize();
+      for (Vec2 v : position.neighbors8(level->getRandom()))
+        if (fire.getSize() > level->getRandom().getDouble() * 40)
+          level->getSquare(v)->setOnFire(fire.getSize() / 20);
+      fire.tick(level, position);
+      if (fire.isBurntOut()) {
+        level->globalMessage(position, "The " + getName() + " burns out");
+        burnOut();
+        return;
+      }
+      if (creature)
+        creature->setOnFire(fire.getSize());
+      for (Item* it : getItems())
+        it->setOnFire(fire.getSize(), level, position);
     }
-    if (creature)
-      creature->setOnFire(fire.getSize());
-    for (Item* it : getItems())
-      it->setOnFire(fire.getSize(), level, position);
+    for (PTrigger& t : contents->triggers)
+      t->tick(time);
   }
-  for (PTrigger& t : triggers)
-    t->tick(time);
   tickSpecial(time);
 }
 
@@ -161,9 +213,10 @@ bool Square::itemLands(Item* item, const Attack& attack) {
       return false;
     }
   }
-  for (PTrigger& t : triggers)
-    if (t->interceptsFlyingItem(item))
-      return true;
+  if (contents)
+    for (PTrigger& t : contents->triggers)
+      if (t->interceptsFlyingItem(item))
+        return true;
   return false;
 }
 
@@ -178,11 +231,12 @@ void Square::onItemLands(PItem item, const Attack& attack, int remainingDist, Ve
       dropItem(std::move(item));
     return;
   }
-  for (PTrigger& t : triggers)
-    if (t->interceptsFlyingItem(item.get())) {
-      t->onInterceptFlyingItem(std::move(item), attack, remainingDist, dir);
-      return;
-    }
+  if (contents)
+    for (PTrigger& t : contents->triggers)
+      if (t->interceptsFlyingItem(item.get())) {
+        t->onInterceptFlyingItem(std::move(item), attack, remainingDist, dir);
+        return;
+      }
 
   item->onHitSquare(position, this);
   if (!item->isDiscarded())
@@ -190,24 +244,33 @@ void Square::onItemLands(PItem item, const Attack& attack, int remainingDist, Ve
 }
 
 bool Square::canEnter(const Creature* c) const {
-  return creature == nullptr && canEnterSpecial(c);
+  return creature == nullptr && canEnterSpecial(c->getMovementType());
 }
 
 bool Square::canEnterEmpty(const Creature* c) const {
-  return canEnterSpecial(c);
+  return canEnterSpecial(c->getMovementType());
 }
 
-bool Square::canEnterSpecial(const Creature* c) const {
-  return c->canWalk();
+bool Square::canEnterEmpty(const MovementType& movement) const {
+  return canEnterSpecial(movement);
+}
+
+bool Square::canEnterSpecial(const MovementType& movement) const {
+  return movement.canWalk();
 }
 
 void Square::setOnFire(double amount) {
-  bool burning = fire.isBurning();
-  fire.set(amount);
-  if (!burning && fire.isBurning()) {
-    level->addTickingSquare(position);
-    level->globalMessage(position, "The " + getName() + " catches fire.");
-    viewObject.setBurning(fire.getSize());
+  // A square that isn't flammable never catches fire, so there is no need to make room for the fire.
+  if (flamability > 0) {
+    Fire& fire = getContents().fire;
+    bool burning = fire.isBurning();
+    fire.set(amount);
+    if (!burning && fire.isBurning()) {
+      level->addTickingSquare(position);
+      level->globalMessage(position, "The " + getName() + " catches fire.");
+      viewObject.setBurning(fire.getSize());
+      markChanged();
+    }
   }
   if (creature)
     creature->setOnFire(amount);
@@ -217,20 +280,21 @@ void Square::setOnFire(double amount) {
 
 void Square::addPoisonGas(double amount) {
   if (canSeeThru()) {
-    poisonGas.addAmount(amount);
+    getContents().poisonGas.addAmount(amount);
+    markChanged();
     level->addTickingSquare(position);
   }
 }
 
 double Square::getPoisonGasAmount() const {
-  return poisonGas.getAmount();
+  return contents ? contents->poisonGas.getAmount() : 0;
 }
 
 bool Square::isBurnt() const {
-  return fire.isBurntOut();
+  return contents && contents->fire.isBurntOut();
 }
 
-ViewObject Square::getViewObject() const {
+const ViewObject& Square::getViewObject() const {
   return viewObject;
 }
 
@@ -254,9 +318,11 @@ static ViewObject addFire(const ViewObject& obj, double fire) {
 
 ViewIndex Square::getViewIndex(const CreatureView* c) const {
   double fireSize = 0;
-  for (Item* it : inventory.getItems())
-    fireSize = max(fireSize, it->getFireSize());
-  fireSize = max(fireSize, fire.getSize());
+  if (contents) {
+    for (Item* it : contents->inventory.getItems())
+      fireSize = max(fireSize, it->getFireSize());
+    fireSize = max(fireSize, contents->fire.getSize());
+  }
   ViewIndex ret;
   if (creature && (c->canSee(creature) || creature->isPlayer())) {
     ret.insert(addFire(creature->getViewObject(), fireSize));
@@ -268,15 +334,16 @@ ViewIndex Square::getViewIndex(const CreatureView* c) const {
     if (backgroundObject)
       ret.insert(*backgroundObject);
     ret.insert(getViewObject());
-    for (const PTrigger& t : triggers)
-      if (auto obj = t->getViewObject())
-        ret.insert(addFire(*obj, fireSize));
+    if (contents)
+      for (const PTrigger& t : contents->triggers)
+        if (auto obj = t->getViewObject())
+          ret.insert(addFire(*obj, fireSize));
     if (Item* it = getTopItem())
       ret.insert(addFire(it->getViewObject(), fireSize));
   }
   if (c->canSee(position)) {
-    if (poisonGas.getAmount() > 0)
-      ret.setHighlight(HighlightType::POISON_GAS, min(1.0, poisonGas.getAmount()));
+    if (double gas = getPoisonGasAmount())
+      ret.setHighlight(HighlightType::POISON_GAS, min(1.0, gas));
     if (fog)
       ret.setHighlight(HighlightType::FOG, fog);
   }
@@ -284,15 +351,17 @@ ViewIndex Square::getViewIndex(const CreatureView* c) const {
 }
 
 void Square::onEnter(Creature* c) {
-  for (PTrigger& t : triggers)
-    t->onCreatureEnter(c);
+  if (contents)
+    for (PTrigger& t : contents->triggers)
+      t->onCreatureEnter(c);
   onEnterSpecial(c);
 }
 
 void Square::dropItem(PItem item) {
   if (level)  // if level == null, then it's being constructed, square will be added later
     level->addTickingSquare(getPosition());
-  inventory.addItem(std::move(item));
+  getContents().inventory.addItem(std::move(item));
+  markChanged();
 }
 
 void Square::dropItems(vector<PItem> items) {
@@ -301,7 +370,7 @@ void Square::dropItems(vector<PItem> items) {
 }
 
 bool Square::hasItem(Item* it) const {
-  return inventory.hasItem(it);
+  return contents && contents->inventory.hasItem(it);
 }
 
 Creature* Square::getCreature() {
@@ -310,21 +379,26 @@ Creature* Square::getCreature() {
 
 void Square::addTrigger(PTrigger t) {
   level->addTickingSquare(position);
-  triggers.push_back(std::move(t));
+  getContents().triggers.push_back(std::move(t));
+  markChanged();
 }
 
 PTrigger Square::removeTrigger(Trigger* trigger) {
   PTrigger ret;
-  for (PTrigger& t : triggers)
-    if (t.get() == trigger) {
-      ret = std::move(t);
-      removeElement(triggers, t);
-    }
+  if (contents)
+    for (PTrigger& t : contents->triggers)
+      if (t.get() == trigger) {
+        ret = std::move(t);
+        removeElement(contents->triggers, t);
+      }
+  markChanged();
   return ret;
 }
 
 void Square::removeTriggers() {
-  triggers.clear();
+  if (contents)
+    contents->triggers.clear();
+  markChanged();
 }
 
 const Creature* Square::getCreature() const {
@@ -334,9 +408,15 @@ const Creature* Square::getCreature() const {
 void Square::removeCreature() {
   CHECK(creature);
   creature = 0;
+  markChanged();
+}
+
+Square* SolidSquare::clone() const {
+  CHECK(typeid(*this) == typeid(SolidSquare)) << "SolidSquare subclass without clone()";
+  return new SolidSquare(*this);
 }
 
-bool SolidSquare::canEnterSpecial(const Creature*) const {
+bool SolidSquare::canEnterSpecial(const MovementType&) const {
   return false;
 }
 
@@ -346,6 +426,7 @@ bool Square::canSeeThru() const {
 
 void Square::setCanSeeThru(bool f) {
   seeThru = f;
+  markChanged();
 }
 
 bool Square::canHide() const {
@@ -358,8 +439,8 @@ int Square::getStrength() const {
 
 Item* Square::getTopItem() const {
   Item* last = nullptr;
-  if (!inventory.isEmpty())
-  for (Item* it : inventory.getItems()) {
+  if (contents && !contents->inventory.isEmpty())
+  for (Item* it : contents->inventory.getItems()) {
     last = it;
     if (it->getViewObject().layer() == ViewLayer::LARGE_ITEM)
       return it;
@@ -368,14 +449,19 @@ Item* Square::getTopItem() const {
 }
 
 vector<Item*> Square::getItems(function<bool (Item*)> predicate) {
-  return inventory.getItems(predicate);
+  if (contents)
+    return contents->inventory.getItems(predicate);
+  else
+    return {};
 }
 
 PItem Square::removeItem(Item* it) {
-  return inventory.removeItem(it);
+  markChanged();
+  return getContents().inventory.removeItem(it);
 }
 
 vector<PItem> Square::removeItems(vector<Item*> it) {
-  return inventory.removeItems(it);
+  markChanged();
+  return getContents().inventory.removeItems(it);
 }
 
@@ -68,6 +68,7 @@ class Square {
   /** Checks if this square is can be entered by the creature. Doesn't take into account other 
     * creatures on the square.*/
   bool canEnterEmpty(const Creature*) const;
+  bool canEnterEmpty(const MovementType&) const;
 
   /** Checks if this square obstructs view.*/
   bool canSeeThru() const;
@@ -140,6 +141,9 @@ class Square {
   /** Checks if another square can be constructed from this one.*/
   bool canConstruct(SquareType) const;
 
+  /** Sets the number of attempts needed to construct the given square from this one.*/
+  void setConstructionAttempts(SquareType, int);
+
   /** Constructs another square. The construction might finish after several attempts.*/
   void construct(SquareType);
 
@@ -150,7 +154,7 @@ class Square {
       For this method to be called, the square coordinates must be added with Level::addTickingSquare().*/
   void tick(double time);
 
-  ViewObject getViewObject() const;
+  const ViewObject& getViewObject() const;
   Optional<ViewObject> getBackgroundObject() const;
   void setBackground(const Square*);
   ViewIndex getViewIndex(const CreatureView* c) const;
@@ -167,42 +171,59 @@ class Square {
  
   const Level* getConstLevel() const;
 
+  /** Returns a copy of this square, which must not be on a level yet. Used to make squares from the prototypes
+      in SquareFactory, so every subclass that has a prototype overrides it.*/
+  virtual Square* clone() const;
+
   virtual ~Square() {};
 
   void setFog(double val);
 
   protected:
+  Square(const Square&);
   void onEnter(Creature*);
-  virtual bool canEnterSpecial(const Creature*) const;
+  virtual bool canEnterSpecial(const MovementType&) const;
   virtual void onEnterSpecial(Creature*) {}
   virtual void tickSpecial(double time) {}
   Level* getLevel();
   void setViewObject(const ViewObject&);
-  vector<Vec2> face;
-  Inventory inventory;
   string name;
 
   private:
   Item* getTopItem() const;
 
+  /** State that most squares never have. It's allocated when it's first needed, so that plain terrain, like
+      most of the wilderness, only keeps the fields of the square itself.*/
+  struct Contents {
+    Contents(int strength, double flamability);
+
+    Inventory inventory;
+    vector<PTrigger> triggers;
+    vector<Vec2> travelDir;
+    Optional<pair<StairDirection, StairKey>> landingLink;
+    PoisonGas poisonGas;
+    Fire fire;
+  };
+
+  Contents& getContents();
+
+  /** Tells the level that the square looks different now, see Level::markChanged.*/
+  void markChanged();
+
   Level* level = nullptr;
   Vec2 position;
   Creature* creature = nullptr;
-  vector<PTrigger> triggers;
+  unique_ptr<Contents> contents;
   ViewObject viewObject;
   Optional<ViewObject> backgroundObject;
+  vector<pair<SquareType, int>> constructions;
+  int strength;
+  double flamability;
+  float fog = 0;
   bool seeThru;
   bool hide;
-  int strength;
-  double height;
-  vector<Vec2> travelDir;
   bool covered = false;
-  Optional<pair<StairDirection, StairKey>> landingLink;
-  Fire fire;
-  PoisonGas poisonGas;
-  map<SquareType, int> constructions;
   bool ticking;
-  double fog = 0;
 };
 
 class SolidSquare : public Square {
@@ -212,8 +233,10 @@ class SolidSquare : public Square {
       Square(vo, name, canSee, false, 0, flamability, constructions) {
   }
 
+  virtual Square* clone() const override;
+
   protected:
-  virtual bool canEnterSpecial(const Creature*) const;
+  virtual bool canEnterSpecial(const MovementType&) const;
 
   virtual void onEnterSpecial(Creature* c) {
     Debug(FATAL) << "Creature entered solid square";
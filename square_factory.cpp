@@ -39,11 +39,14 @@ class SecretPassage : public Square {
   SecretPassage(const ViewObject& obj, const ViewObject& sec) : Square(obj, "secret door", false), secondary(sec), uncovered(false) {
   }
 
+  virtual Square* clone() const override {
+    return new SecretPassage(*this);
+  }
+
   void uncover(Vec2 pos) {
     uncovered = true;
     setName("floor");
     setViewObject(secondary);
-    face.clear();
     setCanSeeThru(true);
     getLevel()->updateVisibility(pos);
   }
@@ -84,8 +87,12 @@ class Magma : public Square {
   Magma(const ViewObject& object, const string& name, const string& itemMsg, const string& noSee)
       : Square(object, name, true, false, 0, 0, {{SquareType::BRIDGE, 20}}), itemMessage(itemMsg), noSeeMsg(noSee) {}
 
-  virtual bool canEnterSpecial(const Creature* c) const override {
-    return c->canFly() || c->isBlind() || c->isHeld();
+  virtual Square* clone() const override {
+    return new Magma(*this);
+  }
+
+  virtual bool canEnterSpecial(const MovementType& movement) const override {
+    return movement.canFly() || movement.isForced();
   }
 
   virtual void onEnterSpecial(Creature* c) override {
@@ -114,8 +121,12 @@ class Water : public Square {
       : Square(object.setWaterDepth(_depth), name, true, false, 0, 0, {{SquareType::BRIDGE, 20}}),
         itemMessage(itemMsg), noSeeMsg(noSee), depth(_depth) {}
 
-  bool canWalk(const Creature* c) const {
-    switch (c->getSize()) {
+  virtual Square* clone() const override {
+    return new Water(*this);
+  }
+
+  bool canWalk(CreatureSize size) const {
+    switch (size) {
       case CreatureSize::HUGE: return depth < 3;
       case CreatureSize::LARGE: return depth < 1.5;
       case CreatureSize::MEDIUM: return depth < 1;
@@ -124,15 +135,15 @@ class Water : public Square {
     return false;
   }
 
-  virtual bool canEnterSpecial(const Creature* c) const override {
-    bool can = canWalk(c) || c->canSwim() || c->canFly() || c->isBlind() || c->isHeld();
+  virtual bool canEnterSpecial(const MovementType& movement) const override {
+    bool can = canWalk(movement.getSize()) || movement.canSwim() || movement.canFly() || movement.isForced();
  /*   if (!can)
       c->privateMessage("The water is too deep.");*/
     return can;
   }
 
   virtual void onEnterSpecial(Creature* c) override {
-    if (!c->canFly() && !c->canSwim() && !canWalk(c)) {
+    if (!c->canFly() && !c->canSwim() && !canWalk(c->getSize())) {
       c->you(MsgType::DROWN, getName());
       c->die(nullptr, false);
     }
@@ -171,11 +182,12 @@ class Chest : public Square {
     if (opened)
       return;
     vector<PItem> item;
-    if (!Random.roll(10))
-      append(item, itemFactory.random());
+    RandomGen& random = getLevel()->getRandom();
+    if (!random.roll(10))
+      append(item, itemFactory.random(random));
     else {
-      for (int i : Range(Random.getRandom(minCreatures, maxCreatures)))
-        item.push_back(ItemFactory::corpse(creatureId));
+      for (int i : Range(random.getRandom(minCreatures, maxCreatures)))
+        item.push_back(ItemFactory::corpse(random, creatureId));
     }
     s->dropItems(std::move(item));
   }
@@ -192,16 +204,16 @@ class Chest : public Square {
     c->privateMessage("You open the " + getName());
     opened = true;
     setViewObject(openedObject);
-    if (!Random.roll(5)) {
+    if (!c->getRandom().roll(5)) {
       c->privateMessage(msgItem);
-      vector<PItem> items = itemFactory.random();
+      vector<PItem> items = itemFactory.random(c->getRandom());
       EventListener::addItemsAppeared(getLevel(), getPosition(), Item::extractRefs(items));
       c->takeItems(std::move(items), nullptr);
     } else {
       c->privateMessage(msgMonster);
-      int numR = Random.getRandom(minCreatures, maxCreatures);
-      for (Vec2 v : getPosition().neighbors8(true)) {
-        PCreature rat = CreatureFactory::fromId(creatureId, Tribe::pest);
+      int numR = c->getRandom().getRandom(minCreatures, maxCreatures);
+      for (Vec2 v : getPosition().neighbors8(c->getRandom())) {
+        PCreature rat = CreatureFactory::fromId(c->getRandom(), creatureId, Tribe::pest);
         if (getLevel()->getSquare(v)->canEnter(rat.get())) {
           getLevel()->addCreature(v, std::move(rat));
           if (--numR == 0)
@@ -221,7 +233,7 @@ class Chest : public Square {
 
 class Fountain : public Square {
   public:
-  Fountain(const ViewObject& object) : Square(object, "fountain", true, true, 100) {}
+  Fountain(const ViewObject& object, int s) : Square(object, "fountain", true, true, 100), seed(s) {}
 
   virtual Optional<SquareApplyType> getApplyType(const Creature*) const override { 
     return SquareApplyType::DRINK;
@@ -237,12 +249,12 @@ class Fountain : public Square {
 
   virtual void onApply(Creature* c) override {
     c->privateMessage("You drink from the fountain.");
-    PItem potion = getOnlyElement(ItemFactory::potions().random(seed));
+    PItem potion = getOnlyElement(ItemFactory::potions().random(c->getRandom(), seed));
     potion->apply(c, getLevel());
   }
 
   private:
-  int seed = Random.getRandom(123456);
+  int seed;
 };
 
 class Tree : public Square {
@@ -250,6 +262,10 @@ class Tree : public Square {
   Tree(const ViewObject& object, const string& name, bool noObstruct, int _numWood, map<SquareType, int> construct)
       : Square(object, name, noObstruct, true, 100, 0.5, construct), numWood(_numWood), bounces(!noObstruct) {}
 
+  virtual Square* clone() const override {
+    return new Tree(*this);
+  }
+
   virtual bool canDestroy() const override {
     return true;
   }
@@ -265,7 +281,11 @@ class Tree : public Square {
   }
 
   virtual void onConstructNewSquare(Square* s) override {
-    s->dropItems(ItemFactory::fromId(ItemId::WOOD_PLANK, numWood));
+    s->dropItems(ItemFactory::fromId(getLevel()->getRandom(), ItemId::WOOD_PLANK, numWood));
+  }
+
+  void setNumWood(int num) {
+    numWood = num;
   }
 
   virtual void burnOut() override {
@@ -275,7 +295,7 @@ class Tree : public Square {
   }
 
   virtual bool itemBounces(Item* item) const {
-    return bounces || Random.roll(2);
+    return bounces || getConstLevel()->getRandom().roll(2);
   }
 
   virtual void onEnterSpecial(Creature* c) override {
@@ -294,6 +314,10 @@ class TrapSquare : public Square {
   TrapSquare(const ViewObject& object, EffectType e) : Square(object, "floor", true), effect(e) {
   }
 
+  virtual Square* clone() const override {
+    return new TrapSquare(*this);
+  }
+
   virtual void onEnterSpecial(Creature* c) override {
     if (active && c->isPlayer()) {
       c->you(MsgType::TRIGGER_TRAP, "");
@@ -305,13 +329,18 @@ class TrapSquare : public Square {
   private:
   bool active = true;
   EffectType effect;
-  Tribe* tribe;
+  Tribe* tribe = nullptr;
 };
 
 class Door : public Square {
   public:
   Door(const ViewObject& object) : Square(object, "door", false, true, 100, 1) {}
 
+  virtual Square* clone() const override {
+    CHECK(typeid(*this) == typeid(Door)) << "Door subclass without clone()";
+    return new Door(*this);
+  }
+
   virtual bool canDestroy() const override {
     return true;
   }
@@ -325,16 +354,21 @@ class TribeDoor : public Door {
   public:
   TribeDoor(const ViewObject& object, int destStrength) : Door(object), destructionStrength(destStrength) {}
 
+  virtual Square* clone() const override {
+    return new TribeDoor(*this);
+  }
+
   virtual void destroy(int strength) override {
     destructionStrength -= strength;
     if (destructionStrength <= 0) {
       EventListener::addSquareReplacedEvent(getLevel(), getPosition());
-      getLevel()->replaceSquare(getPosition(), PSquare(SquareFactory::get(SquareType::FLOOR)));
+      getLevel()->replaceSquare(getPosition(),
+          PSquare(SquareFactory::get(getLevel()->getRandom(), SquareType::FLOOR)));
     }
   }
 
-  virtual bool canEnterSpecial(const Creature* c) const override {
-    return (c->canWalk() && c->getTribe() == Tribe::player);
+  virtual bool canEnterSpecial(const MovementType& movement) const override {
+    return (movement.canWalk() && movement.isPlayerTribe());
   }
 
   private:
@@ -346,6 +380,11 @@ class Furniture : public Square {
   Furniture(const ViewObject& object, const string& name, double flamability) 
       : Square(object, name, true , true, 100, flamability) {}
 
+  virtual Square* clone() const override {
+    CHECK(typeid(*this) == typeid(Furniture)) << "Furniture subclass without clone()";
+    return new Furniture(*this);
+  }
+
   virtual bool canDestroy() const override {
     return true;
   }
@@ -359,6 +398,11 @@ class Bed : public Furniture {
   public:
   Bed(const ViewObject& object, const string& name) : Furniture(object, name, 1) {}
 
+  virtual Square* clone() const override {
+    CHECK(typeid(*this) == typeid(Bed)) << "Bed subclass without clone()";
+    return new Bed(*this);
+  }
+
   virtual Optional<SquareApplyType> getApplyType(const Creature*) const override { 
     return SquareApplyType::SLEEP;
   }
@@ -378,6 +422,10 @@ class Grave : public Bed {
   public:
   Grave(const ViewObject& object, const string& name) : Bed(object, name) {}
 
+  virtual Square* clone() const override {
+    return new Grave(*this);
+  }
+
   virtual Optional<SquareApplyType> getApplyType(const Creature* c) const override { 
     if (c->isUndead())
       return SquareApplyType::SLEEP;
@@ -444,12 +492,17 @@ class TrainingDummy : public Furniture {
   public:
   TrainingDummy(const ViewObject& object, const string& name) : Furniture(object, name, 1) {}
 
+  virtual Square* clone() const override {
+    CHECK(typeid(*this) == typeid(TrainingDummy)) << "TrainingDummy subclass without clone()";
+    return new TrainingDummy(*this);
+  }
+
   virtual Optional<SquareApplyType> getApplyType(const Creature*) const override { 
     return SquareApplyType::TRAIN;
   }
 
   virtual void onApply(Creature* c) override {
-    if (Random.roll(50)) {
+    if (c->getRandom().roll(50)) {
       c->increaseExpLevel(1);
     }
   }
@@ -457,12 +510,15 @@ class TrainingDummy : public Furniture {
 
 class Library : public TrainingDummy {
   public:
-  Library(const ViewObject& object, const string& name) : TrainingDummy(object, name) {
-    spell = chooseRandom({SpellId::HEALING, SpellId::TELEPORT, SpellId::INVISIBILITY, SpellId::WORD_OF_POWER});
+  Library(const ViewObject& object, const string& name, SpellId s) : TrainingDummy(object, name), spell(s) {
+  }
+
+  virtual Square* clone() const override {
+    return new Library(*this);
   }
 
   virtual void onApply(Creature* c) override {
- /*   if (Random.roll(50)) {
+ /*   if (c->getRandom().roll(50)) {
       c->addSpell(spell);
     }*/
   }
@@ -475,6 +531,11 @@ class Workshop : public Furniture {
   public:
   using Furniture::Furniture;
 
+  virtual Square* clone() const override {
+    CHECK(typeid(*this) == typeid(Workshop)) << "Workshop subclass without clone()";
+    return new Workshop(*this);
+  }
+
   virtual Optional<SquareApplyType> getApplyType(const Creature*) const override { 
     return SquareApplyType::WORKSHOP;
   }
@@ -487,19 +548,23 @@ class Hatchery : public Square {
   public:
   Hatchery(const ViewObject& object, const string& name) : Square(object, name, true, false, 0, 0, {}, true) {}
 
+  virtual Square* clone() const override {
+    return new Hatchery(*this);
+  }
+
   virtual void tickSpecial(double time) override {
-    if (getCreature() || !Random.roll(10))
+    if (getCreature() || !getLevel()->getRandom().roll(10))
       return;
     for (Vec2 v : getPosition().neighbors8())
       if (Creature* c = getLevel()->getSquare(v)->getCreature())
         if (c->getName() == "chicken")
           return;
-    getLevel()->addCreature(getPosition(), CreatureFactory::fromId(CreatureId::CHICKEN, Tribe::peaceful,
-          MonsterAIFactory::moveRandomly()));
+    getLevel()->addCreature(getPosition(), CreatureFactory::fromId(getLevel()->getRandom(), CreatureId::CHICKEN,
+          Tribe::peaceful, MonsterAIFactory::moveRandomly()));
   }
 
-  virtual bool canEnterSpecial(const Creature* c) const override {
-    return c->canWalk() || c->getName() == "chicken" || c->getName() == "pig";
+  virtual bool canEnterSpecial(const MovementType& movement) const override {
+    return movement.canWalk() || movement.isFarmAnimal();
   }
 
 };
@@ -508,6 +573,10 @@ class Throne : public Furniture {
   public:
   Throne(const ViewObject& object, const string& name) : Furniture(object, name, 1) {}
 
+  virtual Square* clone() const override {
+    return new Throne(*this);
+  }
+
   virtual Optional<SquareApplyType> getApplyType(const Creature*) const override { 
     return SquareApplyType::WORKSHOP;
   }
@@ -521,6 +590,10 @@ class Laboratory : public Workshop {
   public:
   using Workshop::Workshop;
 
+  virtual Square* clone() const override {
+    return new Laboratory(*this);
+  }
+
   virtual void onApply(Creature* c) override {
     c->privateMessage("You mix the concoction.");
   }
@@ -530,7 +603,7 @@ Square* SquareFactory::getAltar(Deity* deity) {
   return new Altar(ViewObject(ViewId::ALTAR, ViewLayer::FLOOR, "Shrine"), deity);
 }
 
-Square* SquareFactory::get(SquareType s) {
+Square* SquareFactory::make(RandomGen& random, SquareType s) {
   switch (s) {
     case SquareType::PATH:
     case SquareType::FLOOR:
@@ -552,19 +625,19 @@ Square* SquareFactory::get(SquareType s) {
         return new Square(ViewObject(ViewId::ROAD, ViewLayer::FLOOR, "Road"), "road", true);
     case SquareType::ROCK_WALL:
         return new SolidSquare(ViewObject(ViewId::WALL, ViewLayer::FLOOR, "Wall", true), "wall", false,
-            {{SquareType::FLOOR, Random.getRandom(3, 8)}});
+            {{SquareType::FLOOR, random.getRandom(3, 8)}});
     case SquareType::GOLD_ORE:
         return new ConstructionDropItems(ViewObject(ViewId::GOLD_ORE, ViewLayer::FLOOR, "Gold ore", true), "gold ore",
-            {{SquareType::FLOOR, Random.getRandom(30, 80)}},
-            ItemFactory::fromId(ItemId::GOLD_PIECE, Random.getRandom(30, 60)));
+            {{SquareType::FLOOR, random.getRandom(30, 80)}},
+            ItemFactory::fromId(random, ItemId::GOLD_PIECE, random.getRandom(30, 60)));
     case SquareType::IRON_ORE:
         return new ConstructionDropItems(ViewObject(ViewId::IRON_ORE, ViewLayer::FLOOR, "Iron ore", true), "iron ore",
-            {{SquareType::FLOOR, Random.getRandom(30, 80)}},
-            ItemFactory::fromId(ItemId::IRON_ORE, Random.getRandom(5, 20)));
+            {{SquareType::FLOOR, random.getRandom(30, 80)}},
+            ItemFactory::fromId(random, ItemId::IRON_ORE, random.getRandom(5, 20)));
     case SquareType::STONE:
         return new ConstructionDropItems(ViewObject(ViewId::STONE, ViewLayer::FLOOR, "Stone", true), "stone",
-            {{SquareType::FLOOR, Random.getRandom(30, 80)}},
-            ItemFactory::fromId(ItemId::ROCK, Random.getRandom(5, 20)));
+            {{SquareType::FLOOR, random.getRandom(30, 80)}},
+            ItemFactory::fromId(random, ItemId::ROCK, random.getRandom(5, 20)));
     case SquareType::LOW_ROCK_WALL:
         return new SolidSquare(ViewObject(ViewId::LOW_ROCK_WALL, ViewLayer::FLOOR, "Wall"), "wall", false);
     case SquareType::WOOD_WALL:
@@ -584,7 +657,7 @@ Square* SquareFactory::get(SquareType s) {
         return new SolidSquare(ViewObject(ViewId::MOUNTAIN, ViewLayer::FLOOR, "Mountain"), "mountain", true);
     case SquareType::MOUNTAIN2:
         return new SolidSquare(ViewObject(ViewId::MOUNTAIN2, ViewLayer::FLOOR, "Mountain"), "mountain", false,
-            {{SquareType::FLOOR, Random.getRandom(3, 8)}});
+            {{SquareType::FLOOR, random.getRandom(3, 8)}});
     case SquareType::GLACIER:
         return new SolidSquare(ViewObject(ViewId::SNOW, ViewLayer::FLOOR, "Mountain"), "mountain", true);
     case SquareType::HILL:
@@ -603,11 +676,11 @@ Square* SquareFactory::get(SquareType s) {
     case SquareType::SAND: return new Square(ViewObject(ViewId::SAND, ViewLayer::FLOOR_BACKGROUND, "Sand"),
                                "sand", true);
     case SquareType::CANIF_TREE: return new Tree(ViewObject(ViewId::CANIF_TREE, ViewLayer::FLOOR, "Tree"), "tree", 
-                                     false, Random.getRandom(15, 30), {{SquareType::TREE_TRUNK, 20}});
+                                     false, random.getRandom(15, 30), {{SquareType::TREE_TRUNK, 20}});
     case SquareType::DECID_TREE: return new Tree(ViewObject(ViewId::DECID_TREE, ViewLayer::FLOOR, "Tree"), "tree",
-                                     false, Random.getRandom(15, 30), {{SquareType::TREE_TRUNK, 20}});
+                                     false, random.getRandom(15, 30), {{SquareType::TREE_TRUNK, 20}});
     case SquareType::BUSH: return new Tree(ViewObject(ViewId::BUSH, ViewLayer::FLOOR, "Bush"), "bush",
-                                     true, Random.getRandom(5, 10), {{SquareType::TREE_TRUNK, 10}});
+                                     true, random.getRandom(5, 10), {{SquareType::TREE_TRUNK, 10}});
     case SquareType::TREE_TRUNK: return new Furniture(ViewObject(ViewId::TREE_TRUNK, ViewLayer::FLOOR, "tree trunk"),
                                    "tree trunk", 0);
     case SquareType::BED: return new Bed(ViewObject(ViewId::BED, ViewLayer::FLOOR, "Bed"), "bed");
@@ -624,7 +697,8 @@ Square* SquareFactory::get(SquareType s) {
             "training post");
     case SquareType::LIBRARY:
         return new Library(ViewObject(ViewId::LIBRARY, ViewLayer::FLOOR, "Book shelf"), 
-            "book shelf");
+            "book shelf",
+            random.choose({SpellId::HEALING, SpellId::TELEPORT, SpellId::INVISIBILITY, SpellId::WORD_OF_POWER}));
     case SquareType::LABORATORY: return new Laboratory(ViewObject(ViewId::LABORATORY, ViewLayer::FLOOR, "cauldron"),
                                    "cauldron", 0);
     case SquareType::WORKSHOP:
@@ -641,7 +715,7 @@ Square* SquareFactory::get(SquareType s) {
     case SquareType::POISON_GAS: return new TrapSquare(ViewObject(ViewId::FLOOR, ViewLayer::FLOOR, "floor"),
                                           EffectType::EMIT_POISON_GAS);
     case SquareType::FOUNTAIN:
-        return new Fountain(ViewObject(ViewId::FOUNTAIN, ViewLayer::FLOOR, "Fountain"));
+        return new Fountain(ViewObject(ViewId::FOUNTAIN, ViewLayer::FLOOR, "Fountain"), random.getRandom(123456));
     case SquareType::CHEST:
         return new Chest(ViewObject(ViewId::CHEST, ViewLayer::FLOOR, "Chest"), ViewObject(ViewId::OPENED_CHEST, ViewLayer::FLOOR, "Opened chest"), "chest", CreatureId::RAT, 3, 6, "There is an item inside", "It's full of rats!", "There is gold inside", ItemFactory::chest());
     case SquareType::TREASURE_CHEST:
@@ -662,6 +736,77 @@ Square* SquareFactory::get(SquareType s) {
   return 0;
 }
 
+/** These squares own items or draw random numbers when they are made, so they are made from scratch.*/
+static bool isMadeFromScratch(SquareType type) {
+  switch (type) {
+    case SquareType::GOLD_ORE:
+    case SquareType::IRON_ORE:
+    case SquareType::STONE:
+    case SquareType::LIBRARY:
+    case SquareType::FOUNTAIN:
+    case SquareType::CHEST:
+    case SquareType::COFFIN: return true;
+    default: return false;
+  }
+}
+
+static bool hasPrototype(SquareType type) {
+  if (isMadeFromScratch(type))
+    return false;
+  switch (type) {
+    case SquareType::ABYSS:
+    case SquareType::IRON_BARS:
+    case SquareType::ALTAR:
+    case SquareType::DOWN_STAIRS:
+    case SquareType::UP_STAIRS: return false;
+    default: return true;
+  }
+}
+
+const Square* SquareFactory::getPrototype(SquareType type) {
+  // The random parts are drawn again in get().
+  static vector<unique_ptr<Square>> prototypes = [] {
+    RandomGen random = RandomGen::getStream(RandomStream::PROTOTYPE);
+    vector<unique_ptr<Square>> ret;
+    for (int i = 0; i <= int(SquareType::ALTAR); ++i)
+      ret.emplace_back(hasPrototype(SquareType(i)) ? make(random, SquareType(i)) : nullptr);
+    return ret;
+  }();
+  CHECK(prototypes.at(int(type))) << "No prototype of square " << int(type);
+  return prototypes[int(type)].get();
+}
+
+Square* SquareFactory::get(RandomGen& random, SquareType s) {
+  if (isMadeFromScratch(s))
+    return make(random, s);
+  Square* ret = getPrototype(s)->clone();
+  switch (s) {
+    case SquareType::ROCK_WALL:
+    case SquareType::MOUNTAIN2: ret->setConstructionAttempts(SquareType::FLOOR, random.getRandom(3, 8)); break;
+    case SquareType::CANIF_TREE:
+    case SquareType::DECID_TREE: static_cast<Tree*>(ret)->setNumWood(random.getRandom(15, 30)); break;
+    case SquareType::BUSH: static_cast<Tree*>(ret)->setNumWood(random.getRandom(5, 10)); break;
+    default: break;
+  }
+  return ret;
+}
+
+const ViewObject& SquareFactory::getViewObject(SquareType s) {
+  if (hasPrototype(s))
+    return getPrototype(s)->getViewObject();
+  // Only the look is kept of the squares that are made from scratch.
+  static map<SquareType, ViewObject> viewObjects = [] {
+    RandomGen random = RandomGen::getStream(RandomStream::VIEW, 2);
+    map<SquareType, ViewObject> ret;
+    for (int i = 0; i <= int(SquareType::ALTAR); ++i)
+      if (isMadeFromScratch(SquareType(i)))
+        ret.insert({SquareType(i), unique_ptr<Square>(make(random, SquareType(i)))->getViewObject()});
+    return ret;
+  }();
+  CHECK(viewObjects.count(s)) << "No view object of square " << int(s);
+  return viewObjects.at(s);
+}
+
 Square* SquareFactory::getStairs(StairDirection direction, StairKey key, StairLook look) {
   ViewId id1 = ViewId(0), id2 = ViewId(0);
   switch (look) {
@@ -4,6 +4,7 @@
 #include "pantheon.h"
 
 class Square;
+class ViewObject;
 
 
 inline StairDirection opposite(StairDirection d) {
@@ -16,12 +17,19 @@ inline StairDirection opposite(StairDirection d) {
 
 class SquareFactory {
   public:
-  static Square* get(SquareType);
+  /** Returns a new square of the given type. Most squares are copied from a prototype of their type.*/
+  static Square* get(RandomGen&, SquareType);
+
+  /** Returns how a square of the given type looks, without making one.*/
+  static const ViewObject& getViewObject(SquareType);
+
   static Square* getStairs(StairDirection, StairKey, StairLook = StairLook::NORMAL);
   static Square* getAltar(Deity*);
   static Square* getWater(double depth);
 
   private:
+  static Square* make(RandomGen&, SquareType);
+  static const Square* getPrototype(SquareType);
 };
 
 #endif
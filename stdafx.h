@@ -21,17 +21,24 @@
 #include <unordered_map>
 #include <map>
 #include <queue>
+#include <deque>
 #include <random>
 #include <stdexcept>
 #include <tuple>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <stack>
+#include <array>
+#include <functional>
 #include <typeinfo>
 
 using std::string;
 using std::vector;
 using std::map;
 using std::queue;
+using std::deque;
 using std::unique_ptr;
 using std::default_random_engine;
 using std::function;
@@ -3,6 +3,7 @@
 #include "task.h"
 #include "level.h"
 #include "collective.h"
+#include "shortest_path.h"
 
 Task::Task(Collective* col, Vec2 pos) : position(pos), collective(col) {}
 
@@ -258,19 +259,18 @@ class ApplySquare : public Task {
   }
 
   virtual MoveInfo getMove(Creature* c) override {
-    Vec2 pos = getPosition();
-    if (pos.x == -1) {
-      pos = Vec2(-10000, -10000);
-      for (Vec2 v : randomPermutation(positions))
-        if (!rejectedPosition.count(v) &&
-            (pos - c->getPosition()).length8() > (v - c->getPosition()).length8() &&
-            !c->getLevel()->getSquare(v)->getCreature())
-          pos = v;
-      if (pos.x == -10000) {
+    if (getPosition().x == -1) {
+      vector<Vec2> candidates;
+      for (Vec2 v : positions)
+        if (!rejectedPosition.count(v) && !c->getLevel()->getSquare(v)->getCreature())
+          candidates.push_back(v);
+      vector<Vec2> nearest = ShortestPath::getNearest(c->getLevel(), c->getMovementType(), c->getPosition(),
+          candidates);
+      if (nearest.empty()) {
         setDone();
         return NoMove;
       }
-      setPosition(pos);
+      setPosition(c->getRandom().choose(nearest));
     }
     if (c->getPosition() == getPosition()) {
       if (c->getSquare()->getApplyType(c))
@@ -330,17 +330,18 @@ class Eat : public Task {
   }
 
   virtual MoveInfo getMove(Creature* c) override {
-    Vec2 pos = getPosition();
-    if (pos.x == -1) {
-      pos = Vec2(-10000, -10000);
+    if (getPosition().x == -1) {
+      vector<Vec2> candidates;
       for (Vec2 v : positions)
-        if (!rejectedPosition.count(v) && (pos - c->getPosition()).length8() > (v - c->getPosition()).length8())
-          pos = v;
-      if (pos.x == -10000) {
+        if (!rejectedPosition.count(v))
+          candidates.push_back(v);
+      vector<Vec2> nearest = ShortestPath::getNearest(c->getLevel(), c->getMovementType(), c->getPosition(),
+          candidates);
+      if (nearest.empty()) {
         setDone();
         return NoMove;
       }
-      setPosition(pos);
+      setPosition(nearest[0]);
     }
     Item* chicken = getDeadChicken(c->getSquare());
     if (chicken) {
@@ -350,7 +351,7 @@ class Eat : public Task {
         setDone();
       }};
     }
-    for (Vec2 v : Vec2::directions8(true)) {
+    for (Vec2 v : Vec2::directions8(c->getRandom())) {
       Item* chicken = getDeadChicken(c->getSquare(v));
       if (chicken && c->canMove(v))
         return {1.0, [this, c, v] {
@@ -3,7 +3,21 @@
 #include "debug.h"
 #include "util.h"
 #include "shortest_path.h"
+#include "cluster_graph.h"
+#include "flow_field.h"
+#include "region_map.h"
 #include "level_maker.h"
+#include "time_queue.h"
+#include "tribe.h"
+#include "monster.h"
+#include "square_factory.h"
+#include "square.h"
+#include "view_index.h"
+#include "collective.h"
+#include "task.h"
+#include "creature_factory.h"
+#include "map_memory.h"
+#include "field_of_view.h"
 
 using namespace std;
 
@@ -12,15 +26,19 @@ void testStringConvertion() {
   CHECK(convertFromString<int>("1234") == 1234);
 }
 
+static PCreature makeQueueCreature(double time) {
+  PCreature c(new Creature(ViewObject(ViewId::JACKAL, ViewLayer::CREATURE, ""), Tribe::monster,
+      CATTR(c.name = ""; c.speed = 100; c.size = CreatureSize::SMALL; c.strength = 1; c.dexterity = 3;
+          c.humanoid = false; c.weight = 0.1;), Monster::getFactory(MonsterAIFactory::idle())));
+  c->setTime(time);
+  return c;
+}
+
 void testTimeQueue() {
- /* CreatureAttributes attr = CATTR(c.name = ""; c.speed = 5; c.size = CreatureSize::SMALL; c.strength = 1; c.dexterity = 3; c.humanoid = false; c.weight = 0.1;);
-  PCreature b(new Creature(ViewObject(ViewId::JACKAL, ViewLayer::CREATURE, ""), nullptr, attr));
-  PCreature a(new Creature(ViewObject(ViewId::PLAYER, ViewLayer::CREATURE, ""), nullptr, attr));
-  PCreature c(new Creature(ViewObject(ViewId::JACKAL, ViewLayer::CREATURE, ""), nullptr, attr));
+  PCreature a = makeQueueCreature(1);
+  PCreature b = makeQueueCreature(1.33);
+  PCreature c = makeQueueCreature(1.66);
   Creature* rb = b.get(), *ra = a.get(), *rc = c.get();
-  a->setTime(1);
-  b->setTime(1.33);
-  c->setTime(1.66);
   TimeQueue q;
   q.addCreature(move(a));
   q.addCreature(move(b));
@@ -31,9 +49,23 @@ void testTimeQueue() {
   rb->setTime(2);
   CHECK(q.getNextCreature() == rc);
   rc->setTime(3);
+  CHECK(q.getNextCreature() == ra);
+  ra->setTime(3);
+  CHECK(q.getNextCreature() == rb);
+  rb->setTime(3000);
+  CHECK(q.getNextCreature() == ra);
+  PCreature removed = q.removeCreature(ra);
+  CHECK(removed.get() == ra);
+  CHECK(q.getNextCreature() == rc);
+  CHECK(q.getCurrentTime() == 3);
+  rc->setTime(5000);
   CHECK(q.getNextCreature() == rb);
-  rb->setTime(3);
-  CHECK(q.getNextCreature() == ra);*/
+  vector<Creature*> all {rb, rc};
+  CHECK(q.getAllCreatures() == all);
+  PCreature d = makeQueueCreature(0.5);
+  Creature* rd = d.get();
+  q.addCreature(move(d));
+  CHECK(q.getNextCreature() == rd);
 }
 
 void testRectangleIterator() {
@@ -62,6 +94,8 @@ void testRectangle() {
   CHECK(Rectangle(0, 0, 4, 4).intersects(Rectangle(1, -1, 3, 5)));
   CHECK(Rectangle(0, 0, 4, 4).intersects(Rectangle(1, 1, 3, 3)));
   CHECK(Rectangle(0, 0, 4, 4).intersects(Rectangle(0, 0, 3, 4)));
+  CHECK(Rectangle(0, 0, 4, 4) == Rectangle(4, 4));
+  CHECK(Rectangle(0, 0, 4, 4) != Rectangle(0, 0, 4, 3));
 }
 
 void testValueCheck() {
@@ -91,6 +125,53 @@ void testShortestPath() {
   CHECK(res == expected);
 }
 
+void testShortestPathThreads() {
+  vector<thread> threads;
+  for (int i : Range(4))
+    threads.emplace_back([] {
+        for (int j : Range(100))
+          testShortestPath();
+    });
+  for (thread& t : threads)
+    t.join();
+}
+
+void testShortestPathBudget() {
+  vector<vector<double> > table { { 2, 1, 2, 18, 1}, { 1, 1, 18, 1, 2}, {2, 6, 10, 1,1}, {1, 2, 1, 8, 1}, {5, 3, 1, 1, 2}};
+  auto entryFun = [table](Vec2 pos) { return table[pos.y][pos.x];};
+  auto lengthFun = [] (Vec2 v) { return v.length4(); };
+  int oldBudget = ShortestPath::getTurnBudget();
+  ShortestPath::setTurnBudget(3);
+  ShortestPath path(Rectangle(5, 5), entryFun, lengthFun, Vec2::directions4(), Vec2(4, 0), Vec2(1, 0), 0, true);
+  int numTurns = 1;
+  while (path.isSuspended()) {
+    CHECK(!path.isReachable(Vec2(1, 0)));
+    ShortestPath::startTurn();
+    path.resumeTowards(entryFun, lengthFun, Vec2(1, 0));
+    ++numTurns;
+  }
+  CHECK(numTurns > 3);
+  // A search suspended on a thread that has finished since is continued on this one.
+  unique_ptr<ShortestPath> moved;
+  thread([&] {
+      moved.reset(new ShortestPath(Rectangle(5, 5), entryFun, lengthFun, Vec2::directions4(), Vec2(4, 0),
+          Vec2(1, 0), 0, true));
+  }).join();
+  CHECK(moved->isSuspended());
+  while (moved->isSuspended()) {
+    ShortestPath::startTurn();
+    moved->resumeTowards(entryFun, lengthFun, Vec2(1, 0));
+  }
+  CHECK(moved->getNextMove(Vec2(1, 0)) == path.getNextMove(Vec2(1, 0)));
+  ShortestPath::setTurnBudget(oldBudget);
+  double cost = 0;
+  for (Vec2 v = Vec2(1, 0); v != Vec2(4, 0);) {
+    v = path.getNextMove(v);
+    cost += entryFun(v);
+  }
+  CHECK(cost == 17) << cost;
+}
+
 void testAStar() {
   vector<vector<double> > table { { 1, 1, 6, 1, 1}, { 1, 1, 6, 1, 1}, {1, 1, 1, 1,1}, {1, 1, 6, 1, 1}, {1, 1, 6, 1, 1}};
   ShortestPath path(Rectangle(5, 5),
@@ -122,15 +203,297 @@ void testShortestPathReverse() {
   CHECK(res == expected);*/
 }
 
+void testClusterGraph() {
+  const int width = 70;
+  const int height = 50;
+  std::mt19937 gen(123);
+  Table<double> table(width, height);
+  for (Vec2 v : Rectangle(width, height))
+    table[v] = gen() % 3 == 0 ? ShortestPath::infinity : gen() % 4 == 0 ? 5 : 1;
+  auto entryFun = [&table](Vec2 pos) { return table[pos]; };
+  ClusterGraph graph(Rectangle(width, height), entryFun);
+  auto check = [&] (Vec2 from, Vec2 to) {
+    ShortestPath path(Rectangle(width, height), entryFun, [] (Vec2 v) { return v.length8(); },
+        Vec2::directions8(), to, from);
+    Optional<vector<Vec2>> waypoints = graph.getWaypoints(from, to);
+    CHECK(!!waypoints == path.isReachable(from)) << from << " " << to;
+    if (!waypoints)
+      return;
+    CHECK(waypoints->front() == from && waypoints->back() == to);
+    for (int i = 1; i < waypoints->size(); ++i) {
+      Vec2 v = (*waypoints)[i - 1];
+      Vec2 w = (*waypoints)[i];
+      if (v.dist8(w) > 1) {
+        Rectangle cluster = ClusterGraph::getCluster(Rectangle(width, height), v);
+        CHECK(w.inRectangle(cluster));
+        CHECK(ShortestPath(cluster, entryFun, [] (Vec2 v) { return v.length8(); }, Vec2::directions8(), w, v)
+            .isReachable(v));
+      }
+    }
+  };
+  auto checkRandom = [&] {
+    vector<Vec2> passable;
+    for (Vec2 v : Rectangle(width, height))
+      if (table[v] < ShortestPath::infinity)
+        passable.push_back(v);
+    for (int i : Range(200))
+      check(passable[gen() % passable.size()], Vec2(gen() % width, gen() % height));
+  };
+  checkRandom();
+  // Cut the area in two with a wall.
+  for (int y : Range(height)) {
+    table[Vec2(35, y)] = ShortestPath::infinity;
+    graph.squareChanged(Vec2(35, y));
+  }
+  checkRandom();
+  CHECK(!graph.getWaypoints(Vec2(0, 0), Vec2(69, 49)));
+}
+
+void testRegionMap() {
+  const int width = 40;
+  const int height = 30;
+  std::mt19937 gen(123);
+  Table<bool> passable(width, height);
+  for (Vec2 v : Rectangle(width, height))
+    passable[v] = gen() % 5 < 3;
+  RegionMap regions(Rectangle(width, height), [&passable](Vec2 pos) { return passable[pos]; });
+  auto check = [&] (Vec2 from, Vec2 to) {
+    if (from == to)
+      return;
+    ShortestPath path(Rectangle(width, height),
+        [&] (Vec2 pos) { return passable[pos] || pos == from ? 1 : ShortestPath::infinity; },
+        [] (Vec2 v) { return v.length8(); }, Vec2::directions8(), to, from);
+    CHECK(regions.canReach(from, to) == path.isReachable(from)) << from << " " << to;
+  };
+  // Opening and closing squares merges and splits the regions.
+  for (int i : Range(300)) {
+    Vec2 pos(gen() % width, gen() % height);
+    passable[pos] = !passable[pos];
+    regions.squareChanged(pos);
+    for (int j : Range(10))
+      check(Vec2(gen() % width, gen() % height), Vec2(gen() % width, gen() % height));
+  }
+}
+
+void testBuilderAttribs() {
+  Level::Builder builder(10, 10, "test", RandomGen());
+  for (Vec2 v : Rectangle(10, 10))
+    builder.putSquare(v, SquareType::FLOOR);
+  builder.putSquare(Vec2(3, 4), SquareType::PATH, {SquareAttrib::ROAD_CUT_THRU, SquareAttrib::FOG});
+  builder.addAttrib(Vec2(3, 4), SquareAttrib::NO_DIG);
+  // Attributes remain when the square is changed.
+  builder.putSquare(Vec2(3, 4), SquareType::FLOOR, SquareAttrib::ROOM);
+  builder.removeAttrib(Vec2(3, 4), SquareAttrib::ROAD_CUT_THRU);
+  for (SquareAttrib attr : {SquareAttrib::NO_DIG, SquareAttrib::FOG, SquareAttrib::ROOM})
+    CHECK(builder.hasAttrib(Vec2(3, 4), attr));
+  CHECK(!builder.hasAttrib(Vec2(3, 4), SquareAttrib::ROAD_CUT_THRU));
+  CHECK(!builder.hasAttrib(Vec2(4, 3), SquareAttrib::NO_DIG));
+  builder.setHeightMap(Vec2(2, 2), 0.25);
+  CHECK(builder.getHeightMap(Vec2(2, 2)) == 0.25);
+  CHECK(builder.getHeightMap(Vec2(2, 3)) == 0);
+}
+
+void testLevelChanges() {
+  Level::Builder builder(10, 10, "test", RandomGen());
+  for (Vec2 v : Rectangle(10, 10))
+    builder.putSquare(v, SquareType::FLOOR);
+  PLevel level = builder.build(nullptr, false);
+  int changes = level->getNumChanges();
+  level->replaceSquare(Vec2(3, 3), PSquare(SquareFactory::get(level->getRandom(), SquareType::ROCK_WALL)));
+  level->getSquare(Vec2(5, 5))->addPoisonGas(0.5);
+  for (Vec2 v : {Vec2(3, 3), Vec2(5, 5)})
+    CHECK(level->getLastChange(v) > changes);
+  CHECK(level->getLastChange(Vec2(4, 4)) <= changes);
+  CHECK(level->getNumChanges() >= level->getLastChange(Vec2(5, 5)));
+}
+
+void testMemoryChanges() {
+  Level::Builder builder(20, 20, "test", RandomGen());
+  // Sight stops at the walls around the level.
+  for (Vec2 v : Rectangle(20, 20))
+    builder.putSquare(v, v.inRectangle(Rectangle(1, 1, 19, 19)) ? SquareType::FLOOR : SquareType::ROCK_WALL);
+  PLevel level = builder.build(nullptr, false);
+  PCreature creature = CreatureFactory::fromId(level->getRandom(), CreatureId::IMP, Tribe::player);
+  Creature* imp = creature.get();
+  level->putCreature(Vec2(10, 10), imp);
+  Collective collective(nullptr, RandomGen());
+  collective.setLevel(level.get());
+  collective.addCreature(imp, MinionType::IMP);
+  collective.update(imp);
+  const MapMemory& memory = collective.getMemory(level.get());
+  CHECK(memory.hasViewIndex(Vec2(12, 12)));
+  int changes = memory.getNumChanges();
+  // Seeing the same squares again doesn't change the memory.
+  collective.update(imp);
+  CHECK(memory.getNumChanges() == changes);
+  level->replaceSquare(Vec2(12, 12), PSquare(SquareFactory::get(level->getRandom(), SquareType::ROCK_WALL)));
+  collective.update(imp);
+  CHECK(memory.getLastChange(Vec2(12, 12)) > changes && memory.getLastChange(Vec2(11, 11)) <= changes);
+}
+
+// The recursive shadowcasting that FieldOfView used before its rows were packed into bits, kept as a reference.
+static void referenceShadowcast(int range, int h, int x1, int y1, int x2, int y2,
+    function<bool (int, int)> isBlocking, function<void (int, int)> setVisible) {
+  if (y2 * x1 >= y1 * x2 || h > range)
+    return;
+  int leftx = x1, lefty = y1, rightx = x2, righty = y2;
+  int left_v = (int)floor((double)x1 / y1 * h), right_v = (int)ceil((double)x2 / y2 * h),
+      left_b = (int)floor((double)x1 / y1 * (h - 1)), right_b = (int)ceil((double)x2 / y2 * (h + 1));
+  if (left_v % 2)
+    ++left_v;
+  if (right_v % 2)
+    --right_v;
+  if (left_b % 2)
+    ++left_b;
+  if (left_b >= -range && left_b <= range && isBlocking(left_b / 2, h / 2)) {
+    leftx = left_b + 1;
+    lefty = h + (left_b >= 0 ? -1 : 1);
+  }
+  left_v = max(left_v, -range);
+  right_v = min(right_v, range);
+  bool prevBlocking = false;
+  for (int i = left_v / 2; i <= right_v / 2; ++i) {
+    setVisible(i, h / 2);
+    bool blocking = isBlocking(i, h / 2);
+    if (i > left_v / 2 && blocking && !prevBlocking)
+      referenceShadowcast(range, h + 2, leftx, lefty, i * 2 - 1, h + (i <= 0 ? -1 : 1), isBlocking, setVisible);
+    if (blocking) {
+      leftx = i * 2 + 1;
+      lefty = h + (i >= 0 ? -1 : 1);
+    }
+    prevBlocking = blocking;
+  }
+  referenceShadowcast(range, h + 2, leftx, lefty, rightx, righty, isBlocking, setVisible);
+}
+
+static vector<Vec2> getReferenceVisibleTiles(const Table<PSquare>& squares, Vec2 from) {
+  // The sight range of FieldOfView. Squares outside of the level block the view.
+  const int range = 30;
+  auto blocks = [&] (Vec2 v) { return !v.inRectangle(squares.getBounds()) || !squares[v]->canSeeThru(); };
+  set<Vec2> visible {from};
+  auto setVisible = [&] (Vec2 v) {
+    if (v.x * v.x + v.y * v.y <= range * range)
+      visible.insert(from + v);
+  };
+  for (int quadrant : Range(4)) {
+    // Rotates the quadrant's coordinates by quadrant * 90 degrees.
+    auto rotate = [quadrant] (int x, int y) {
+      for (int i : Range(quadrant)) {
+        int tmp = x;
+        x = y;
+        y = -tmp;
+      }
+      return Vec2(x, y);
+    };
+    referenceShadowcast(2 * range, 2, -1, 1, 1, 1,
+        [&] (int x, int y) { return blocks(from + rotate(x, y)); },
+        [&] (int x, int y) { setVisible(rotate(x, y)); });
+  }
+  return vector<Vec2>(visible.begin(), visible.end());
+}
+
+void testFieldOfView() {
+  std::mt19937 gen(123);
+  RandomGen random;
+  for (int density : {3, 20}) {
+    Rectangle bounds(70, 50);
+    Table<PSquare> squares(bounds);
+    auto putSquare = [&] (Vec2 v) {
+      squares[v].reset(SquareFactory::get(random, gen() % density == 0 ? SquareType::ROCK_WALL : SquareType::FLOOR));
+    };
+    for (Vec2 v : bounds)
+      putSquare(v);
+    FieldOfView fov(squares);
+    auto check = [&] (Vec2 from) {
+      vector<Vec2> tiles = fov.getVisibleTiles(from);
+      sort(tiles.begin(), tiles.end());
+      CHECK(tiles == getReferenceVisibleTiles(squares, from)) << "Visible tiles differ at " << from;
+    };
+    // Viewpoints on and near the edges see the padding around the level.
+    for (Vec2 v : bounds)
+      if (!v.inRectangle(bounds.minusMargin(2)) || gen() % 10 == 0)
+        check(v);
+    // Changed squares must drop the cached visibilities that they affect.
+    for (int i : Range(100)) {
+      Vec2 v(gen() % bounds.getW(), gen() % bounds.getH());
+      putSquare(v);
+      fov.squareChanged(v);
+      check(Vec2(gen() % bounds.getW(), gen() % bounds.getH()));
+    }
+  }
+}
+
+void testFlowField() {
+  const double inf = ShortestPath::infinity;
+  vector<vector<double> > table {
+      {1, 1, inf, 1, 1},
+      {1, 1, inf, 1, 1},
+      {1, 1, inf, 5, 1},
+      {1, 1, 1, inf, 1},
+      {inf, inf, inf, 1, 1}};
+  FlowField field(Rectangle(5, 5), [table](Vec2 pos) { return table[pos.y][pos.x];}, Vec2(4, 0));
+  CHECK(field.getDistance(Vec2(4, 0)) == 0);
+  CHECK(field.getDistance(Vec2(0, 4)) == inf);
+  vector<Vec2> res {Vec2(0, 0)};
+  while (res.back() != Vec2(4, 0))
+    res.push_back(res.back() + field.getMoves(res.back()).at(0));
+  CHECK(res.size() == 9 && !contains(res, Vec2(3, 2)));
+  CHECK(field.getDistance(Vec2(0, 0)) == 8);
+}
+
+void testViewIndex() {
+  ViewObject floor(ViewId::FLOOR, ViewLayer::FLOOR, "floor", true);
+  ViewObject orc(ViewId::GOBLIN, ViewLayer::CREATURE, "Orc");
+  orc.setHostile(false);
+  orc.setAttack(5);
+  orc.setDefense(-3);
+  CHECK(floor.getBareDescription() == "Floor" && floor.castsShadow() && !floor.isHostile());
+  CHECK(orc.isFriendly() && !orc.isHostile() && *orc.getAttack() == 5 && *orc.getDefense() == -3);
+  ViewIndex index;
+  CHECK(index.isEmpty() && !index.hasHighlight());
+  index.insert(floor);
+  index.insert(orc);
+  index.setHighlight(HighlightType::FOG, 0.5);
+  ViewIndex copy(index);
+  index.removeObject(ViewLayer::CREATURE);
+  CHECK(!index.hasObject(ViewLayer::CREATURE) && copy.hasObject(ViewLayer::CREATURE));
+  CHECK(copy.getObject(ViewLayer::CREATURE).getDescription() == "Orc");
+  CHECK(copy.getTopObject(allLayers)->id() == ViewId::GOBLIN);
+  CHECK(copy.getHighlight().type == HighlightType::FOG && copy.getHighlight().amount == 0.5);
+  copy = ViewIndex();
+  CHECK(copy.isEmpty());
+}
+
 void testRandom() {
-  CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 2, 3}, 1) == "pokpok");
-  CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 2, 3}, 2) == "kwakwa");
-  CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 2, 3}, 3) == "kwakwa");
-  CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 2, 3}, 4) == "pikpik");
-  CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 2, 3}, 5) == "pikpik");
-  CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 2, 3}, 6) == "pikpik");
-  CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 0, 3}, 1) == "pokpok");
-  CHECK(chooseRandom<string>({"pokpok", "kwakwa", "pikpik"}, { 1, 0, 3}, 2) == "pikpik");
+  RandomGen random;
+  CHECK(random.getRandom({ 1, 2, 3}, 1) == 0);
+  CHECK(random.getRandom({ 1, 2, 3}, 2) == 1);
+  CHECK(random.getRandom({ 1, 2, 3}, 3) == 1);
+  CHECK(random.getRandom({ 1, 2, 3}, 4) == 2);
+  CHECK(random.getRandom({ 1, 2, 3}, 5) == 2);
+  CHECK(random.getRandom({ 1, 2, 3}, 6) == 2);
+  CHECK(random.getRandom({ 1, 0, 3}, 1) == 0);
+  CHECK(random.getRandom({ 1, 0, 3}, 2) == 2);
+}
+
+void testRandomStreams() {
+  RandomGen::setGameSeed(123);
+  RandomGen a = RandomGen::getStream(RandomStream::CREATURE, 5);
+  RandomGen b = a.split(1);
+  RandomGen c = a.split(2);
+  vector<int> v1, v2;
+  for (int i : Range(100))
+    v1.push_back(a.getRandom(1000000));
+  // Splitting by id doesn't advance the stream.
+  CHECK(a.split(1).getRandom(1000000) == b.getRandom(1000000));
+  CHECK(b.getRandom(1000000) != c.getRandom(1000000));
+  RandomGen::setGameSeed(123);
+  RandomGen d = RandomGen::getStream(RandomStream::CREATURE, 5);
+  for (int i : Range(100))
+    v2.push_back(d.getRandom(1000000));
+  CHECKEQ(v1, v2);
+  RandomGen e = RandomGen::getStream(RandomStream::CREATURE, 6);
+  CHECK(e.getRandom(1000000) != v1[0]);
 }
 
 void testRange() {
@@ -224,17 +587,17 @@ void testVec2() {
   checkEqual(Vec2(3, 3).approxL1(), make_pair(Vec2(1, 1), Vec2(1, 1)));
   checkEqual(Vec2(3, 1).approxL1(), make_pair(Vec2(1, 1), Vec2(1, 0)));
 
-  CHECKEQ(Vec2(1, 0).getBearing(), "east");
-  CHECKEQ(Vec2(3, 1).getBearing(), "east");
-  CHECKEQ(Vec2(1, 1).getBearing(), "south-east");
-  CHECKEQ(Vec2(2, 1).getBearing(), "south-east");
-  CHECKEQ(Vec2(0, 1).getBearing(), "south");
-  CHECKEQ(Vec2(-1, 3).getBearing(), "south");
-  CHECKEQ(Vec2(-1, 1).getBearing(), "south-west");
-  CHECKEQ(Vec2(-1, 0).getBearing(), "west");
-  CHECKEQ(Vec2(-1, -1).getBearing(), "north-west");
-  CHECKEQ(Vec2(0, -1).getBearing(), "north");
-  CHECKEQ(Vec2(1, -1).getBearing(), "north-east");
+  CHECKEQ(getCardinalName(Vec2(1, 0).getBearing().getCardinalDir()), string("east"));
+  CHECKEQ(getCardinalName(Vec2(3, 1).getBearing().getCardinalDir()), string("east"));
+  CHECKEQ(getCardinalName(Vec2(1, 1).getBearing().getCardinalDir()), string("south-east"));
+  CHECKEQ(getCardinalName(Vec2(2, 1).getBearing().getCardinalDir()), string("south-east"));
+  CHECKEQ(getCardinalName(Vec2(0, 1).getBearing().getCardinalDir()), string("south"));
+  CHECKEQ(getCardinalName(Vec2(-1, 3).getBearing().getCardinalDir()), string("south"));
+  CHECKEQ(getCardinalName(Vec2(-1, 1).getBearing().getCardinalDir()), string("south-west"));
+  CHECKEQ(getCardinalName(Vec2(-1, 0).getBearing().getCardinalDir()), string("west"));
+  CHECKEQ(getCardinalName(Vec2(-1, -1).getBearing().getCardinalDir()), string("north-west"));
+  CHECKEQ(getCardinalName(Vec2(0, -1).getBearing().getCardinalDir()), string("north"));
+  CHECKEQ(getCardinalName(Vec2(1, -1).getBearing().getCardinalDir()), string("north-east"));
 }
 
 void testConcat() {
@@ -255,6 +618,20 @@ void testTable() {
   CHECK(t2[39][49] == 39 * 49);
 }
 
+void testBitTable() {
+  Rectangle bounds(15, 20, 40, 50);
+  BitTable t(bounds);
+  for (Vec2 v : bounds)
+    t.set(v, (v.x * v.y) % 3 == 0);
+  for (Vec2 v : bounds)
+    CHECK(t[v] == ((v.x * v.y) % 3 == 0));
+  t.set(Vec2(39, 49), false);
+  CHECK(!t[Vec2(39, 49)] && t[Vec2(39, 48)]);
+  BitTable t2(Rectangle(7, 9), true);
+  for (Vec2 v : Rectangle(7, 9))
+    CHECK(t2[v]);
+}
+
 void testProjection() {
 /*  Vec2 proj = AllegroView::projectOnBorders(Rectangle(5, 5), Vec2(6, 0));
   CHECKEQ(proj, Vec2(4, 1));
@@ -283,13 +660,13 @@ void testProjection() {
 }
 
 void testVec2Box0() {
-  vector<Vec2> v = Vec2(-2, -3).box(0, false);
+  vector<Vec2> v = Vec2(-2, -3).box(0);
   vector<Vec2> res { Vec2(-2, -3) };
   CHECKEQ(v, res);
 }
 
 void testVec2Box1() {
-  vector<Vec2> v = Vec2(-2, -3).box(1, false);
+  vector<Vec2> v = Vec2(-2, -3).box(1);
   vector<Vec2> res { Vec2(-3, -4), Vec2(-2, -4), Vec2(-1, -4),
       Vec2(-1, -3), Vec2(-1, -2), Vec2(-2, -2),
       Vec2(-3, -2), Vec2(-3, -3) };
@@ -297,7 +674,7 @@ void testVec2Box1() {
 }
 
 void testVec2Box2() {
-  vector<Vec2> v = Vec2(-2, -3).box(2, false);
+  vector<Vec2> v = Vec2(-2, -3).box(2);
   vector<Vec2> res { Vec2(-4, -5),
       Vec2(-3, -5), Vec2(-2, -5), Vec2(-1, -5),
       Vec2(0, -5), Vec2(0, -4), Vec2(0, -3),
@@ -309,8 +686,9 @@ void testVec2Box2() {
 
 void testRandomExit() {
   Rectangle r(5, 10, 15, 20);
+  RandomGen random;
   for (int i : Range(1000)) {
-    Vec2 v = LevelMaker::getRandomExit(r);
+    Vec2 v = LevelMaker::getRandomExit(random, r);
     CHECK((v.x == 5) ^ (v.x == 14) ^ (v.y == 10) ^ (v.y == 19));
   }
 }
@@ -334,6 +712,7 @@ void testTransform2() {
 
 int main() {
   Debug::init();
+  Tribe::init();
   testStringConvertion();
   testTimeQueue();
   testRectangleIterator();
@@ -343,7 +722,18 @@ int main() {
   testAStar();
   testShortestPath2();
   testShortestPathReverse();
+  testShortestPathThreads();
+  testShortestPathBudget();
+  testClusterGraph();
+  testFlowField();
+  testRegionMap();
+  testBuilderAttribs();
+  testLevelChanges();
+  testMemoryChanges();
+  testFieldOfView();
+  testViewIndex();
   testRandom();
+  testRandomStreams();
   testRange();
   testContains();
   testPredicates();
@@ -352,6 +742,7 @@ int main() {
   testVec2();
   testConcat();
   testTable();
+  testBitTable();
   testVec2();
   testRectangle();
   testProjection();
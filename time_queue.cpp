@@ -4,59 +4,152 @@
 
 using namespace std;
 
-TimeQueue::TimeQueue() : queue([](QElem e1, QElem e2) {
-    return e1.time > e2.time || (e1.time == e2.time && e1.creature->getUniqueId() > e2.creature->getUniqueId());
-}) {}
+const int TimeQueue::numBuckets;
+constexpr double TimeQueue::slotWidth;
+
+TimeQueue::TimeQueue() : buckets(numBuckets, -1) {}
+
+static long long getSlot(double time, double width) {
+  return (long long) floor(time / width);
+}
+
+bool TimeQueue::isEarlier(int n1, int n2) const {
+  const Node& e1 = nodes[n1];
+  const Node& e2 = nodes[n2];
+  return e1.time < e2.time || (e1.time == e2.time && e1.creature->getUniqueId() < e2.creature->getUniqueId());
+}
 
 void TimeQueue::addCreature(PCreature c) {
-  queue.push({c.get(), c->getTime()});
-  creatures.push_back(std::move(c));
+  int index;
+  if (freeNodes.empty()) {
+    index = nodes.size();
+    nodes.emplace_back();
+  } else {
+    index = freeNodes.back();
+    freeNodes.pop_back();
+  }
+  Node& node = nodes[index];
+  handles[c.get()] = index;
+  node.creature = std::move(c);
+  node.prevAll = lastAll;
+  node.nextAll = -1;
+  if (lastAll > -1)
+    nodes[lastAll].nextAll = index;
+  else
+    firstAll = index;
+  lastAll = index;
+  schedule(index);
 }
-  
+
 PCreature TimeQueue::removeCreature(Creature* cRef) {
-  int ind = -1;
-  for (int i : All(creatures))
-    if (creatures[i].get() == cRef) {
-      ind = i;
-      break;
-    }
-  CHECK(ind > -1) << "Creature not found";
-  PCreature ret = std::move(creatures[ind]);
-  creatures.erase(creatures.begin() + ind);
-  dead.insert(ret.get());
-  return ret;
+  CHECK(handles.count(cRef)) << "Creature not found";
+  int index = handles.at(cRef);
+  handles.erase(cRef);
+  unschedule(index);
+  Node& node = nodes[index];
+  if (node.prevAll > -1)
+    nodes[node.prevAll].nextAll = node.nextAll;
+  else
+    firstAll = node.nextAll;
+  if (node.nextAll > -1)
+    nodes[node.nextAll].prevAll = node.prevAll;
+  else
+    lastAll = node.prevAll;
+  freeNodes.push_back(index);
+  return std::move(node.creature);
 }
 
 vector<Creature*> TimeQueue::getAllCreatures() const {
   vector<Creature*> ret;
-  for (const PCreature& c : creatures)
-    ret.push_back(c.get());
+  for (int index = firstAll; index > -1; index = nodes[index].nextAll)
+    ret.push_back(nodes[index].creature.get());
   return ret;
 }
 
-void TimeQueue::removeDead() {
-  while (!queue.empty() && dead.count(queue.top().creature))
-    queue.pop();
+void TimeQueue::linkToBucket(int index) {
+  Node& node = nodes[index];
+  int& head = buckets[node.slot & (numBuckets - 1)];
+  node.prev = -1;
+  node.next = head;
+  if (head > -1)
+    nodes[head].prev = index;
+  head = index;
+}
+
+void TimeQueue::unlinkFromBucket(int index) {
+  Node& node = nodes[index];
+  if (node.prev > -1)
+    nodes[node.prev].next = node.next;
+  else
+    buckets[node.slot & (numBuckets - 1)] = node.next;
+  if (node.next > -1)
+    nodes[node.next].prev = node.prev;
+}
+
+void TimeQueue::schedule(int index) {
+  Node& node = nodes[index];
+  node.time = node.creature->getTime();
+  node.slot = getSlot(node.time, slotWidth);
+  if (numScheduled == 0 || node.slot < currentSlot) {
+    for (int elem : current)
+      linkToBucket(elem);
+    current.clear();
+    currentSlot = node.slot;
+  }
+  ++numScheduled;
+  if (node.slot == currentSlot)
+    current.insert(upper_bound(current.begin(), current.end(), index,
+          [this](int n1, int n2) { return isEarlier(n2, n1); }), index);
+  else
+    linkToBucket(index);
+}
+
+void TimeQueue::unschedule(int index) {
+  if (nodes[index].slot == currentSlot)
+    current.erase(std::find(current.begin(), current.end(), index));
+  else
+    unlinkFromBucket(index);
+  --numScheduled;
+}
+
+void TimeQueue::fillCurrentSlot() {
+  CHECK(numScheduled > 0);
+  int numVisited = 0;
+  while (current.empty()) {
+    if (++numVisited > numBuckets) {
+      // All creatures are more than a full round of buckets ahead, so jump straight to the earliest one.
+      long long minSlot = nodes[firstAll].slot;
+      for (int index = firstAll; index > -1; index = nodes[index].nextAll)
+        minSlot = min(minSlot, nodes[index].slot);
+      currentSlot = minSlot - 1;
+      numVisited = 0;
+    }
+    ++currentSlot;
+    for (int index = buckets[currentSlot & (numBuckets - 1)]; index > -1;) {
+      int next = nodes[index].next;
+      if (nodes[index].slot == currentSlot) {
+        unlinkFromBucket(index);
+        current.push_back(index);
+      }
+      index = next;
+    }
+  }
+  sort(current.begin(), current.end(), [this](int n1, int n2) { return isEarlier(n2, n1); });
 }
 
 Creature* TimeQueue::getMinCreature() {
-  CHECK(creatures.size() > 0);
-  removeDead();
-  QElem elem = queue.top();
-  if (elem.time == elem.creature->getTime())
-    return elem.creature;
-  else {
-    queue.pop();
-    removeDead();
-    queue.push({elem.creature, elem.creature->getTime()});
-    CHECK(queue.top().creature->getTime() == queue.top().time);
-    return queue.top().creature;
+  CHECK(numScheduled > 0);
+  while (1) {
+    if (current.empty())
+      fillCurrentSlot();
+    int index = current.back();
+    Node& node = nodes[index];
+    if (node.time == node.creature->getTime())
+      return node.creature.get();
+    // The creature has spent some time since it was scheduled.
+    unschedule(index);
+    schedule(index);
   }
-  /*for (PCreature& c : creatures)
-    if (c->getTime() < min || (c->getTime() == min && c->getUniqueId() < res->getUniqueId())) {
-      res = c.get();
-      min = c->getTime();
-    }*/
 }
 
 Creature* TimeQueue::getNextCreature() {
@@ -65,7 +158,7 @@ Creature* TimeQueue::getNextCreature() {
 }
 
 double TimeQueue::getCurrentTime() {
-  if (creatures.size() > 0) 
+  if (numScheduled > 0)
     return getMinCreature()->getTime();
   else
     return 0;
@@ -5,6 +5,9 @@
 #include "util.h"
 #include "creature.h"
 
+/** Schedules creature moves by time. Implemented as a calendar queue: creature times are quantized into
+  * slots, and every slot maps to a bucket that holds an intrusive linked list of creatures. Adding, removing
+  * and rescheduling a creature doesn't depend on the number of creatures in the queue.*/
 class TimeQueue {
   public:
   TimeQueue();
@@ -15,15 +18,39 @@ class TimeQueue {
   double getCurrentTime();
 
   private:
-  vector<PCreature> creatures;
-  struct QElem {
-    Creature* creature;
+  const static int numBuckets = 4096;
+  constexpr static double slotWidth = 0.25;
+
+  struct Node {
+    PCreature creature;
     double time;
+    long long slot;
+    // Links in the bucket list.
+    int prev;
+    int next;
+    // Links in the list of all creatures, kept in the order they were added.
+    int prevAll;
+    int nextAll;
   };
-  priority_queue<QElem, vector<QElem>, function<bool(QElem, QElem)>> queue;
-  unordered_set<Creature*> dead;
-  void removeDead();
+
+  bool isEarlier(int node1, int node2) const;
+  void schedule(int node);
+  void unschedule(int node);
+  void linkToBucket(int node);
+  void unlinkFromBucket(int node);
+  void fillCurrentSlot();
   Creature* getMinCreature();
+
+  vector<Node> nodes;
+  vector<int> freeNodes;
+  unordered_map<const Creature*, int> handles;
+  vector<int> buckets;
+  // Creatures in the current slot, sorted so that the next one to move is at the back.
+  vector<int> current;
+  long long currentSlot = 0;
+  int numScheduled = 0;
+  int firstAll = -1;
+  int lastAll = -1;
 };
 
 #endif
@@ -50,7 +50,7 @@ class Portal : public Trigger {
   }
 
   virtual bool interceptsFlyingItem(Item* it) const override {
-    return other && !Random.roll(5);
+    return other && !level->getRandom().roll(5);
   }
 
   virtual void onInterceptFlyingItem(PItem it, const Attack& a, int remainingDist, Vec2 dir) {
@@ -4,8 +4,43 @@
 
 using namespace std;
 
+static uint64_t mix(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+static const uint64_t golden = 0x9e3779b97f4a7c15ull;
+
+RandomGen::RandomGen(uint64_t k) : key(k) {
+}
+
 void RandomGen::init(int seed) {
-  generator.seed(seed);
+  key = mix(seed);
+  counter = 0;
+  shuffleMap.clear();
+}
+
+RandomGen::result_type RandomGen::operator()() {
+  return mix(key + ++counter * golden);
+}
+
+RandomGen RandomGen::split(uint64_t id) const {
+  return RandomGen(mix(key ^ mix(id * golden + 1)));
+}
+
+RandomGen RandomGen::split() {
+  return RandomGen((*this)());
+}
+
+uint64_t RandomGen::gameKey = 0;
+
+void RandomGen::setGameSeed(int seed) {
+  gameKey = mix(seed);
+}
+
+RandomGen RandomGen::getStream(RandomStream stream, uint64_t id) {
+  return RandomGen(gameKey).split(int(stream)).split(id);
 }
 
 int RandomGen::getRandom(int max) {
@@ -14,7 +49,7 @@ int RandomGen::getRandom(int max) {
 
 int RandomGen::getRandom(int min, int max) {
   CHECK(max > min);
-  return uniform_int_distribution<int>(min, max - 1)(generator);
+  return uniform_int_distribution<int>(min, max - 1)(*this);
 }
 
 void RandomGen::makeShuffle(string id, int min, int max) {
@@ -24,7 +59,7 @@ void RandomGen::makeShuffle(string id, int min, int max) {
   info.maxRange = max;
   for (int i : Range(min, max))
     info.numbers.push_back(i);
-  random_shuffle(info.numbers.begin(), info.numbers.end(), [](int a) { return Random.getRandom(a);});
+  random_shuffle(info.numbers.begin(), info.numbers.end(), [this](int a) { return getRandom(a);});
   shuffleMap.insert({id, std::move(info)});
 }
 
@@ -49,7 +84,7 @@ string getCardinalName(Dir d) {
     case Dir::E: return "east";
     case Dir::W: return "west";
     case Dir::NE: return "north-east";
-    case Dir::NW: return "north-weast";
+    case Dir::NW: return "north-west";
     case Dir::SE: return "south-east";
     case Dir::SW: return "south-west";
   }
@@ -62,7 +97,7 @@ int RandomGen::getRandom(const vector<double>& weights, double r) {
   for (double elem : weights)
     sum += elem;
   if (r == -1)
-    r = Random.getDouble(0, sum);
+    r = getDouble(0, sum);
   sum = 0;
   for (int i : All(weights)) {
     sum += weights[i];
@@ -77,17 +112,16 @@ bool RandomGen::roll(int chance) {
 }
 
 double RandomGen::getDouble() {
-  return defaultDist(generator);
+  return uniform_real_distribution<double>()(*this);
 }
 
 double RandomGen::getDouble(double a, double b) {
-  return uniform_real_distribution<double>(a, b)(generator);
+  return uniform_real_distribution<double>(a, b)(*this);
 }
 
-RandomGen Random;
-
 template string convertToString<int>(const int&);
 template string convertToString<size_t>(const size_t&);
+template string convertToString<long long>(const long long&);
 template string convertToString<char>(const char&);
 template string convertToString<double>(const double&);
 //template string convertToString<Vec2>(const Vec2&);
@@ -173,7 +207,7 @@ int Vec2::dotProduct(Vec2 a, Vec2 b) {
   return a.x * b.x + a.y * b.y;
 }
 
-vector<Vec2> Vec2::box(int radius, bool shuffle) {
+vector<Vec2> Vec2::box(int radius) {
   if (radius == 0)
     return {*this};
   vector<Vec2> v;
@@ -185,31 +219,43 @@ vector<Vec2> Vec2::box(int radius, bool shuffle) {
     v.push_back(*this + Vec2(-k, radius));
   for (int k = -radius; k < radius; ++k)
     v.push_back(*this + Vec2(-radius, -k));
-  if (shuffle)
-    random_shuffle(v.begin(), v.end(), [](int a) { return Random.getRandom(a);});
   return v;
 }
 
-vector<Vec2> Vec2::directions8(bool shuffle) {
-  return Vec2(0, 0).neighbors8(shuffle);
+vector<Vec2> Vec2::directions8() {
+  return Vec2(0, 0).neighbors8();
 }
 
-vector<Vec2> Vec2::neighbors8(bool shuffle) const {
-  vector<Vec2> res = {Vec2(x, y + 1), Vec2(x + 1, y), Vec2(x, y - 1), Vec2(x - 1, y), Vec2(x + 1, y + 1), Vec2(x + 1, y - 1), Vec2(x - 1, y - 1), Vec2(x - 1, y + 1)};
-  if (shuffle)
-    random_shuffle(res.begin(), res.end(),[](int a) { return Random.getRandom(a);});
-  return res;
+vector<Vec2> Vec2::neighbors8() const {
+  return {Vec2(x, y + 1), Vec2(x + 1, y), Vec2(x, y - 1), Vec2(x - 1, y), Vec2(x + 1, y + 1), Vec2(x + 1, y - 1), Vec2(x - 1, y - 1), Vec2(x - 1, y + 1)};
 }
 
-vector<Vec2> Vec2::directions4(bool shuffle) {
-  return Vec2(0, 0).neighbors4(shuffle);
+vector<Vec2> Vec2::directions4() {
+  return Vec2(0, 0).neighbors4();
 }
 
-vector<Vec2> Vec2::neighbors4(bool shuffle) const {
-  vector<Vec2> res = { Vec2(x, y + 1), Vec2(x + 1, y), Vec2(x, y - 1), Vec2(x - 1, y)};
-  if (shuffle)
-    random_shuffle(res.begin(), res.end(),[](int a) { return Random.getRandom(a);});
-  return res;
+vector<Vec2> Vec2::neighbors4() const {
+  return { Vec2(x, y + 1), Vec2(x + 1, y), Vec2(x, y - 1), Vec2(x - 1, y)};
+}
+
+vector<Vec2> Vec2::box(int radius, RandomGen& random) {
+  return random.permutation(box(radius));
+}
+
+vector<Vec2> Vec2::directions8(RandomGen& random) {
+  return random.permutation(directions8());
+}
+
+vector<Vec2> Vec2::neighbors8(RandomGen& random) const {
+  return random.permutation(neighbors8());
+}
+
+vector<Vec2> Vec2::directions4(RandomGen& random) {
+  return random.permutation(directions4());
+}
+
+vector<Vec2> Vec2::neighbors4(RandomGen& random) const {
+  return random.permutation(neighbors4());
 }
 
 bool Vec2::isCardinal4() const {
@@ -394,8 +440,8 @@ Rectangle::Rectangle(Vec2 p, Vec2 k) : px(p.x), py(p.y), kx(k.x), ky(k.y), w(k.x
 
 Rectangle::Iter::Iter(int x1, int y1, int px1, int py1, int kx1, int ky1) : pos(x1, y1), px(px1), py(py1), kx(kx1), ky(ky1) {}
 
-Vec2 Rectangle::randomVec2() const {
-  return Vec2(Random.getRandom(px, kx), Random.getRandom(py, ky));
+Vec2 Rectangle::randomVec2(RandomGen& random) const {
+  return Vec2(random.getRandom(px, kx), random.getRandom(py, ky));
 }
 
 Vec2 Rectangle::middle() const {
@@ -442,6 +488,14 @@ Vec2 Rectangle::getBottomLeft() const {
   return Vec2(px, ky);
 }
 
+bool Rectangle::operator == (const Rectangle& r) const {
+  return px == r.px && py == r.py && kx == r.kx && ky == r.ky;
+}
+
+bool Rectangle::operator != (const Rectangle& r) const {
+  return !(*this == r);
+}
+
 bool Rectangle::intersects(const Rectangle& other) const {
   return max(px, other.px) < min(kx, other.kx) && max(py, other.py) < min(ky, other.ky);
 }
@@ -480,6 +534,14 @@ Rectangle::Iter Rectangle::end() const {
   return Iter(kx, py, px, py, kx, ky);
 }
 
+BitTable::BitTable(const Rectangle& b, bool value) : bounds(b),
+    bits((b.getW() * b.getH() + 63) / 64, value ? ~uint64_t(0) : 0) {
+}
+
+const Rectangle& BitTable::getBounds() const {
+  return bounds;
+}
+
 Range::Range(int a, int b) : start(a), finish(b) {
   CHECK(a <= b);
 }
@@ -52,6 +52,7 @@ string toLower(const string& s);
 vector<string> split(const string& s, char delim);
 
 class Rectangle;
+class RandomGen;
 
 
 class Vec2 {
@@ -86,11 +87,18 @@ class Vec2 {
   bool isCardinal4() const;
   Dir getCardinalDir() const;
 
-  vector<Vec2> box(int radius, bool shuffle = false);
-  static vector<Vec2> directions8(bool shuffle = false);
-  vector<Vec2> neighbors8(bool shuffle = false) const;
-  static vector<Vec2> directions4(bool shuffle = false);
-  vector<Vec2> neighbors4(bool shuffle = false) const;
+  vector<Vec2> box(int radius);
+  static vector<Vec2> directions8();
+  vector<Vec2> neighbors8() const;
+  static vector<Vec2> directions4();
+  vector<Vec2> neighbors4() const;
+
+  /** Same as above, shuffled with the given stream.*/
+  vector<Vec2> box(int radius, RandomGen&);
+  static vector<Vec2> directions8(RandomGen&);
+  vector<Vec2> neighbors8(RandomGen&) const;
+  static vector<Vec2> directions4(RandomGen&);
+  vector<Vec2> neighbors4(RandomGen&) const;
   static vector<Vec2> corners();
 };
 
@@ -137,12 +145,15 @@ class Rectangle {
   Vec2 getTopRight() const;
   Vec2 getBottomLeft() const;
 
+  bool operator == (const Rectangle&) const;
+  bool operator != (const Rectangle&) const;
+
   bool intersects(const Rectangle& other) const;
   Rectangle intersection(const Rectangle& other) const;
 
   Rectangle minusMargin(int margin) const;
 
-  Vec2 randomVec2() const;
+  Vec2 randomVec2(RandomGen&) const;
   Vec2 middle() const;
   vector<Vec2> getAllSquares();
 
@@ -203,9 +214,37 @@ extern const vector<Vec2> neighbors;
 
 #define GET_ID(uniqueId) (string(__FILE__) + convertToString(__LINE__) + convertToString(uniqueId))
 
+/** Streams derived from the game seed, see RandomGen::getStream.*/
+enum class RandomStream {
+  /** The worlds made in a session, and everything in them that has no stream of its own.*/
+  GAME,
+  /** One stream per creature, keyed by its unique id.*/
+  CREATURE,
+  /** Visual effects only, so that the view can't change the course of the game.*/
+  VIEW,
+  /** The gods, who are made once per session.*/
+  PANTHEON,
+  /** Templates that are made once, on first use, and copied afterwards.*/
+  PROTOTYPE,
+};
+
+/** Counter based generator. The n-th number of a stream is a hash of its key and n, so new streams can be
+    split off any stream in constant time, and two streams with different keys don't depend on each other.*/
 class RandomGen {
   public:
+  RandomGen(uint64_t key = 0);
   void init(int seed);
+
+  /** Returns a stream derived from the key of this one and the id. This stream is not advanced.*/
+  RandomGen split(uint64_t id) const;
+
+  /** Returns a stream derived from the next number of this one.*/
+  RandomGen split();
+
+  /** Sets the seed of all streams returned by getStream.*/
+  static void setGameSeed(int seed);
+  static RandomGen getStream(RandomStream, uint64_t id = 0);
+
   int getRandom(int max);
   int getRandom(int min, int max);
   int getRandom(const string& shuffleId, int min, int max);
@@ -214,20 +253,77 @@ class RandomGen {
   double getDouble(double a, double b);
   bool roll(int chance);
 
+  template <typename T>
+  T choose(const vector<T>& v, const vector<double>& p) {
+    CHECK(v.size() == p.size());
+    return v[getRandom(p)];
+  }
+
+  template <typename T>
+  T choose(const vector<T>& v) {
+    return choose(v, vector<double>(v.size(), 1));
+  }
+
+  template <typename T>
+  T choose(initializer_list<T> vi, initializer_list<double> pi) {
+    return choose(vector<T>(vi), vector<double>(pi));
+  }
+
+  template <typename T>
+  T choose(initializer_list<T> vi) {
+    return choose(vector<T>(vi));
+  }
+
+  template <typename T>
+  T choose(const set<T>& vi) {
+    return choose(vector<T>(vi.begin(), vi.end()));
+  }
+
+  template <typename T>
+  T choose(const vector<pair<T, double>>& vi) {
+    vector<T> v;
+    vector<double> p;
+    for (auto& elem : vi) {
+      v.push_back(elem.first);
+      p.push_back(elem.second);
+    }
+    return choose(v, p);
+  }
+
+  template <typename T>
+  vector<T> permutation(vector<T> v) {
+    random_shuffle(v.begin(), v.end(), [this](int a) { return getRandom(a);});
+    return v;
+  }
+
+  template <typename T>
+  vector<T> permutation(initializer_list<T> vi) {
+    return permutation(vector<T>(vi));
+  }
+
+  template <typename T>
+  vector<T> permutation(const set<T>& vi) {
+    return permutation(vector<T>(vi.begin(), vi.end()));
+  }
+
+  typedef uint64_t result_type;
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return ~result_type(0); }
+  result_type operator()();
+
   private:
   void makeShuffle(string id, int min, int max);
-  default_random_engine generator;
-  std::uniform_real_distribution<double> defaultDist;
+  uint64_t key;
+  uint64_t counter = 0;
   struct ShuffleInfo {
     int minRange;
     int maxRange;
     vector<int> numbers;
   };
   unordered_map<string, ShuffleInfo> shuffleMap;
+  static uint64_t gameKey;
 };
 
-extern RandomGen Random;
-
 inline Debug& operator <<(Debug& d, Rectangle rect) {
   return d << "(" << rect.getPX() << "," << rect.getPY() << ") (" << rect.getKX() << "," << rect.getKY() << ")";
 }
@@ -325,68 +421,37 @@ class Table {
   unique_ptr<T[]> mem;
 };
 
-template <typename T>
-T chooseRandom(const vector<T>& v, const vector<double>& p, double r = -1) {
-  CHECK(v.size() == p.size());
-  return v[Random.getRandom(p, r)];
-}
-
-
-template <typename T>
-T chooseRandom(const vector<T>& v, double r = -1) {
-  vector<double> pi(v.size(), 1);
-  return chooseRandom(v, pi, r);
-}
-
-template <typename T>
-T chooseRandom(const set<T>& vi, double r = -1) {
-  vector<T> v(vi.size());
-  std::copy(vi.begin(), vi.end(), v.begin());
-  return chooseRandom(v, r);
-}
-
-template <typename T>
-T chooseRandom(initializer_list<T> vi, initializer_list<double> pi, double r = -1) {
-  return chooseRandom(vector<T>(vi), vector<double>(pi), r);
-}
+/** A Table of flags packed into bits, for flags that are looked up very often.*/
+class BitTable {
+  public:
+  BitTable(const Rectangle& bounds, bool value = false);
 
-template <typename T>
-T chooseRandom(initializer_list<T> vi, double r = -1) {
-  vector<T> v(vi);
-  vector<double> pi(v.size(), 1);
-  return chooseRandom(v, pi, r);
-}
+  const Rectangle& getBounds() const;
 
-template <typename T>
-T chooseRandom(vector<pair<T, double>> vi, double r = -1) {
-  vector<T> v;
-  vector<double> p;
-  for (auto elem : vi) {
-    v.push_back(elem.first);
-    p.push_back(elem.second);
+  bool operator[](const Vec2& pos) const {
+    int index = getIndex(pos);
+    return (bits[index >> 6] >> (index & 63)) & 1;
   }
-  return chooseRandom(v, p);
-}
 
-template <typename T>
-vector<T> randomPermutation(vector<T> v) {
-  random_shuffle(v.begin(), v.end(), [](int a) { return Random.getRandom(a);});
-  return v;
-}
+  void set(const Vec2& pos, bool value) {
+    int index = getIndex(pos);
+    if (value)
+      bits[index >> 6] |= uint64_t(1) << (index & 63);
+    else
+      bits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+  }
 
-template <typename T>
-vector<T> randomPermutation(const set<T>& vi) {
-  vector<T> v(vi.size());
-  std::copy(vi.begin(), vi.end(), v.begin());
-  return randomPermutation(v);
-}
+  private:
+  int getIndex(const Vec2& pos) const {
+#ifndef RELEASE
+    CHECK(pos.inRectangle(bounds)) << "BitTable index out of bounds " << bounds << " " << pos;
+#endif
+    return (pos.x - bounds.getPX()) * bounds.getH() + pos.y - bounds.getPY();
+  }
 
-template <typename T>
-vector<T> randomPermutation(initializer_list<T> vi) {
-  vector<T> v(vi);
-  random_shuffle(v.begin(), v.end(), [](int a) { return Random.getRandom(a);});
-  return v;
-}
+  Rectangle bounds;
+  vector<uint64_t> bits;
+};
 
 template <typename T, typename V>
 vector<T> getKeys(const map<T, V>& m) {
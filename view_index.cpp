@@ -3,34 +3,62 @@
 #include "view_index.h"
 
 ViewIndex::ViewIndex() {
-  objIndex = vector<int>(allLayers.size(), -1);
 }
+
+ViewIndex::ViewIndex(const ViewIndex& other) {
+  copySlots(other);
+}
+
+ViewIndex& ViewIndex::operator = (const ViewIndex& other) {
+  copySlots(other);
+  return *this;
+}
+
+void ViewIndex::copySlots(const ViewIndex& other) {
+  layerMask = other.layerMask;
+  highlight = other.highlight;
+  highlightType = other.highlightType;
+  highlightAmount = other.highlightAmount;
+  for (int i = 0; i < numLayers; ++i)
+    if (layerMask & (1 << i))
+      new (&slots[i]) ViewObject(other.getSlot(i));
+}
+
+const ViewObject& ViewIndex::getSlot(int layer) const {
+  return *reinterpret_cast<const ViewObject*>(&slots[layer]);
+}
+
+bool ViewIndex::operator == (const ViewIndex& other) const {
+  if (layerMask != other.layerMask || highlight != other.highlight)
+    return false;
+  if (highlight && (highlightType != other.highlightType || highlightAmount != other.highlightAmount))
+    return false;
+  for (int i = 0; i < numLayers; ++i)
+    if ((layerMask & (1 << i)) && !(getSlot(i) == other.getSlot(i)))
+      return false;
+  return true;
+}
+
 void ViewIndex::insert(const ViewObject& obj) {
-  int ind = objIndex[int(obj.layer())];
-  if (ind > -1)
-    objects[ind] = obj;
-  else {
-    objIndex[int(obj.layer())] = objects.size();
-    objects.push_back(obj);
-  }
+  new (&slots[int(obj.layer())]) ViewObject(obj);
+  layerMask |= 1 << int(obj.layer());
 }
 
 bool ViewIndex::hasObject(ViewLayer l) const {
-  return objIndex[int(l)] > -1;
+  return layerMask & (1 << int(l));
 }
 
 void ViewIndex::removeObject(ViewLayer l) {
-  objIndex[int(l)] = -1;
+  layerMask &= ~(1 << int(l));
 }
 
 bool ViewIndex::isEmpty() const {
-  return objects.empty() && !highlight;
+  return !layerMask && !highlight;
 }
 
 ViewObject ViewIndex::getObject(ViewLayer l) const {
-  int ind = objIndex[int(l)];
-  CHECK(ind > -1) << "No object on layer " << int(l);
-  return objects[ind];
+  CHECK(hasObject(l)) << "No object on layer " << int(l);
+  return getSlot(int(l));
 }
 
 Optional<ViewObject> ViewIndex::getTopObject(const vector<ViewLayer>& layers) const {
@@ -41,10 +69,16 @@ Optional<ViewObject> ViewIndex::getTopObject(const vector<ViewLayer>& layers) co
 }
 
 void ViewIndex::setHighlight(HighlightType h, double amount) {
-  highlight = {h, amount};
+  highlight = true;
+  highlightType = h;
+  highlightAmount = amount;
 }
 
-Optional<ViewIndex::HighlightInfo> ViewIndex::getHighlight() const {
+bool ViewIndex::hasHighlight() const {
   return highlight;
 }
 
+ViewIndex::HighlightInfo ViewIndex::getHighlight() const {
+  CHECK(highlight);
+  return {highlightType, highlightAmount};
+}
@@ -6,12 +6,15 @@
 class ViewIndex {
   public:
   ViewIndex();
+  ViewIndex(const ViewIndex&);
+  ViewIndex& operator = (const ViewIndex&);
   void insert(const ViewObject& obj);
   bool hasObject(ViewLayer) const;
   void removeObject(ViewLayer);
   ViewObject getObject(ViewLayer) const;
   Optional<ViewObject> getTopObject(const vector<ViewLayer>&) const;
   bool isEmpty() const;
+  bool operator == (const ViewIndex&) const;
 
   void setHighlight(HighlightType, double amount = 1);
 
@@ -20,12 +23,25 @@ class ViewIndex {
     double amount;
   };
 
-  Optional<HighlightInfo> getHighlight() const;
+  bool hasHighlight() const;
+  HighlightInfo getHighlight() const;
 
   private:
-  vector<int> objIndex;
-  vector<ViewObject> objects;
-  Optional<HighlightInfo> highlight;
+  static const int numLayers = 5;
+  static_assert(int(ViewLayer::FLOOR_BACKGROUND) == numLayers - 1, "Wrong number of view layers");
+  static_assert(std::is_trivially_destructible<ViewObject>::value, "View objects are overwritten in place");
+
+  const ViewObject& getSlot(int layer) const;
+  void copySlots(const ViewIndex&);
+
+  // A slot for every layer, so that indexes are made and copied without allocating. Only the slots of layers
+  // in layerMask hold an object, and only those are copied.
+  typedef std::aligned_storage<sizeof(ViewObject), alignof(ViewObject)>::type Slot;
+  Slot slots[numLayers];
+  uint8_t layerMask = 0;
+  bool highlight = false;
+  HighlightType highlightType = HighlightType::BUILD;
+  float highlightAmount = 0;
 };
 
 #endif
@@ -4,14 +4,39 @@
 
 using namespace std;
 
+const string* ViewObject::intern(const string& s) {
+  // Worlds are generated on several threads.
+  static mutex internMutex;
+  static unordered_set<string> strings;
+  lock_guard<mutex> lock(internMutex);
+  return &*strings.insert(s).first;
+}
+
 ViewObject::ViewObject(ViewId id, ViewLayer l, const string& d, bool _shadow)
-    : resource_id(id), viewLayer(l), description(d), shadow(_shadow) {
-  if (islower(description[0]))
-    description[0] = toupper(description[0]);
+    : resourceId(int(id)), viewLayer(int(l)) {
+  CHECK(int(id) == resourceId);
+  if (islower(d[0])) {
+    string upper = d;
+    upper[0] = toupper(upper[0]);
+    description = intern(upper);
+  } else
+    description = intern(d);
+  setFlag(SHADOW, _shadow);
+}
+
+void ViewObject::setFlag(Flag flag, bool value) {
+  if (value)
+    flags |= flag;
+  else
+    flags &= ~flag;
+}
+
+bool ViewObject::hasFlag(Flag flag) const {
+  return flags & flag;
 }
 
 bool ViewObject::castsShadow() const {
-  return shadow;
+  return hasFlag(SHADOW);
 }
 
 ViewObject& ViewObject::setWaterDepth(double depth) {
@@ -28,59 +53,60 @@ void ViewObject::setBleeding(double b) {
 }
 
 void ViewObject::setHostile(bool s) {
-  hostile = s;
+  setFlag(HOSTILE, s);
+  setFlag(FRIENDLY, !s);
 }
 
 bool ViewObject::isHostile() const {
-  return hostile && *hostile;
+  return hasFlag(HOSTILE);
 }
 
 bool ViewObject::isFriendly() const {
-  return hostile && !(*hostile);
+  return hasFlag(FRIENDLY);
 }
 
 void ViewObject::setBlind(bool s) {
-  blind = s;
+  setFlag(BLIND, s);
 }
 
 void ViewObject::setInvisible(bool s) {
-  invisible = s;
+  setFlag(INVISIBLE, s);
 }
 
 bool ViewObject::isInvisible() const {
-  return invisible;
+  return hasFlag(INVISIBLE);
 }
 
 void ViewObject::setIllusion(bool s) {
-  illusion = s;
+  setFlag(ILLUSION, s);
 }
 
 bool ViewObject::isIllusion() const {
-  return illusion;
+  return hasFlag(ILLUSION);
 }
 
 void ViewObject::setPoisoned(bool s) {
-  poisoned = s;
+  setFlag(POISONED, s);
 }
 
 bool ViewObject::isPoisoned() const {
-  return poisoned;
+  return hasFlag(POISONED);
 }
 
 void ViewObject::setPlayer(bool s) {
-  player = s;
+  setFlag(PLAYER, s);
 }
 
 bool ViewObject::isPlayer() const {
-  return player;
+  return hasFlag(PLAYER);
 }
 
 void ViewObject::setHidden(bool s) {
-  hidden = s;
+  setFlag(HIDDEN, s);
 }
 
 bool ViewObject::isHidden() const {
-  return hidden;
+  return hasFlag(HIDDEN);
 }
 
 void ViewObject::setBurning(double s) {
@@ -112,44 +138,59 @@ double ViewObject::getSizeIncrease() const {
 }
 
 string ViewObject::getBareDescription() const {
-  return description;
+  return *description;
 }
 
 string ViewObject::getDescription(bool stats) const {
   string attr;
-  if (attack && stats)
-    attr = " att: " + convertToString(*attack) + " def: " + convertToString(*defense) + " ";
+  if (hasFlag(HAS_ATTACK) && stats)
+    attr = " att: " + convertToString<int>(attack) + " def: " + convertToString<int>(defense) + " ";
   vector<string> mods;
   if (getBleeding() > 0) 
     mods.push_back("wounded");
-  if (blind)
+  if (hasFlag(BLIND))
     mods.push_back("blind");
-  if (poisoned)
+  if (hasFlag(POISONED))
     mods.push_back("poisoned");
   if (mods.size() > 0)
-    return description + attr + "(" + combine(mods) + ")";
+    return *description + attr + "(" + combine(mods) + ")";
   else
-    return description + attr;
+    return *description + attr;
 }
 
 void ViewObject::setAttack(int val) {
   attack = val;
+  setFlag(HAS_ATTACK, true);
 }
 
 void ViewObject::setDefense(int val) {
   defense = val;
+  setFlag(HAS_DEFENSE, true);
 }
 
 Optional<int> ViewObject::getAttack() const {
-  return attack;
+  if (hasFlag(HAS_ATTACK))
+    return int(attack);
+  else
+    return Nothing();
 }
 
 Optional<int> ViewObject::getDefense() const {
-  return defense;
+  if (hasFlag(HAS_DEFENSE))
+    return int(defense);
+  else
+    return Nothing();
 }
 
 ViewLayer ViewObject::layer() const {
-  return viewLayer;
+  return ViewLayer(viewLayer);
+}
+
+bool ViewObject::operator == (const ViewObject& o) const {
+  // Descriptions are interned, so equal descriptions have equal pointers.
+  return description == o.description && bleeding == o.bleeding && burning == o.burning && height == o.height
+      && sizeIncrease == o.sizeIncrease && waterDepth == o.waterDepth && attack == o.attack
+      && defense == o.defense && flags == o.flags && resourceId == o.resourceId && viewLayer == o.viewLayer;
 }
 
 
@@ -240,18 +281,23 @@ static vector<ViewId> itemIds {
 
 static bool hallu = false;
 
+static RandomGen& halluRandom() {
+  static RandomGen ret = RandomGen::getStream(RandomStream::VIEW, 1);
+  return ret;
+}
+
 void ViewObject::setHallu(bool b) {
   hallu = b;
 }
 
 ViewId ViewObject::id() const {
   if (hallu) {
-    if (contains(creatureIds, resource_id))
-      return creatureIds[Random.getRandom(creatureIds.size())];
-    if (contains(itemIds, resource_id))
-      return itemIds[Random.getRandom(itemIds.size())];
+    if (contains(creatureIds, ViewId(resourceId)))
+      return creatureIds[halluRandom().getRandom(creatureIds.size())];
+    if (contains(itemIds, ViewId(resourceId)))
+      return itemIds[halluRandom().getRandom(itemIds.size())];
   }
-  return resource_id;
+  return ViewId(resourceId);
 }
 
 const ViewObject& ViewObject::unknownMonster() {
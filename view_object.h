@@ -61,6 +61,7 @@ class ViewObject {
   string getBareDescription() const;
 
   ViewLayer layer() const;
+  bool operator == (const ViewObject&) const;
   ViewId id() const;
 
   const static ViewObject& unknownMonster();
@@ -68,25 +69,38 @@ class ViewObject {
   const static ViewObject& mana();
 
   private:
-  double bleeding = 0;
-  Optional<bool> hostile;
-  bool friendly = false;
-  bool blind = false;
-  bool invisible = false;
-  bool illusion = false;
-  bool poisoned = false;
-  bool player = false;
-  ViewId resource_id;
-  ViewLayer viewLayer;
-  string description;
-  bool hidden = false;
-  double burning = false;
-  double height = 0;
-  double sizeIncrease = 0;
-  bool shadow;
-  Optional<int> attack;
-  Optional<int> defense;
-  double waterDepth = -1;
+  enum Flag : uint16_t {
+    HOSTILE = 1 << 0,
+    // Set when the object is known not to be hostile.
+    FRIENDLY = 1 << 1,
+    BLIND = 1 << 2,
+    INVISIBLE = 1 << 3,
+    ILLUSION = 1 << 4,
+    POISONED = 1 << 5,
+    PLAYER = 1 << 6,
+    HIDDEN = 1 << 7,
+    SHADOW = 1 << 8,
+    HAS_ATTACK = 1 << 9,
+    HAS_DEFENSE = 1 << 10,
+  };
+  void setFlag(Flag, bool);
+  bool hasFlag(Flag) const;
+
+  /** Returns the only copy of the string, so that objects carry just a pointer to their description.*/
+  static const string* intern(const string&);
+
+  // Kept small and free of heap data, view objects are copied into every ViewIndex and remembered square.
+  const string* description;
+  float bleeding = 0;
+  float burning = 0;
+  float height = 0;
+  float sizeIncrease = 0;
+  float waterDepth = -1;
+  int16_t attack = 0;
+  int16_t defense = 0;
+  uint16_t flags = 0;
+  uint16_t resourceId;
+  uint8_t viewLayer;
 };
 
 
@@ -75,12 +75,12 @@ class HumanVillageControl : public VillageControl {
     if (pathToDungeon.empty() && c->getLevel() != villain->getLevel())
       pathToDungeon = genPathToDungeon();
     if (c->getLevel() == villain->getLevel()) {
-      if (Optional<Vec2> move = c->getMoveTowards(villain->getHeartPos())) 
+      if (Optional<Vec2> move = c->getSharedMoveTowards(villain->getHeartPos())) 
         return {1.0, [this, move, c] () {
           c->move(*move);
         }};
       else {
-        for (Vec2 v : Vec2::directions8(true))
+        for (Vec2 v : Vec2::directions8(c->getRandom()))
           if (c->canDestroy(v) && c->getSquare(v)->getName() == "door")
             return {1.0, [this, v, c] () {
               c->destroy(v);
@@ -173,12 +173,12 @@ class DwarfVillageControl : public VillageControl {
   virtual MoveInfo getMove(Creature* c) override {
     CHECK(startedAttack(c));
     if (c->getLevel() == villain->getLevel()) {
-      if (Optional<Vec2> move = c->getMoveTowards(villain->getHeartPos())) 
+      if (Optional<Vec2> move = c->getSharedMoveTowards(villain->getHeartPos())) 
         return {1.0, [this, move, c] () {
           c->move(*move);
         }};
       else {
-        for (Vec2 v : Vec2::directions8(true))
+        for (Vec2 v : Vec2::directions8(c->getRandom()))
           if (c->canDestroy(v))
             return {1.0, [this, v, c] () {
               c->destroy(v);
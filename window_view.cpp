@@ -27,6 +27,12 @@ using sf::Mouse;
 
 using namespace std;
 
+/** Used for visual effects, so that what is displayed doesn't change the course of the game.*/
+static RandomGen& viewRandom() {
+  static RandomGen ret = RandomGen::getStream(RandomStream::VIEW);
+  return ret;
+}
+
 Color white(255, 255, 255);
 Color yellow(250, 255, 0);
 Color lightBrown(210, 150, 0);
@@ -629,7 +635,6 @@ Font tileFont;
 Font symbolFont;
 
 Rectangle maxLevelBounds(600, 600);
-Image mapBuffer;
 vector<Texture> tiles;
 vector<int> tileSize { 36, 36, 36, 24, 36, 36 };
 int nominalSize = 36;
@@ -743,6 +748,67 @@ static void drawSprite(int x, int y, int px, int py, int w, int h, const Texture
   display->draw(s);
 }
 
+/** Collects the quads of the map over a frame, so that it takes a few draw calls instead of several per square.
+  They are drawn ordered by pass, and within a pass by texture, with untextured rectangles first.*/
+class MapBatches {
+  public:
+  void addSprite(int pass, int texNum, const Rectangle& dest, const Rectangle& source, Color color = white) {
+    addQuad(pass, texNum, dest, source, color);
+  }
+
+  void addRectangle(int pass, const Rectangle& r, Color color, Optional<Color> outline = Nothing()) {
+    if (color != Color::Transparent)
+      addQuad(pass, -1, r, r, color);
+    if (outline) {
+      const int t = 2;
+      addQuad(pass, -1, Rectangle(r.getPX(), r.getPY(), r.getKX(), r.getPY() + t), r, *outline);
+      addQuad(pass, -1, Rectangle(r.getPX(), r.getKY() - t, r.getKX(), r.getKY()), r, *outline);
+      addQuad(pass, -1, Rectangle(r.getPX(), r.getPY() + t, r.getPX() + t, r.getKY() - t), r, *outline);
+      addQuad(pass, -1, Rectangle(r.getKX() - t, r.getPY() + t, r.getKX(), r.getKY() - t), r, *outline);
+    }
+  }
+
+  void draw() {
+    for (auto& elem : batches)
+      if (elem.second.getVertexCount() > 0) {
+        sf::RenderStates states;
+        if (elem.first.second >= 0)
+          states.texture = &tiles[elem.first.second];
+        display->draw(elem.second, states);
+        // Keeps the storage for the next frame.
+        elem.second.clear();
+      }
+  }
+
+  private:
+  void addQuad(int pass, int texNum, const Rectangle& dest, const Rectangle& source, Color color) {
+    auto key = make_pair(pass, texNum);
+    if (!batches.count(key))
+      batches.insert(make_pair(key, sf::VertexArray(sf::Quads)));
+    sf::VertexArray& batch = batches.at(key);
+    batch.append(sf::Vertex(Vector2f(dest.getPX(), dest.getPY()), color, Vector2f(source.getPX(), source.getPY())));
+    batch.append(sf::Vertex(Vector2f(dest.getKX(), dest.getPY()), color, Vector2f(source.getKX(), source.getPY())));
+    batch.append(sf::Vertex(Vector2f(dest.getKX(), dest.getKY()), color, Vector2f(source.getKX(), source.getKY())));
+    batch.append(sf::Vertex(Vector2f(dest.getPX(), dest.getKY()), color, Vector2f(source.getPX(), source.getKY())));
+  }
+
+  map<pair<int, int>, sf::VertexArray> batches;
+};
+
+MapBatches mapBatches;
+
+const int backgroundPass = 0;
+const int highlightPass = 1000;
+
+/** Objects are drawn layer by layer over the whole map. In the pass of a layer the creature shadow and
+  the player outline go under the object, and the wall shadow and fire over it.*/
+enum class ObjectPass { UNDER, OBJECT, SHADOW, FIRE };
+
+static int getObjectPass(ViewLayer layer, ObjectPass pass) {
+  int layerNum = find(allLayers.begin(), allLayers.end(), layer) - allLayers.begin();
+  return 1 + layerNum * 4 + int(pass);
+}
+
 int topBarHeight = 10;
 int rightBarWidth = 300;
 int rightBarText = rightBarWidth - 30;
@@ -754,6 +820,28 @@ Rectangle WindowView::getMapViewBounds() const {
 
 const MapMemory* lastMemory = nullptr;
 
+/** The minimap of a level, kept between openings of the map and refreshed only where the level or the memory
+    changed since.*/
+struct LevelMap {
+  LevelMap(Rectangle bounds) : shown(bounds), roads(bounds) {
+    image.create(bounds.getKX(), bounds.getKY(), black);
+  }
+
+  Image image;
+  Texture texture;
+  BitTable shown;
+  BitTable roads;
+  vector<Vec2> roadList;
+  vector<pair<Vec2, string>> labels;
+  const MapMemory* memory = nullptr;
+  const CreatureView* creatureView = nullptr;
+  int levelChanges = 0;
+  int memoryChanges = 0;
+  bool loaded = false;
+};
+
+map<const Level*, unique_ptr<LevelMap>> levelMaps;
+
 void WindowView::initialize() {
   if (!display) {
     display = new RenderWindow(VideoMode(1024, 600, 32), "KeeperRL");
@@ -807,8 +895,9 @@ void WindowView::initialize() {
     //  tex.setSmooth(true);
   } else {
     lastMemory = nullptr;
+    // Levels of a new game can be allocated where the old ones were.
+    levelMaps.clear();
   }
-  mapBuffer.create(maxLevelBounds.getW(), maxLevelBounds.getH());
   mapLayout = currentTileLayout.normalLayout;
   center = {0, 0};
 }
@@ -832,7 +921,7 @@ void displayMenuSplash() {
   drawImage(100, screenHeight - bottomMargin, splash);
   vector<Rectangle> drawn;
   if (splashPositions.empty())
-    random_shuffle(++splashPaths.begin(), splashPaths.end(), [](int a) { return Random.getRandom(a);});
+    random_shuffle(++splashPaths.begin(), splashPaths.end(), [](int a) { return viewRandom().getRandom(a);});
   for (int path : All(splashPaths)) {
     CHECK(splash.loadFromFile(splashPaths[path]));
     int cnt = 100;
@@ -842,8 +931,8 @@ void displayMenuSplash() {
         px = splashPositions[path].x;
         py = splashPositions[path].y;
       } else {
-        px = Random.getRandom(screenWidth - splash.getSize().x);
-        py = Random.getRandom(screenHeight - bottomMargin - splash.getSize().y);
+        px = viewRandom().getRandom(screenWidth - splash.getSize().x);
+        py = viewRandom().getRandom(screenHeight - bottomMargin - splash.getSize().y);
         splashPositions.push_back({px, py});
       }
       Rectangle pos(px, py, px + splash.getSize().x, py + splash.getSize().y);
@@ -870,7 +959,7 @@ void displayMenuSplash() {
 
 void WindowView::displaySplash(bool& ready) {
   Image splash;
-  CHECK(splash.loadFromFile(splashPaths[Random.getRandom(1, splashPaths.size())]));
+  CHECK(splash.loadFromFile(splashPaths[viewRandom().getRandom(1, splashPaths.size())]));
   while (!ready) {
     drawImage((screenWidth - splash.getSize().x) / 2, (screenHeight - splash.getSize().y) / 2, splash);
     drawText(white, screenWidth / 2, screenHeight - 60, "Creating a new world, just for you...", true);
@@ -1034,7 +1123,8 @@ static Color transparency(const Color& color, int trans) {
 int fireVar = 50;
 
 Color getFireColor() {
-  return Color(200 + Random.getRandom(-fireVar, fireVar), Random.getRandom(fireVar), Random.getRandom(fireVar), 150);
+  return Color(200 + viewRandom().getRandom(-fireVar, fireVar), viewRandom().getRandom(fireVar),
+      viewRandom().getRandom(fireVar), 150);
 }
 
 void printStanding(int x, int y, double standing, const string& tribeName) {
@@ -1398,7 +1488,12 @@ Color getHighlightColor(ViewIndex::HighlightInfo info) {
 Table<Optional<ViewIndex>> objects(maxLevelBounds.getW(), maxLevelBounds.getH());
 Rectangle levelBounds(1, 1);
 map<Vec2, ViewObject> borderCreatures;
-set<Vec2> shadowed;
+// Squares whose floor casts a shadow on the square below.
+set<Vec2> shadowCasters;
+
+bool isShadowed(Vec2 pos) {
+  return shadowCasters.count(pos - Vec2(0, 1)) && !shadowCasters.count(pos);
+}
 
 enum class ConnectionId {
   ROAD,
@@ -1449,7 +1544,8 @@ Optional<ViewObject> WindowView::drawObjectAbs(int x, int y, const ViewIndex& in
       objects.push_back(*object);
   for (ViewObject& object : objects) {
     if (object.isPlayer()) {
-      drawFilledRectangle(x, y, x + sizeX, y + sizeY, Color::Transparent, lightGray);
+      mapBatches.addRectangle(getObjectPass(object.layer(), ObjectPass::UNDER), Rectangle(x, y, x + sizeX, y + sizeY),
+          Color::Transparent, lightGray);
     }
     Tile tile = getTile(object, currentTileLayout.sprites);
     Color color = getBleedingColor(object);
@@ -1477,18 +1573,23 @@ Optional<ViewObject> WindowView::drawObjectAbs(int x, int y, const ViewIndex& in
           dirs.insert(dir.getCardinalDir());
       Vec2 coord = tile.getSpriteCoord(dirs);
 
+      Rectangle dest(x, y, x + width, y + height);
       if (object.layer() == ViewLayer::CREATURE) {
-        drawSprite(x, y, 2 * nominalSize, 22 * nominalSize, nominalSize, nominalSize, tiles[0], width, height);
+        mapBatches.addSprite(getObjectPass(object.layer(), ObjectPass::UNDER), 0, dest,
+            Rectangle(2 * nominalSize, 22 * nominalSize, 3 * nominalSize, 23 * nominalSize));
         moveY = -4 - object.getSizeIncrease() / 2;
       }
-      drawSprite(x + off, y + moveY + off, coord.x * sz,
-          coord.y * sz, sz, sz, tiles[tile.getTexNum()], width, height, color);
+      mapBatches.addSprite(getObjectPass(object.layer(), ObjectPass::OBJECT), tile.getTexNum(),
+          Rectangle(x + off, y + moveY + off, x + off + width, y + moveY + off + height),
+          Rectangle(coord.x * sz, coord.y * sz, (coord.x + 1) * sz, (coord.y + 1) * sz), color);
       if (contains({ViewLayer::FLOOR, ViewLayer::FLOOR_BACKGROUND}, object.layer()) && 
-          shadowed.count(tilePos) && !tile.stickingOut)
-        drawSprite(x, y, 1 * nominalSize, 21 * nominalSize, nominalSize, nominalSize, tiles[5], width, height);
+          isShadowed(tilePos) && !tile.stickingOut)
+        mapBatches.addSprite(getObjectPass(object.layer(), ObjectPass::SHADOW), 5, dest,
+            Rectangle(1 * nominalSize, 21 * nominalSize, 2 * nominalSize, 22 * nominalSize));
       if (object.getBurning() > 0) {
-        drawSprite(x, y, Random.getRandom(10, 12) * nominalSize, 0 * nominalSize,
-            nominalSize, nominalSize, tiles[2], width, height);
+        int fireX = viewRandom().getRandom(10, 12);
+        mapBatches.addSprite(getObjectPass(object.layer(), ObjectPass::FIRE), 2, dest,
+            Rectangle(fireX * nominalSize, 0 * nominalSize, (fireX + 1) * nominalSize, 1 * nominalSize));
       }
     } else {
       drawText(tile.symFont ? symbolFont : tileFont, sizeY + object.getSizeIncrease(), getColor(object),
@@ -1503,10 +1604,11 @@ Optional<ViewObject> WindowView::drawObjectAbs(int x, int y, const ViewIndex& in
     }
   }
   if (getHighlightedTile() == tilePos) {
-    drawFilledRectangle(x, y, x + sizeX, y + sizeY, Color::Transparent, lightGray);
+    mapBatches.addRectangle(highlightPass, Rectangle(x, y, x + sizeX, y + sizeY), Color::Transparent, lightGray);
   }
-  if (auto highlight = index.getHighlight())
-    drawFilledRectangle(x, y, x + sizeX, y + sizeY, getHighlightColor(*highlight));
+  if (index.hasHighlight())
+    mapBatches.addRectangle(highlightPass, Rectangle(x, y, x + sizeX, y + sizeY),
+        getHighlightColor(index.getHighlight()));
   if (!objects.empty())
     return objects.back();
   else
@@ -1526,13 +1628,49 @@ void WindowView::refreshView(const CreatureView* collective) {
   refreshViewInt(collective);
 }
 
+// What the objects were last refreshed from. Until any of it changes, only the squares that the level or memory
+// marked as changed since, squares with creatures or overlays, and squares touched by animations are refreshed.
+const CreatureView* lastCreatureView = nullptr;
+const Level* lastLevel = nullptr;
+Rectangle lastTiles(1, 1);
+int lastLevelChanges = 0;
+int lastMemoryChanges = 0;
+vector<Vec2> lastOverlay;
+set<Vec2> animatedTiles;
+
+void refreshTile(const CreatureView* collective, Vec2 pos) {
+  objects[pos] = Nothing();
+  shadowCasters.erase(pos);
+  floorIds.erase(pos);
+  const Level* level = collective->getLevel();
+  if (!level->inBounds(pos))
+    return;
+  ViewIndex index = collective->getViewIndex(pos);
+  if (!index.hasObject(ViewLayer::FLOOR) && !index.hasObject(ViewLayer::FLOOR_BACKGROUND) &&
+      !index.isEmpty() && lastMemory->hasViewIndex(pos)) {
+    // special case when monster or item is visible but floor is only in memory
+    if (lastMemory->getViewIndex(pos).hasObject(ViewLayer::FLOOR))
+      index.insert(lastMemory->getViewIndex(pos).getObject(ViewLayer::FLOOR));
+    if (lastMemory->getViewIndex(pos).hasObject(ViewLayer::FLOOR_BACKGROUND))
+      index.insert(lastMemory->getViewIndex(pos).getObject(ViewLayer::FLOOR_BACKGROUND));
+  }
+  if (index.isEmpty() && lastMemory->hasViewIndex(pos))
+    index = lastMemory->getViewIndex(pos);
+  objects[pos] = index;
+  if (index.hasObject(ViewLayer::FLOOR)) {
+    ViewObject object = index.getObject(ViewLayer::FLOOR);
+    if (object.castsShadow())
+      shadowCasters.insert(pos);
+    if (auto id = getConnectionId(object.id()))
+      floorIds.insert(make_pair(pos, *id));
+  }
+}
+
 void WindowView::refreshViewInt(const CreatureView* collective, bool flipBuffer) {
   switchTiles();
   const Level* level = collective->getLevel();
   levelBounds = level->getBounds();
   collective->refreshGameInfo(gameInfo);
-  for (Vec2 pos : mapLayout->getAllTiles(maxLevelBounds))
-    objects[pos] = Nothing();
   if ((center.x == 0 && center.y == 0) || collective->staticPosition())
     center = {double(collective->getPosition().x), double(collective->getPosition().y)};
   Vec2 movePos = Vec2((center.x - mouseOffset.x) * mapLayout->squareWidth(),
@@ -1542,33 +1680,41 @@ void WindowView::refreshViewInt(const CreatureView* collective, bool flipBuffer)
   movePos.y = max(movePos.y, 0);
   movePos.y = min(movePos.y, int(collective->getLevel()->getBounds().getKY() * mapLayout->squareHeight()));
   mapLayout->updatePlayerPos(movePos);
-  shadowed.clear();
-  floorIds.clear();
-  lastMemory = &collective->getMemory(level);
-  for (Vec2 pos : mapLayout->getAllTiles(maxLevelBounds)) 
-    if (level->inBounds(pos)) {
-      ViewIndex index = collective->getViewIndex(pos);
-      if (!index.hasObject(ViewLayer::FLOOR) && !index.hasObject(ViewLayer::FLOOR_BACKGROUND) &&
-          !index.isEmpty() && lastMemory->hasViewIndex(pos)) {
-        // special case when monster or item is visible but floor is only in memory
-        if (lastMemory->getViewIndex(pos).hasObject(ViewLayer::FLOOR))
-          index.insert(lastMemory->getViewIndex(pos).getObject(ViewLayer::FLOOR));
-        if (lastMemory->getViewIndex(pos).hasObject(ViewLayer::FLOOR_BACKGROUND))
-          index.insert(lastMemory->getViewIndex(pos).getObject(ViewLayer::FLOOR_BACKGROUND));
-      }
-      if (index.isEmpty() && lastMemory->hasViewIndex(pos))
-        index = lastMemory->getViewIndex(pos);
-      objects[pos] = index;
-      if (index.hasObject(ViewLayer::FLOOR)) {
-        ViewObject object = index.getObject(ViewLayer::FLOOR);
-        if (object.castsShadow()) {
-          shadowed.erase(pos);
-          shadowed.insert(pos + Vec2(0, 1));
-        }
-        if (auto id = getConnectionId(object.id()))
-          floorIds.insert(make_pair(pos, *id));
-      }
-    }
+  const MapMemory* memory = &collective->getMemory(level);
+  Rectangle allTiles = mapLayout->getAllTiles(maxLevelBounds);
+  Optional<vector<Vec2>> overlay = collective->getOverlaySquares();
+  bool refreshAll = !overlay || collective != lastCreatureView || level != lastLevel || memory != lastMemory
+      || allTiles != lastTiles || level->getNumChanges() < lastLevelChanges
+      || memory->getNumChanges() < lastMemoryChanges;
+  lastMemory = memory;
+  if (refreshAll) {
+    shadowCasters.clear();
+    floorIds.clear();
+    for (Vec2 pos : allTiles)
+      refreshTile(collective, pos);
+  } else {
+    for (Vec2 pos : allTiles)
+      if (level->inBounds(pos) && (level->getLastChange(pos) > lastLevelChanges ||
+          memory->getLastChange(pos) > lastMemoryChanges))
+        refreshTile(collective, pos);
+    // Creatures can look different without moving, and overlays don't tell when they change.
+    vector<Vec2> refresh = concat(lastOverlay, *overlay);
+    for (const Creature* c : level->getAllCreatures())
+      refresh.push_back(c->getPosition());
+    for (Vec2 pos : animatedTiles)
+      refresh.push_back(pos);
+    for (Vec2 pos : refresh)
+      if (pos.inRectangle(allTiles))
+        refreshTile(collective, pos);
+  }
+  animatedTiles.clear();
+  lastCreatureView = collective;
+  lastLevel = level;
+  lastTiles = allTiles;
+  lastLevelChanges = level->getNumChanges();
+  lastMemoryChanges = memory->getNumChanges();
+  if (overlay)
+    lastOverlay = *overlay;
   borderCreatures.clear();
  /* for (const Creature* c : collective->getVisibleCreatures())
     if (!c->getPosition().inRectangle(mapLayout->getAllTiles(maxLevelBounds)))
@@ -1580,6 +1726,7 @@ void WindowView::animateObject(vector<Vec2> trajectory, ViewObject object) {
   for (Vec2 pos : trajectory) {
     if (!objects[pos])
       continue;
+    animatedTiles.insert(pos);
     ViewIndex& index = *objects[pos];
     Optional<ViewObject> prev;
     if (index.hasObject(object.layer()))
@@ -1630,47 +1777,90 @@ void WindowView::animation(Vec2 pos, AnimationId id) {
 
 }*/
 
-void WindowView::drawLevelMap(const Level* level, const CreatureView* creature) {
-  TempClockPause pause;
-  vector<Vec2> roads;
-  while (1) {
-    for (Vec2 v : maxLevelBounds) {
-      if (!v.inRectangle(level->getBounds()) || (!creature->getMemory(level).hasViewIndex(v) && !creature->canSee(v)))
-        mapBuffer.setPixel(v.x, v.y, black);
-      else {
-        mapBuffer.setPixel(v.x, v.y, getColor(level->getSquare(v)->getViewObject()));
-        if (level->getSquare(v)->getName() == "road")
-          roads.push_back(v);
-      }
-    }
-    Rectangle bounds = getMapViewBounds();
-    double scale = min(double(bounds.getW()) / level->getBounds().getW(),
-        double(bounds.getH()) / level->getBounds().getH());
-    drawImage(bounds.getPX(), bounds.getPY(), mapBuffer, scale);
-    for (Vec2 v : roads) {
-      Vec2 rrad(2, 2);
-      Vec2 pos = bounds.getTopLeft() + v * scale;
-      drawFilledRectangle(Rectangle(pos - rrad, pos + rrad), brown);
+static LevelMap& getLevelMap(const Level* level, const CreatureView* creature) {
+  const MapMemory* memory = &creature->getMemory(level);
+  unique_ptr<LevelMap>& levelMap = levelMaps[level];
+  if (!levelMap || levelMap->memory != memory || levelMap->creatureView != creature
+      || level->getNumChanges() < levelMap->levelChanges || memory->getNumChanges() < levelMap->memoryChanges)
+    levelMap.reset(new LevelMap(level->getBounds()));
+  // Visibility isn't tracked by the change counters, so every square is checked, but only the changed ones
+  // are redrawn.
+  bool changed = !levelMap->loaded;
+  bool roadsChanged = false;
+  for (Vec2 v : level->getBounds()) {
+    bool visible = memory->hasViewIndex(v) || creature->canSee(v);
+    if (visible == levelMap->shown[v] && (!visible || level->getLastChange(v) <= levelMap->levelChanges))
+      continue;
+    changed = true;
+    levelMap->shown.set(v, visible);
+    bool road = visible && level->getSquare(v)->getName() == "road";
+    if (road != levelMap->roads[v]) {
+      levelMap->roads.set(v, road);
+      roadsChanged = true;
     }
-    Vec2 playerPos = bounds.getTopLeft() + creature->getPosition() * scale;
-    Vec2 rad(4, 4);
-    drawFilledRectangle(Rectangle(playerPos - rad, playerPos + rad), red);
+    levelMap->image.setPixel(v.x, v.y, visible ? getColor(level->getSquare(v)->getViewObject()) : black);
+  }
+  if (roadsChanged) {
+    levelMap->roadList.clear();
+    for (Vec2 v : level->getBounds())
+      if (levelMap->roads[v])
+        levelMap->roadList.push_back(v);
+  }
+  if (changed) {
+    levelMap->texture.loadFromImage(levelMap->image);
+    levelMap->labels.clear();
     for (const Location* loc : level->getAllLocations())
       if (loc->hasName())
         for (Vec2 v : loc->getBounds())
-          if (creature->getMemory(level).hasViewIndex(v) || creature->canSee(v)) {
-            string text = loc->getName();
-            Vec2 pos = bounds.getTopLeft() + loc->getBounds().getBottomRight() * scale;
-            drawFilledRectangle(pos.x, pos.y, pos.x + getTextLength(text) + 10, pos.y + 25,
-                transparency(black, 130));
-            drawText(white, pos.x + 5, pos.y, text);
+          if (levelMap->shown[v]) {
+            levelMap->labels.push_back(make_pair(loc->getBounds().getBottomRight(), loc->getName()));
             break;
           }
+  }
+  levelMap->memory = memory;
+  levelMap->creatureView = creature;
+  levelMap->levelChanges = level->getNumChanges();
+  levelMap->memoryChanges = memory->getNumChanges();
+  levelMap->loaded = true;
+  return *levelMap;
+}
 
-    drawAndClearBuffer();
+void WindowView::drawLevelMap(const Level* level, const CreatureView* creature) {
+  TempClockPause pause;
+  const LevelMap& levelMap = getLevelMap(level, creature);
+  Rectangle levelBounds = level->getBounds();
+  bool redraw = true;
+  while (1) {
+    if (redraw) {
+      Rectangle bounds = getMapViewBounds();
+      double scale = min(double(bounds.getW()) / levelBounds.getW(),
+          double(bounds.getH()) / levelBounds.getH());
+      Sprite s(levelMap.texture);
+      s.setPosition(bounds.getPX(), bounds.getPY());
+      s.setScale(scale, scale);
+      display->draw(s);
+      for (Vec2 v : levelMap.roadList) {
+        Vec2 rrad(2, 2);
+        Vec2 pos = bounds.getTopLeft() + v * scale;
+        mapBatches.addRectangle(backgroundPass, Rectangle(pos - rrad, pos + rrad), brown);
+      }
+      mapBatches.draw();
+      Vec2 playerPos = bounds.getTopLeft() + creature->getPosition() * scale;
+      Vec2 rad(4, 4);
+      drawFilledRectangle(Rectangle(playerPos - rad, playerPos + rad), red);
+      for (auto& label : levelMap.labels) {
+        Vec2 pos = bounds.getTopLeft() + label.first * scale;
+        drawFilledRectangle(pos.x, pos.y, pos.x + getTextLength(label.second) + 10, pos.y + 25,
+            transparency(black, 130));
+        drawText(white, pos.x + 5, pos.y, label.second);
+      }
+      drawAndClearBuffer();
+    }
     BlockingEvent ev = readkey();
     if (contains({BlockingEvent::KEY, BlockingEvent::MOUSE_LEFT}, ev.type))
       break;
+    // The map doesn't follow the mouse, so there's nothing new to draw.
+    redraw = ev.type != BlockingEvent::MOUSE_MOVE;
   }
 }
 
@@ -1683,18 +1873,24 @@ void WindowView::drawMap() {
   int sizeX = mapLayout->squareWidth();
   int sizeY = mapLayout->squareHeight();
   Rectangle mapWindow = mapLayout->getBounds();
+  Rectangle allTiles = mapLayout->getAllTiles(maxLevelBounds);
   drawFilledRectangle(mapWindow, almostBlack);
+  for (Vec2 wpos : allTiles)
+    if (wpos.inRectangle(levelBounds) &&
+        (!currentTileLayout.sprites || !objects[wpos] || objects[wpos]->isEmpty())) {
+      Vec2 pos = mapLayout->projectOnScreen(wpos);
+      mapBatches.addRectangle(backgroundPass, Rectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY), black);
+    }
+  // Text tiles are drawn right away, so the backgrounds have to be drawn before them.
+  mapBatches.draw();
   map<string, ViewObject> objIndex;
   Optional<ViewObject> highlighted;
-  for (Vec2 wpos : mapLayout->getAllTiles(maxLevelBounds)) {
+  for (Vec2 wpos : allTiles) {
     Vec2 pos = mapLayout->projectOnScreen(wpos);
-    if (!currentTileLayout.sprites && wpos.inRectangle(levelBounds))
-      drawFilledRectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY, black);
     if (!objects[wpos] || objects[wpos]->isEmpty()) {
-      if (wpos.inRectangle(levelBounds))
-        drawFilledRectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY, black);
       if (getHighlightedTile() == wpos) {
-        drawFilledRectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY, Color::Transparent, lightGray);
+        mapBatches.addRectangle(highlightPass, Rectangle(pos.x, pos.y, pos.x + sizeX, pos.y + sizeY),
+            Color::Transparent, lightGray);
       }
       continue;
     }
@@ -1715,6 +1911,7 @@ void WindowView::drawMap() {
           proj.y,
           index, sizeX / 2, sizeY / 2, elem.first);
     }
+  mapBatches.draw();
   int rightPos = screenWidth -rightBarText;
   drawFilledRectangle(screenWidth - rightBarWidth, 0, screenWidth, screenHeight, translucentBlack);
   if (gameInfo.infoType == GameInfo::InfoType::PLAYER) {